@@ -57,10 +57,13 @@ void AStar3D::add_point(int64_t p_id, const Vector3 &p_pos, real_t p_weight_scal
 		pt->id = p_id;
 		pt->pos = p_pos;
 		pt->weight_scale = p_weight_scale;
-		pt->prev_point = nullptr;
-		pt->open_pass = 0;
-		pt->closed_pass = 0;
 		pt->enabled = true;
+		if (free_point_indices.is_empty()) {
+			pt->index = point_index_count++;
+		} else {
+			pt->index = free_point_indices[free_point_indices.size() - 1];
+			free_point_indices.remove_at(free_point_indices.size() - 1);
+		}
 		points.set(p_id, pt);
 	} else {
 		found_pt->pos = p_pos;
@@ -122,6 +125,7 @@ void AStar3D::remove_point(int64_t p_id) {
 		(*it.value)->unlinked_neighbours.remove(p->id);
 	}
 
+	free_point_indices.push_back(p->index);
 	memdelete(p);
 	points.remove(p_id);
 	last_free_id = p_id;
@@ -248,6 +252,8 @@ void AStar3D::clear() {
 	}
 	segments.clear();
 	points.clear();
+	point_index_count = 0;
+	free_point_indices.clear();
 }
 
 int64_t AStar3D::get_point_count() const {
@@ -318,8 +324,8 @@ Vector3 AStar3D::get_closest_position_in_segment(const Vector3 &p_point) const {
 	return closest_point;
 }
 
-bool AStar3D::_solve(Point *begin_point, Point *end_point) {
-	pass++;
+bool AStar3D::_solve(SearchContext &r_context, Point *begin_point, Point *end_point) {
+	r_context.pass++;
 
 	if (!end_point->enabled) {
 		return false;
@@ -327,52 +333,52 @@ bool AStar3D::_solve(Point *begin_point, Point *end_point) {
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	r_context.open_list.clear();
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	SearchNode &begin_node = r_context.nodes[begin_point->index];
+	begin_node.g_score = 0;
+	begin_node.f_score = _estimate_cost(begin_point->id, end_point->id);
+	r_context.heap_push(begin_point);
 
-	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+	while (!r_context.open_list.is_empty()) {
+		Point *p = r_context.open_list[0]; // The currently processed point.
 
 		if (p == end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		r_context.heap_pop(); // Remove the current point from the open list.
+		SearchNode &node = r_context.nodes[p->index];
+		node.closed_pass = r_context.pass; // Mark the point as closed.
 
 		for (OAHashMap<int64_t, Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
 			Point *e = *(it.value); // The neighbor point.
+			SearchNode &e_node = r_context.nodes[e->index];
 
-			if (!e->enabled || e->closed_pass == pass) {
+			if (!e->enabled || e_node.closed_pass == r_context.pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = node.g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (e_node.open_pass != r_context.pass) { // The point wasn't inside the open list.
+				e_node.open_pass = r_context.pass;
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
+			e_node.prev_point = p;
+			e_node.g_score = tentative_g_score;
+			e_node.f_score = e_node.g_score + _estimate_cost(e->id, end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+			if (new_point) {
+				r_context.heap_push(e);
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				r_context.heap_sift_up(e_node.heap_index);
 			}
 		}
 	}
@@ -432,8 +438,10 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id) {
 	Point *begin_point = a;
 	Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	SearchContext *context = _acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
+		_release_search_context(context);
 		return Vector<Vector3>();
 	}
 
@@ -441,7 +449,7 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id) {
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->nodes[p->index].prev_point;
 	}
 
 	Vector<Vector3> path;
@@ -454,12 +462,14 @@ Vector<Vector3> AStar3D::get_point_path(int64_t p_from_id, int64_t p_to_id) {
 		int64_t idx = pc - 1;
 		while (p2 != begin_point) {
 			w[idx--] = p2->pos;
-			p2 = p2->prev_point;
+			p2 = context->nodes[p2->index].prev_point;
 		}
 
 		w[0] = p2->pos; // Assign first
 	}
 
+	_release_search_context(context);
+
 	return path;
 }
 
@@ -481,8 +491,10 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id) {
 	Point *begin_point = a;
 	Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	SearchContext *context = _acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
+		_release_search_context(context);
 		return Vector<int64_t>();
 	}
 
@@ -490,7 +502,7 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id) {
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->nodes[p->index].prev_point;
 	}
 
 	Vector<int64_t> path;
@@ -503,12 +515,14 @@ Vector<int64_t> AStar3D::get_id_path(int64_t p_from_id, int64_t p_to_id) {
 		int64_t idx = pc - 1;
 		while (p != begin_point) {
 			w[idx--] = p->id;
-			p = p->prev_point;
+			p = context->nodes[p->index].prev_point;
 		}
 
 		w[0] = p->id; // Assign first
 	}
 
+	_release_search_context(context);
+
 	return path;
 }
 
@@ -705,8 +719,10 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id) {
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	AStar3D::SearchContext *context = astar._acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
+		astar._release_search_context(context);
 		return Vector<Vector2>();
 	}
 
@@ -714,7 +730,7 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id) {
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->nodes[p->index].prev_point;
 	}
 
 	Vector<Vector2> path;
@@ -727,12 +743,14 @@ Vector<Vector2> AStar2D::get_point_path(int64_t p_from_id, int64_t p_to_id) {
 		int64_t idx = pc - 1;
 		while (p2 != begin_point) {
 			w[idx--] = Vector2(p2->pos.x, p2->pos.y);
-			p2 = p2->prev_point;
+			p2 = context->nodes[p2->index].prev_point;
 		}
 
 		w[0] = Vector2(p2->pos.x, p2->pos.y); // Assign first
 	}
 
+	astar._release_search_context(context);
+
 	return path;
 }
 
@@ -754,8 +772,10 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id) {
 	AStar3D::Point *begin_point = a;
 	AStar3D::Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	AStar3D::SearchContext *context = astar._acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
+		astar._release_search_context(context);
 		return Vector<int64_t>();
 	}
 
@@ -763,7 +783,7 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id) {
 	int64_t pc = 1; // Begin point
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->nodes[p->index].prev_point;
 	}
 
 	Vector<int64_t> path;
@@ -776,17 +796,19 @@ Vector<int64_t> AStar2D::get_id_path(int64_t p_from_id, int64_t p_to_id) {
 		int64_t idx = pc - 1;
 		while (p != begin_point) {
 			w[idx--] = p->id;
-			p = p->prev_point;
+			p = context->nodes[p->index].prev_point;
 		}
 
 		w[0] = p->id; // Assign first
 	}
 
+	astar._release_search_context(context);
+
 	return path;
 }
 
-bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
-	astar.pass++;
+bool AStar2D::_solve(AStar3D::SearchContext &r_context, AStar3D::Point *begin_point, AStar3D::Point *end_point) {
+	r_context.pass++;
 
 	if (!end_point->enabled) {
 		return false;
@@ -794,52 +816,52 @@ bool AStar2D::_solve(AStar3D::Point *begin_point, AStar3D::Point *end_point) {
 
 	bool found_route = false;
 
-	LocalVector<AStar3D::Point *> open_list;
-	SortArray<AStar3D::Point *, AStar3D::SortPoints> sorter;
+	r_context.open_list.clear();
 
-	begin_point->g_score = 0;
-	begin_point->f_score = _estimate_cost(begin_point->id, end_point->id);
-	open_list.push_back(begin_point);
+	AStar3D::SearchNode &begin_node = r_context.nodes[begin_point->index];
+	begin_node.g_score = 0;
+	begin_node.f_score = _estimate_cost(begin_point->id, end_point->id);
+	r_context.heap_push(begin_point);
 
-	while (!open_list.is_empty()) {
-		AStar3D::Point *p = open_list[0]; // The currently processed point.
+	while (!r_context.open_list.is_empty()) {
+		AStar3D::Point *p = r_context.open_list[0]; // The currently processed point.
 
 		if (p == end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = astar.pass; // Mark the point as closed.
+		r_context.heap_pop(); // Remove the current point from the open list.
+		AStar3D::SearchNode &node = r_context.nodes[p->index];
+		node.closed_pass = r_context.pass; // Mark the point as closed.
 
 		for (OAHashMap<int64_t, AStar3D::Point *>::Iterator it = p->neighbors.iter(); it.valid; it = p->neighbors.next_iter(it)) {
 			AStar3D::Point *e = *(it.value); // The neighbor point.
+			AStar3D::SearchNode &e_node = r_context.nodes[e->index];
 
-			if (!e->enabled || e->closed_pass == astar.pass) {
+			if (!e->enabled || e_node.closed_pass == r_context.pass) {
 				continue;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * e->weight_scale;
+			real_t tentative_g_score = node.g_score + _compute_cost(p->id, e->id) * e->weight_scale;
 
 			bool new_point = false;
 
-			if (e->open_pass != astar.pass) { // The point wasn't inside the open list.
-				e->open_pass = astar.pass;
-				open_list.push_back(e);
+			if (e_node.open_pass != r_context.pass) { // The point wasn't inside the open list.
+				e_node.open_pass = r_context.pass;
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, end_point->id);
+			e_node.prev_point = p;
+			e_node.g_score = tentative_g_score;
+			e_node.f_score = e_node.g_score + _estimate_cost(e->id, end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+			if (new_point) {
+				r_context.heap_push(e);
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				r_context.heap_sift_up(e_node.heap_index);
 			}
 		}
 	}
@@ -31,8 +31,10 @@
 #ifndef A_STAR_H
 #define A_STAR_H
 
+#include "core/math/a_star_search.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/oa_hash_map.h"
 
 /**
@@ -47,32 +49,17 @@ class AStar3D : public RefCounted {
 		Point() {}
 
 		int64_t id = 0;
+		uint32_t index = 0; // Slot of this point in the search context nodes.
 		Vector3 pos;
 		real_t weight_scale = 0;
 		bool enabled = false;
 
 		OAHashMap<int64_t, Point *> neighbors = 4u;
 		OAHashMap<int64_t, Point *> unlinked_neighbours = 4u;
-
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
 	};
 
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
-				return true;
-			} else if (A->f_score < B->f_score) {
-				return false;
-			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
-			}
-		}
-	};
+	typedef AStarSearchNode<Point> SearchNode;
+	typedef AStarSearchContext<Point> SearchContext;
 
 	struct Segment {
 		Pair<int64_t, int64_t> key;
@@ -105,12 +92,17 @@ class AStar3D : public RefCounted {
 	};
 
 	int64_t last_free_id = 0;
-	uint64_t pass = 1;
+	uint32_t point_index_count = 0;
+	LocalVector<uint32_t> free_point_indices;
 
 	OAHashMap<int64_t, Point *> points;
 	HashSet<Segment, Segment> segments;
 
-	bool _solve(Point *begin_point, Point *end_point);
+	AStarSearchContextPool<SearchContext> search_context_pool;
+
+	_FORCE_INLINE_ SearchContext *_acquire_search_context() { return search_context_pool.acquire(point_index_count); }
+	_FORCE_INLINE_ void _release_search_context(SearchContext *p_context) { search_context_pool.release(p_context); }
+	bool _solve(SearchContext &r_context, Point *begin_point, Point *end_point);
 
 protected:
 	static void _bind_methods();
@@ -160,7 +152,7 @@ class AStar2D : public RefCounted {
 	GDCLASS(AStar2D, RefCounted);
 	AStar3D astar;
 
-	bool _solve(AStar3D::Point *begin_point, AStar3D::Point *end_point);
+	bool _solve(AStar3D::SearchContext &r_context, AStar3D::Point *begin_point, AStar3D::Point *end_point);
 
 protected:
 	static void _bind_methods();
@@ -144,11 +144,19 @@ void AStarGrid2D::update() {
 				default:
 					break;
 			}
-			line.push_back(Point(Vector2i(x, y), v));
+			line.push_back(Point(Vector2i(x, y), v, (y - region.position.y) * region.size.x + (x - region.position.x)));
 		}
 		points.push_back(line);
 	}
 
+	solid_mask_stride = (region.size.x + 63) / 64;
+	solid_mask.resize(solid_mask_stride * region.size.y);
+	// Cells past the end of a row are solid, so scans stop there like at the region border.
+	const uint64_t row_padding = (region.size.x & 63) ? ~((uint64_t(1) << (region.size.x & 63)) - 1) : 0;
+	for (uint32_t i = 0; i < solid_mask.size(); i++) {
+		solid_mask[i] = (i % solid_mask_stride == solid_mask_stride - 1) ? row_padding : 0;
+	}
+
 	dirty = false;
 }
 
@@ -202,13 +210,13 @@ AStarGrid2D::Heuristic AStarGrid2D::get_default_estimate_heuristic() const {
 void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
 	ERR_FAIL_COND_MSG(dirty, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is disabled. Point %s out of bounds %s.", p_id, region));
-	_get_point_unchecked(p_id)->solid = p_solid;
+	_set_solid_span(p_id.y, p_id.x, p_id.x + 1, p_solid);
 }
 
 bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
 	ERR_FAIL_COND_V_MSG(dirty, false, "Grid is not initialized. Call the update method.");
 	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), false, vformat("Can't get if point is disabled. Point %s out of bounds %s.", p_id, region));
-	return _get_point_unchecked(p_id)->solid;
+	return _is_solid_unchecked(p_id.x, p_id.y);
 }
 
 void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale) {
@@ -232,9 +240,7 @@ void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
 	const int32_t end_y = safe_region.get_end().y;
 
 	for (int32_t y = safe_region.position.y; y < end_y; y++) {
-		for (int32_t x = safe_region.position.x; x < end_x; x++) {
-			_get_point_unchecked(x, y)->solid = p_solid;
-		}
+		_set_solid_span(y, safe_region.position.x, end_x, p_solid);
 	}
 }
 
@@ -253,11 +259,88 @@ void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weig
 	}
 }
 
-AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
-	if (!p_to || p_to->solid) {
+void AStarGrid2D::_set_solid_span(int32_t p_y, int32_t p_from_x, int32_t p_to_x, bool p_solid) {
+	uint64_t *row = solid_mask.ptr() + (p_y - region.position.y) * solid_mask_stride;
+	uint32_t from = p_from_x - region.position.x;
+	const uint32_t to = p_to_x - region.position.x;
+
+	while (from < to) {
+		const uint32_t word = from >> 6;
+		const uint32_t word_end = MIN(to, (word + 1) << 6);
+		const uint32_t count = word_end - from;
+		const uint64_t mask = (count == 64 ? UINT64_MAX : (uint64_t(1) << count) - 1) << (from & 63);
+		if (p_solid) {
+			row[word] |= mask;
+		} else {
+			row[word] &= ~mask;
+		}
+		from = word_end;
+	}
+}
+
+uint64_t AStarGrid2D::_get_walkable_bits(int32_t p_x, int32_t p_y) const {
+	// Bit i is set if the cell (p_x + i, p_y) is walkable, cells outside of the region are not.
+	if (p_y < region.position.y || p_y >= region.get_end().y || solid_mask_stride == 0) {
+		return 0;
+	}
+
+	const uint64_t *row = solid_mask.ptr() + (p_y - region.position.y) * solid_mask_stride;
+	const int64_t x = (int64_t)p_x - region.position.x;
+	const int64_t word = x >= 0 ? x / 64 : -((63 - x) / 64);
+	const uint32_t shift = x - word * 64;
+
+	const uint64_t low = (word >= 0 && word < solid_mask_stride) ? row[word] : UINT64_MAX;
+	uint64_t solid = low >> shift;
+	if (shift != 0) {
+		const uint64_t high = (word + 1 >= 0 && word + 1 < solid_mask_stride) ? row[word + 1] : UINT64_MAX;
+		solid |= high << (64 - shift);
+	}
+	return ~solid;
+}
+
+AStarGrid2D::Point *AStarGrid2D::_jump_horizontal(int32_t p_x, int32_t p_y, int32_t p_dx, const Point *p_end) {
+	// Same stop conditions as the recursive jump, evaluated for 64 cells of the row at once.
+	// Forced neighbors come from the rows above and below compared with the same rows shifted by one cell.
+	const bool nbor_ahead = diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE;
+	const int32_t nbor_offset = nbor_ahead ? p_dx : -p_dx;
+
+	int32_t x = p_x;
+	while (true) {
+		const int32_t chunk_x = p_dx > 0 ? x : x - 63;
+
+		const uint64_t walkable = _get_walkable_bits(chunk_x, p_y);
+		const uint64_t above = _get_walkable_bits(chunk_x, p_y - 1);
+		const uint64_t above_nbor = _get_walkable_bits(chunk_x + nbor_offset, p_y - 1);
+		const uint64_t below = _get_walkable_bits(chunk_x, p_y + 1);
+		const uint64_t below_nbor = _get_walkable_bits(chunk_x + nbor_offset, p_y + 1);
+
+		uint64_t stop = ~walkable;
+		if (nbor_ahead) {
+			stop |= (above_nbor & ~above) | (below_nbor & ~below);
+		} else {
+			stop |= (above & ~above_nbor) | (below & ~below_nbor);
+		}
+		if (p_end->id.y == p_y && p_end->id.x >= chunk_x && p_end->id.x < chunk_x + 64) {
+			stop |= uint64_t(1) << (p_end->id.x - chunk_x);
+		}
+
+		if (stop != 0) {
+			const int32_t bit = p_dx > 0 ? count_trailing_zeros_64(stop) : 63 - count_leading_zeros_64(stop);
+			if (!(walkable & (uint64_t(1) << bit))) {
+				return nullptr;
+			}
+			return _get_point_unchecked(chunk_x + bit, p_y);
+		}
+
+		x += 64 * p_dx;
+	}
+}
+
+AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to, const Point *p_end) {
+	if (!p_to || _is_point_solid(p_to)) {
 		return nullptr;
 	}
-	if (p_to == end) {
+	if (p_to == p_end) {
 		return p_to;
 	}
 
@@ -270,15 +353,19 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 	int32_t dx = to_x - from_x;
 	int32_t dy = to_y - from_y;
 
+	if (dy == 0) {
+		return _jump_horizontal(to_x, to_y, dx, p_end);
+	}
+
 	if (diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE) {
 		if (dx != 0 && dy != 0) {
 			if ((_is_walkable(to_x - dx, to_y + dy) && !_is_walkable(to_x - dx, to_y)) || (_is_walkable(to_x + dx, to_y - dy) && !_is_walkable(to_x, to_y - dy))) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x + dx, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x + dx, to_y), p_end) != nullptr) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x, to_y + dy)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x, to_y + dy), p_end) != nullptr) {
 				return p_to;
 			}
 		} else {
@@ -293,17 +380,17 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			}
 		}
 		if (_is_walkable(to_x + dx, to_y + dy) && (diagonal_mode == DIAGONAL_MODE_ALWAYS || (_is_walkable(to_x + dx, to_y) || _is_walkable(to_x, to_y + dy)))) {
-			return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+			return _jump(p_to, _get_point(to_x + dx, to_y + dy), p_end);
 		}
 	} else if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES) {
 		if (dx != 0 && dy != 0) {
 			if ((_is_walkable(to_x + dx, to_y + dy) && !_is_walkable(to_x, to_y + dy)) || !_is_walkable(to_x + dx, to_y)) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x + dx, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x + dx, to_y), p_end) != nullptr) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x, to_y + dy)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x, to_y + dy), p_end) != nullptr) {
 				return p_to;
 			}
 		} else {
@@ -318,7 +405,7 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			}
 		}
 		if (_is_walkable(to_x + dx, to_y + dy) && _is_walkable(to_x + dx, to_y) && _is_walkable(to_x, to_y + dy)) {
-			return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+			return _jump(p_to, _get_point(to_x + dx, to_y + dy), p_end);
 		}
 	} else { // DIAGONAL_MODE_NEVER
 		if (dx != 0) {
@@ -329,14 +416,14 @@ AStarGrid2D::Point *AStarGrid2D::_jump(Point *p_from, Point *p_to) {
 			if ((_is_walkable(to_x - 1, to_y) && !_is_walkable(to_x - 1, to_y - dy)) || (_is_walkable(to_x + 1, to_y) && !_is_walkable(to_x + 1, to_y - dy))) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x + 1, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x + 1, to_y), p_end) != nullptr) {
 				return p_to;
 			}
-			if (_jump(p_to, _get_point(to_x - 1, to_y)) != nullptr) {
+			if (_jump(p_to, _get_point(to_x - 1, to_y), p_end) != nullptr) {
 				return p_to;
 			}
 		}
-		return _jump(p_to, _get_point(to_x + dx, to_y + dy));
+		return _jump(p_to, _get_point(to_x + dx, to_y + dy), p_end);
 	}
 	return nullptr;
 }
@@ -389,19 +476,19 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 		}
 	}
 
-	if (top && !top->solid) {
+	if (top && !_is_point_solid(top)) {
 		r_nbors.push_back(top);
 		ts0 = true;
 	}
-	if (right && !right->solid) {
+	if (right && !_is_point_solid(right)) {
 		r_nbors.push_back(right);
 		ts1 = true;
 	}
-	if (bottom && !bottom->solid) {
+	if (bottom && !_is_point_solid(bottom)) {
 		r_nbors.push_back(bottom);
 		ts2 = true;
 	}
-	if (left && !left->solid) {
+	if (left && !_is_point_solid(left)) {
 		r_nbors.push_back(left);
 		ts3 = true;
 	}
@@ -431,87 +518,86 @@ void AStarGrid2D::_get_nbors(Point *p_point, LocalVector<Point *> &r_nbors) {
 			break;
 	}
 
-	if (td0 && (top_left && !top_left->solid)) {
+	if (td0 && (top_left && !_is_point_solid(top_left))) {
 		r_nbors.push_back(top_left);
 	}
-	if (td1 && (top_right && !top_right->solid)) {
+	if (td1 && (top_right && !_is_point_solid(top_right))) {
 		r_nbors.push_back(top_right);
 	}
-	if (td2 && (bottom_right && !bottom_right->solid)) {
+	if (td2 && (bottom_right && !_is_point_solid(bottom_right))) {
 		r_nbors.push_back(bottom_right);
 	}
-	if (td3 && (bottom_left && !bottom_left->solid)) {
+	if (td3 && (bottom_left && !_is_point_solid(bottom_left))) {
 		r_nbors.push_back(bottom_left);
 	}
 }
 
-bool AStarGrid2D::_solve(Point *p_begin_point, Point *p_end_point) {
-	pass++;
+bool AStarGrid2D::_solve(SearchContext &r_context, Point *p_begin_point, Point *p_end_point) {
+	r_context.pass++;
 
-	if (p_end_point->solid) {
+	if (_is_point_solid(p_end_point)) {
 		return false;
 	}
 
 	bool found_route = false;
 
-	LocalVector<Point *> open_list;
-	SortArray<Point *, SortPoints> sorter;
+	r_context.open_list.clear();
 
-	p_begin_point->g_score = 0;
-	p_begin_point->f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
-	open_list.push_back(p_begin_point);
-	end = p_end_point;
+	SearchNode &begin_node = r_context.nodes[p_begin_point->index];
+	begin_node.g_score = 0;
+	begin_node.f_score = _estimate_cost(p_begin_point->id, p_end_point->id);
+	r_context.heap_push(p_begin_point);
 
-	while (!open_list.is_empty()) {
-		Point *p = open_list[0]; // The currently processed point.
+	while (!r_context.open_list.is_empty()) {
+		Point *p = r_context.open_list[0]; // The currently processed point.
 
 		if (p == p_end_point) {
 			found_route = true;
 			break;
 		}
 
-		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current point from the open list.
-		open_list.remove_at(open_list.size() - 1);
-		p->closed_pass = pass; // Mark the point as closed.
+		r_context.heap_pop(); // Remove the current point from the open list.
+		SearchNode &node = r_context.nodes[p->index];
+		node.closed_pass = r_context.pass; // Mark the point as closed.
 
-		LocalVector<Point *> nbors;
-		_get_nbors(p, nbors);
+		r_context.nbors.clear();
+		_get_nbors(p, r_context.nbors);
 
-		for (Point *e : nbors) {
+		for (Point *e : r_context.nbors) {
 			real_t weight_scale = 1.0;
 
 			if (jumping_enabled) {
 				// TODO: Make it works with weight_scale.
-				e = _jump(p, e);
-				if (!e || e->closed_pass == pass) {
+				e = _jump(p, e, p_end_point);
+				if (!e || r_context.nodes[e->index].closed_pass == r_context.pass) {
 					continue;
 				}
 			} else {
-				if (e->solid || e->closed_pass == pass) {
+				if (_is_point_solid(e) || r_context.nodes[e->index].closed_pass == r_context.pass) {
 					continue;
 				}
 				weight_scale = e->weight_scale;
 			}
 
-			real_t tentative_g_score = p->g_score + _compute_cost(p->id, e->id) * weight_scale;
+			SearchNode &e_node = r_context.nodes[e->index];
+			real_t tentative_g_score = node.g_score + _compute_cost(p->id, e->id) * weight_scale;
 			bool new_point = false;
 
-			if (e->open_pass != pass) { // The point wasn't inside the open list.
-				e->open_pass = pass;
-				open_list.push_back(e);
+			if (e_node.open_pass != r_context.pass) { // The point wasn't inside the open list.
+				e_node.open_pass = r_context.pass;
 				new_point = true;
-			} else if (tentative_g_score >= e->g_score) { // The new path is worse than the previous.
+			} else if (tentative_g_score >= e_node.g_score) { // The new path is worse than the previous.
 				continue;
 			}
 
-			e->prev_point = p;
-			e->g_score = tentative_g_score;
-			e->f_score = e->g_score + _estimate_cost(e->id, p_end_point->id);
+			e_node.prev_point = p;
+			e_node.g_score = tentative_g_score;
+			e_node.f_score = e_node.g_score + _estimate_cost(e->id, p_end_point->id);
 
-			if (new_point) { // The position of the new points is already known.
-				sorter.push_heap(0, open_list.size() - 1, 0, e, open_list.ptr());
+			if (new_point) {
+				r_context.heap_push(e);
 			} else {
-				sorter.push_heap(0, open_list.find(e), 0, e, open_list.ptr());
+				r_context.heap_sift_up(e_node.heap_index);
 			}
 		}
 	}
@@ -537,6 +623,8 @@ real_t AStarGrid2D::_compute_cost(const Vector2i &p_from_id, const Vector2i &p_t
 
 void AStarGrid2D::clear() {
 	points.clear();
+	solid_mask.clear();
+	solid_mask_stride = 0;
 	region = Rect2i();
 }
 
@@ -563,8 +651,10 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	Point *begin_point = a;
 	Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	SearchContext *context = _acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
+		_release_search_context(context);
 		return Vector<Vector2>();
 	}
 
@@ -572,7 +662,7 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 	int32_t pc = 1;
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->nodes[p->index].prev_point;
 	}
 
 	Vector<Vector2> path;
@@ -585,12 +675,14 @@ Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vec
 		int32_t idx = pc - 1;
 		while (p != begin_point) {
 			w[idx--] = p->pos;
-			p = p->prev_point;
+			p = context->nodes[p->index].prev_point;
 		}
 
 		w[0] = p->pos;
 	}
 
+	_release_search_context(context);
+
 	return path;
 }
 
@@ -611,8 +703,10 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	Point *begin_point = a;
 	Point *end_point = b;
 
-	bool found_route = _solve(begin_point, end_point);
+	SearchContext *context = _acquire_search_context();
+	bool found_route = _solve(*context, begin_point, end_point);
 	if (!found_route) {
+		_release_search_context(context);
 		return TypedArray<Vector2i>();
 	}
 
@@ -620,7 +714,7 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 	int32_t pc = 1;
 	while (p != begin_point) {
 		pc++;
-		p = p->prev_point;
+		p = context->nodes[p->index].prev_point;
 	}
 
 	TypedArray<Vector2i> path;
@@ -631,12 +725,14 @@ TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const V
 		int32_t idx = pc - 1;
 		while (p != begin_point) {
 			path[idx--] = p->id;
-			p = p->prev_point;
+			p = context->nodes[p->index].prev_point;
 		}
 
 		path[0] = p->id;
 	}
 
+	_release_search_context(context);
+
 	return path;
 }
 
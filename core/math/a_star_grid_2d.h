@@ -31,6 +31,7 @@
 #ifndef A_STAR_GRID_2D_H
 #define A_STAR_GRID_2D_H
 
+#include "core/math/a_star_search.h"
 #include "core/object/gdvirtual.gen.inc"
 #include "core/object/ref_counted.h"
 #include "core/templates/list.h"
@@ -78,44 +79,44 @@ private:
 	struct Point {
 		Vector2i id;
 
-		bool solid = false;
 		Vector2 pos;
 		real_t weight_scale = 1.0;
 
-		// Used for pathfinding.
-		Point *prev_point = nullptr;
-		real_t g_score = 0;
-		real_t f_score = 0;
-		uint64_t open_pass = 0;
-		uint64_t closed_pass = 0;
+		uint32_t index = 0; // Position of the cell in the region, used to find its search node.
 
 		Point() {}
 
-		Point(const Vector2i &p_id, const Vector2 &p_pos) :
-				id(p_id), pos(p_pos) {}
+		Point(const Vector2i &p_id, const Vector2 &p_pos, uint32_t p_index) :
+				id(p_id), pos(p_pos), index(p_index) {}
 	};
 
-	struct SortPoints {
-		_FORCE_INLINE_ bool operator()(const Point *A, const Point *B) const { // Returns true when the Point A is worse than Point B.
-			if (A->f_score > B->f_score) {
-				return true;
-			} else if (A->f_score < B->f_score) {
-				return false;
-			} else {
-				return A->g_score < B->g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
-			}
-		}
+	typedef AStarSearchNode<Point> SearchNode;
+
+	struct SearchContext : public AStarSearchContext<Point> {
+		LocalVector<Point *> nbors;
 	};
 
 	LocalVector<LocalVector<Point>> points;
-	Point *end = nullptr;
 
-	uint64_t pass = 1;
+	// One bit per cell, each row padded to whole words with solid bits, so runs of cells can be tested 64 at a time.
+	LocalVector<uint64_t> solid_mask;
+	uint32_t solid_mask_stride = 0; // Words per row.
+
+	AStarSearchContextPool<SearchContext> search_context_pool;
 
 private: // Internal routines.
+	_FORCE_INLINE_ bool _is_solid_unchecked(int32_t p_x, int32_t p_y) const {
+		const uint32_t x = p_x - region.position.x;
+		return solid_mask[(p_y - region.position.y) * solid_mask_stride + (x >> 6)] & (uint64_t(1) << (x & 63));
+	}
+
+	_FORCE_INLINE_ bool _is_point_solid(const Point *p_point) const {
+		return _is_solid_unchecked(p_point->id.x, p_point->id.y);
+	}
+
 	_FORCE_INLINE_ bool _is_walkable(int32_t p_x, int32_t p_y) const {
 		if (region.has_point(Vector2i(p_x, p_y))) {
-			return !points[p_y - region.position.y][p_x - region.position.x].solid;
+			return !_is_solid_unchecked(p_x, p_y);
 		}
 		return false;
 	}
@@ -139,9 +140,16 @@ private: // Internal routines.
 		return &points[p_id.y - region.position.y][p_id.x - region.position.x];
 	}
 
+	void _set_solid_span(int32_t p_y, int32_t p_from_x, int32_t p_to_x, bool p_solid);
+	uint64_t _get_walkable_bits(int32_t p_x, int32_t p_y) const;
+
 	void _get_nbors(Point *p_point, LocalVector<Point *> &r_nbors);
-	Point *_jump(Point *p_from, Point *p_to);
-	bool _solve(Point *p_begin_point, Point *p_end_point);
+	Point *_jump(Point *p_from, Point *p_to, const Point *p_end);
+	Point *_jump_horizontal(int32_t p_x, int32_t p_y, int32_t p_dx, const Point *p_end);
+
+	_FORCE_INLINE_ SearchContext *_acquire_search_context() { return search_context_pool.acquire(region.size.x * region.size.y); }
+	_FORCE_INLINE_ void _release_search_context(SearchContext *p_context) { search_context_pool.release(p_context); }
+	bool _solve(SearchContext &r_context, Point *p_begin_point, Point *p_end_point);
 
 protected:
 	static void _bind_methods();
@@ -0,0 +1,159 @@
+/**************************************************************************/
+/*  a_star_search.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef A_STAR_SEARCH_H
+#define A_STAR_SEARCH_H
+
+#include "core/math/math_defs.h"
+#include "core/os/memory.h"
+#include "core/os/mutex.h"
+#include "core/templates/local_vector.h"
+
+// Search state shared by AStar3D and AStarGrid2D.
+// The pathfinding state of each point lives in a search context instead of the points, so that several
+// queries can read the same graph at once. TPoint only needs an `index` member, its slot in the nodes.
+
+template <class TPoint>
+struct AStarSearchNode {
+	TPoint *prev_point = nullptr;
+	real_t g_score = 0;
+	real_t f_score = 0;
+	uint32_t heap_index = 0;
+	uint64_t open_pass = 0;
+	uint64_t closed_pass = 0;
+};
+
+template <class TPoint>
+struct AStarSearchContext {
+	uint64_t pass = 0;
+	LocalVector<AStarSearchNode<TPoint>> nodes;
+	LocalVector<TPoint *> open_list; // Binary heap, each node knows its position so it can be moved up in place.
+
+	_FORCE_INLINE_ bool is_worse(const TPoint *p_a, const TPoint *p_b) const { // Returns true when the Point A is worse than Point B.
+		const AStarSearchNode<TPoint> &a = nodes[p_a->index];
+		const AStarSearchNode<TPoint> &b = nodes[p_b->index];
+		if (a.f_score > b.f_score) {
+			return true;
+		} else if (a.f_score < b.f_score) {
+			return false;
+		} else {
+			return a.g_score < b.g_score; // If the f_costs are the same then prioritize the points that are further away from the start.
+		}
+	}
+
+	void heap_push(TPoint *p_point) {
+		open_list.push_back(p_point);
+		heap_sift_up(open_list.size() - 1);
+	}
+
+	void heap_sift_up(uint32_t p_heap_index) {
+		TPoint *point = open_list[p_heap_index];
+		while (p_heap_index > 0) {
+			const uint32_t parent_index = (p_heap_index - 1) / 2;
+			if (!is_worse(open_list[parent_index], point)) {
+				break;
+			}
+			open_list[p_heap_index] = open_list[parent_index];
+			nodes[open_list[p_heap_index]->index].heap_index = p_heap_index;
+			p_heap_index = parent_index;
+		}
+		open_list[p_heap_index] = point;
+		nodes[point->index].heap_index = p_heap_index;
+	}
+
+	TPoint *heap_pop() {
+		TPoint *top = open_list[0];
+		TPoint *last = open_list[open_list.size() - 1];
+		open_list.remove_at(open_list.size() - 1);
+
+		const uint32_t size = open_list.size();
+		if (size > 0) {
+			uint32_t heap_index = 0;
+			while (true) {
+				uint32_t child_index = heap_index * 2 + 1;
+				if (child_index >= size) {
+					break;
+				}
+				if (child_index + 1 < size && is_worse(open_list[child_index], open_list[child_index + 1])) {
+					child_index++;
+				}
+				if (!is_worse(last, open_list[child_index])) {
+					break;
+				}
+				open_list[heap_index] = open_list[child_index];
+				nodes[open_list[heap_index]->index].heap_index = heap_index;
+				heap_index = child_index;
+			}
+			open_list[heap_index] = last;
+			nodes[last->index].heap_index = heap_index;
+		}
+
+		return top;
+	}
+};
+
+// Contexts are reused between queries, so a search only allocates when the graph grew since its context was last used.
+template <class TContext>
+class AStarSearchContextPool {
+	Mutex mutex;
+	LocalVector<TContext *> pool;
+
+public:
+	TContext *acquire(uint32_t p_node_count) {
+		TContext *context = nullptr;
+		{
+			MutexLock lock(mutex);
+			if (!pool.is_empty()) {
+				context = pool[pool.size() - 1];
+				pool.remove_at(pool.size() - 1);
+			}
+		}
+		if (!context) {
+			context = memnew(TContext);
+		}
+		if (context->nodes.size() < p_node_count) {
+			context->nodes.resize(p_node_count);
+		}
+		return context;
+	}
+
+	void release(TContext *p_context) {
+		MutexLock lock(mutex);
+		pool.push_back(p_context);
+	}
+
+	~AStarSearchContextPool() {
+		for (TContext *context : pool) {
+			memdelete(context);
+		}
+	}
+};
+
+#endif // A_STAR_SEARCH_H
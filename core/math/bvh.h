@@ -52,6 +52,7 @@
 // and pairable_mask is either 0 if static, or set to all if non static
 
 #include "bvh_tree.h"
+#include "core/object/worker_thread_pool.h"
 #include "core/os/mutex.h"
 
 #define BVHTREE_CLASS BVH_Tree<T, NUM_TREES, 2, MAX_ITEMS, USER_PAIR_TEST_FUNCTION, USER_CULL_TEST_FUNCTION, USE_PAIRS, BOUNDS, POINT>
@@ -88,6 +89,14 @@ public:
 		tree.params_set_pairing_expansion(p_value);
 	}
 
+	// When enabled, pairing tests for the moved items are culled on the WorkerThreadPool.
+	// Pair / unpair callbacks are still sent from the calling thread, in the same order as
+	// without it, no matter how many threads are used, so the results stay deterministic.
+	void params_set_parallel_pair_check(bool p_enable) {
+		BVH_LOCKED_FUNCTION
+		_parallel_pair_check = p_enable;
+	}
+
 	void set_pair_callback(PairCallback p_callback, void *p_userdata) {
 		BVH_LOCKED_FUNCTION
 		pair_callback = p_callback;
@@ -428,6 +437,60 @@ public:
 	}
 
 private:
+	void _cull_changed_item(uint32_t p_index, void *p_userdata) {
+		const BVHHandle &h = changed_items[p_index];
+
+		typename BVHTREE_CLASS::CullParams params;
+		params.result_count_overall = 0;
+		params.result_max = INT_MAX;
+		params.result_array = nullptr;
+		params.subindex_array = nullptr;
+		tree.item_fill_cullparams(h, params);
+		params.abb.from(tree._pairs[h.id()].expanded_aabb);
+
+		tree.cull_aabb_to_hits(params, _changed_item_hits[p_index]);
+	}
+
+	void _check_for_collisions_parallel(bool p_full_check) {
+		uint32_t changed_count = changed_items.size();
+
+		// Culling only reads the tree, and pairing doesn't change it, so the hits of every moved item
+		// can be found up front, each on its own thread.
+		if (_changed_item_hits.size() < changed_count) {
+			_changed_item_hits.resize(changed_count);
+		}
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		if (changed_count >= PARALLEL_PAIR_CHECK_MIN_ITEMS && pool && pool->get_thread_count() > 1) {
+			WorkerThreadPool::GroupID group_task = pool->add_template_group_task(this, &BVH_Manager::_cull_changed_item, nullptr, changed_count, -1, true, SNAME("BVHPairCheck"));
+			pool->wait_for_group_task_completion(group_task);
+		} else {
+			for (uint32_t n = 0; n < changed_count; n++) {
+				_cull_changed_item(n, nullptr);
+			}
+		}
+
+		// Leavers and new pairs change the pairs and send callbacks, so they are processed serially,
+		// item by item in the same order as _check_for_collisions().
+		for (uint32_t n = 0; n < changed_count; n++) {
+			const BVHHandle &h = changed_items[n];
+
+			BVHABB_CLASS abb;
+			abb.from(tree._pairs[h.id()].expanded_aabb);
+			_find_leavers(h, abb, p_full_check);
+
+			for (const uint32_t ref_id : _changed_item_hits[n]) {
+				if (ref_id == h.id()) {
+					continue;
+				}
+				BVHHandle h_collidee;
+				h_collidee.set_id(ref_id);
+				_collide(h, h_collidee);
+			}
+		}
+
+		_reset();
+	}
+
 	// do this after moving etc.
 	void _check_for_collisions(bool p_full_check = false) {
 		if (!changed_items.size()) {
@@ -435,6 +498,11 @@ private:
 			return;
 		}
 
+		if (_parallel_pair_check) {
+			_check_for_collisions_parallel(p_full_check);
+			return;
+		}
+
 		BOUNDS bb;
 
 		typename BVHTREE_CLASS::CullParams params;
@@ -773,6 +841,12 @@ private:
 	LocalVector<BVHHandle, uint32_t, true> changed_items;
 	uint32_t _tick = 1; // Start from 1 so items with 0 indicate never updated.
 
+	// Below this many moved items, parallel pair checks are run on the calling thread.
+	static const uint32_t PARALLEL_PAIR_CHECK_MIN_ITEMS = 64;
+	bool _parallel_pair_check = false;
+	// Cull results for each of the changed items, for parallel pair checks.
+	LocalVector<LocalVector<uint32_t, uint32_t, true>> _changed_item_hits;
+
 	class BVHLockedFunction {
 	public:
 		BVHLockedFunction(Mutex *p_mutex, bool p_thread_safe) {
@@ -1133,6 +1133,13 @@ Error Object::_emit_signal(const Variant **p_args, int p_argcount, Callable::Cal
 	return emit_signalp(signal, args, argc);
 }
 
+void Object::SignalData::invalidate_snapshot() {
+	Snapshot *old_snapshot = snapshot.exchange(nullptr, std::memory_order_acq_rel);
+	if (old_snapshot && old_snapshot->refcount.unref()) {
+		memdelete(old_snapshot);
+	}
+}
+
 Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int p_argcount) {
 	if (_block_signals) {
 		return ERR_CANT_ACQUIRE_RESOURCE; //no emit, signals blocked
@@ -1155,38 +1162,67 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 
 	List<_ObjectSignalDisconnectData> disconnect_data;
 
-	// Ensure that disconnecting the signal or even deleting the object
-	// will not affect the signal calling.
-	LocalVector<Connection> slot_conns;
-	slot_conns.resize(s->slot_map.size());
-	{
+	SignalData::Snapshot *snapshot = s->snapshot.load(std::memory_order_acquire);
+	if (!snapshot) {
+		snapshot = memnew(SignalData::Snapshot);
+		snapshot->refcount.init();
+		snapshot->entries.resize(s->slot_map.size());
 		uint32_t idx = 0;
 		for (const KeyValue<Callable, SignalData::Slot> &slot_kv : s->slot_map) {
-			slot_conns[idx++] = slot_kv.value.conn;
+			SignalData::Snapshot::Entry &entry = snapshot->entries[idx++];
+			entry.conn = slot_kv.value.conn;
+			const Callable &callable = entry.conn.callable;
+			if (callable.is_standard()) {
+				entry.target_id = callable.get_object_id();
+				// Method binds of extension classes can be freed on reload, so only native ones are cached.
+				const Object *target = ObjectDB::get_instance(entry.target_id);
+				if (target && !target->_extension && callable.get_method() != CoreStringNames::get_singleton()->_free) {
+					entry.method_bind = ClassDB::get_method(target->get_class_name(), callable.get_method());
+				}
+			}
 		}
 		DEV_ASSERT(idx == s->slot_map.size());
+
+		SignalData::Snapshot *published = nullptr;
+		if (!s->snapshot.compare_exchange_strong(published, snapshot, std::memory_order_acq_rel, std::memory_order_acquire)) {
+			// Another thread emitting the same signal got there first.
+			memdelete(snapshot);
+			snapshot = published;
+		}
 	}
 
+	// Ensure that disconnecting the signal or even deleting the object
+	// will not affect the signal calling.
+	snapshot->refcount.ref();
+
 	OBJ_DEBUG_LOCK
 
 	Error err = OK;
 
-	for (const Connection &c : slot_conns) {
-		if (!c.callable.is_valid()) {
-			// Target might have been deleted during signal callback, this is expected and OK.
-			continue;
-		}
-
+	for (const SignalData::Snapshot::Entry &entry : snapshot->entries) {
+		const Connection &c = entry.conn;
 		const Variant **args = p_args;
 		int argc = p_argcount;
 
-		if (c.flags & CONNECT_DEFERRED) {
-			MessageQueue::get_singleton()->push_callablep(c.callable, args, argc, true);
-		} else {
+		Object *target = nullptr;
+		if (entry.method_bind) {
+			target = ObjectDB::get_instance(entry.target_id);
+			if (!target) {
+				// Target might have been deleted during signal callback, this is expected and OK.
+				continue;
+			}
+		}
+
+		if (entry.method_bind && !target->script_instance && !(c.flags & CONNECT_DEFERRED)) {
+			// Native method with no script in between, call the bind directly.
 			Callable::CallError ce;
 			_emitting = true;
-			Variant ret;
-			c.callable.callp(args, argc, ret, ce);
+			{
+#ifdef DEBUG_ENABLED
+				_ObjectDebugLock target_lock(target);
+#endif
+				entry.method_bind->call(target, args, argc, ce);
+			}
 			_emitting = false;
 
 			if (ce.error != Callable::CallError::CALL_OK) {
@@ -1195,12 +1231,37 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 					continue;
 				}
 #endif
-				Object *target = c.callable.get_object();
-				if (ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD && target && !ClassDB::class_exists(target->get_class_name())) {
-					//most likely object is not initialized yet, do not throw error.
-				} else {
-					ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(c.callable, args, argc, ce) + ".");
-					err = ERR_METHOD_NOT_FOUND;
+				ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(c.callable, args, argc, ce) + ".");
+				err = ERR_METHOD_NOT_FOUND;
+			}
+		} else {
+			if (!c.callable.is_valid()) {
+				// Target might have been deleted during signal callback, this is expected and OK.
+				continue;
+			}
+
+			if (c.flags & CONNECT_DEFERRED) {
+				MessageQueue::get_singleton()->push_callablep(c.callable, args, argc, true);
+			} else {
+				Callable::CallError ce;
+				_emitting = true;
+				Variant ret;
+				c.callable.callp(args, argc, ret, ce);
+				_emitting = false;
+
+				if (ce.error != Callable::CallError::CALL_OK) {
+#ifdef DEBUG_ENABLED
+					if (c.flags & CONNECT_PERSIST && Engine::get_singleton()->is_editor_hint() && (script.is_null() || !Ref<Script>(script)->is_tool())) {
+						continue;
+					}
+#endif
+					target = c.callable.get_object();
+					if (ce.error == Callable::CallError::CALL_ERROR_INVALID_METHOD && target && !ClassDB::class_exists(target->get_class_name())) {
+						//most likely object is not initialized yet, do not throw error.
+					} else {
+						ERR_PRINT("Error calling from signal '" + String(p_name) + "' to callable: " + Variant::get_callable_error_text(c.callable, args, argc, ce) + ".");
+						err = ERR_METHOD_NOT_FOUND;
+					}
 				}
 			}
 		}
@@ -1220,6 +1281,10 @@ Error Object::emit_signalp(const StringName &p_name, const Variant **p_args, int
 		}
 	}
 
+	if (snapshot->refcount.unref()) {
+		memdelete(snapshot);
+	}
+
 	while (!disconnect_data.is_empty()) {
 		const _ObjectSignalDisconnectData &dd = disconnect_data.front()->get();
 
@@ -1437,6 +1502,7 @@ Error Object::connect(const StringName &p_signal, const Callable &p_callable, ui
 
 	//use callable version as key, so binds can be ignored
 	s->slot_map[*p_callable.get_base_comparator()] = slot;
+	s->invalidate_snapshot();
 
 	return OK;
 }
@@ -1494,6 +1560,7 @@ bool Object::_disconnect(const StringName &p_signal, const Callable &p_callable,
 	}
 
 	s->slot_map.erase(*p_callable.get_base_comparator());
+	s->invalidate_snapshot();
 
 	if (s->slot_map.is_empty() && ClassDB::has_signal(get_class_name(), p_signal)) {
 		//not user signal, delete
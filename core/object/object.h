@@ -39,6 +39,7 @@
 #include "core/templates/hash_map.h"
 #include "core/templates/hash_set.h"
 #include "core/templates/list.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/rb_map.h"
 #include "core/templates/safe_refcount.h"
 #include "core/variant/callable_bind.h"
@@ -617,8 +618,38 @@ private:
 			List<Connection>::Element *cE = nullptr;
 		};
 
+		// Immutable copy of the connections, built on first emission and
+		// dropped whenever the slot map changes. Emission holds a reference,
+		// so it can disconnect (or free the emitter) without copying first.
+		// Concurrent emitters may build it at the same time; only the first
+		// one to publish it wins, the others use that one.
+		struct Snapshot {
+			struct Entry {
+				Connection conn;
+				ObjectID target_id;
+				// Only set for plain method callables on native targets.
+				MethodBind *method_bind = nullptr;
+			};
+
+			SafeRefCount refcount;
+			LocalVector<Entry> entries;
+		};
+
 		MethodInfo user;
 		HashMap<Callable, Slot, HashableHasher<Callable>> slot_map;
+		std::atomic<Snapshot *> snapshot = nullptr;
+
+		void invalidate_snapshot();
+
+		SignalData() {}
+		SignalData(const SignalData &p_other) :
+				user(p_other.user), slot_map(p_other.slot_map) {}
+		void operator=(const SignalData &p_other) {
+			invalidate_snapshot();
+			user = p_other.user;
+			slot_map = p_other.slot_map;
+		}
+		~SignalData() { invalidate_snapshot(); }
 	};
 
 	HashMap<StringName, SignalData> signal_map;
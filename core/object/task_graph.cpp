@@ -0,0 +1,228 @@
+/**************************************************************************/
+/*  task_graph.cpp                                                        */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "task_graph.h"
+
+#include "core/templates/command_queue_mt.h"
+
+TaskGraph::NodeID TaskGraph::_add_node(void (*p_func)(void *), void (*p_group_func)(void *, uint32_t), void *p_userdata, WorkerThreadPool::BaseTemplateUserdata *p_template_userdata, bool p_is_group, int p_elements, int p_tasks, const String &p_description) {
+	ERR_FAIL_COND_V_MSG(submitted, INVALID_NODE_ID, "Can't modify a task graph while it's submitted.");
+	ERR_FAIL_COND_V(p_elements < 0, INVALID_NODE_ID);
+
+	Node *node = memnew(Node);
+	node->graph = this;
+	node->native_func = p_func;
+	node->native_group_func = p_group_func;
+	node->native_func_userdata = p_userdata;
+	node->template_userdata = p_template_userdata;
+	node->description = p_description;
+	node->is_group = p_is_group;
+	node->elements = p_elements;
+	node->tasks = p_tasks;
+	nodes.push_back(node);
+	return nodes.size() - 1;
+}
+
+TaskGraph::NodeID TaskGraph::add_native_task(void (*p_func)(void *), void *p_userdata, const String &p_description) {
+	ERR_FAIL_NULL_V(p_func, INVALID_NODE_ID);
+	return _add_node(p_func, nullptr, p_userdata, nullptr, false, 0, 0, p_description);
+}
+
+TaskGraph::NodeID TaskGraph::add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks, const String &p_description) {
+	ERR_FAIL_NULL_V(p_func, INVALID_NODE_ID);
+	return _add_node(nullptr, p_func, p_userdata, nullptr, true, p_elements, p_tasks, p_description);
+}
+
+void TaskGraph::depends_on(NodeID p_node, NodeID p_dependency) {
+	ERR_FAIL_COND_MSG(submitted, "Can't modify a task graph while it's submitted.");
+	ERR_FAIL_INDEX(p_node, (int)nodes.size());
+	ERR_FAIL_INDEX(p_dependency, (int)nodes.size());
+	// Nodes can only depend on nodes added before them, which keeps the graph acyclic.
+	ERR_FAIL_COND_MSG(p_dependency >= p_node, "A task can only depend on tasks added before it.");
+
+	Node *dependency = nodes[p_dependency];
+	if (dependency->successors.find(p_node) != -1) {
+		return;
+	}
+	dependency->successors.push_back(p_node);
+	nodes[p_node]->dependency_count++;
+}
+
+void TaskGraph::set_group_elements(NodeID p_node, int p_elements) {
+	ERR_FAIL_COND_MSG(submitted, "Can't modify a task graph while it's submitted.");
+	ERR_FAIL_INDEX(p_node, (int)nodes.size());
+	ERR_FAIL_COND(!nodes[p_node]->is_group);
+	ERR_FAIL_COND(p_elements < 0);
+	nodes[p_node]->elements = p_elements;
+}
+
+void TaskGraph::set_high_priority(bool p_high_priority) {
+	ERR_FAIL_COND_MSG(submitted, "Can't modify a task graph while it's submitted.");
+	high_priority = p_high_priority;
+}
+
+void TaskGraph::_post_node(Node *p_node) {
+	uint32_t task_count = 1;
+	if (p_node->is_group) {
+		if (p_node->elements == 0) {
+			_node_done(p_node);
+			return;
+		}
+		task_count = p_node->tasks < 0 ? MAX(1, WorkerThreadPool::get_singleton()->get_thread_count()) : MAX(1, p_node->tasks);
+		task_count = MIN(task_count, p_node->elements);
+	}
+	p_node->task_count = task_count;
+	WorkerThreadPool::get_singleton()->_add_detached_native_tasks(&TaskGraph::_node_task, p_node, task_count, high_priority, p_node->description);
+}
+
+void TaskGraph::_node_task(void *p_node) {
+	Node *node = (Node *)p_node;
+
+	if (!node->is_group) {
+		if (node->native_func) {
+			node->native_func(node->native_func_userdata);
+		} else {
+			node->template_userdata->callback();
+		}
+		node->graph->_node_done(node);
+		return;
+	}
+
+	while (true) {
+		uint32_t work_index = node->index.postincrement();
+		if (work_index >= node->elements) {
+			break;
+		}
+		if (node->native_group_func) {
+			node->native_group_func(node->native_func_userdata, work_index);
+		} else {
+			node->template_userdata->callback_indexed(work_index);
+		}
+	}
+
+	// Only the last task to exit goes on. Finishing the last element isn't enough,
+	// since other tasks of the node may still be about to look for more work.
+	if (node->exited_tasks.increment() == node->task_count) {
+		node->graph->_node_done(node);
+	}
+}
+
+void TaskGraph::_node_done(Node *p_node) {
+	for (NodeID successor_id : p_node->successors) {
+		Node *successor = nodes[successor_id];
+		if (successor->pending_dependencies.decrement() == 0) {
+			_post_node(successor);
+		}
+	}
+
+	if (nodes_remaining.decrement() == 0) {
+		// Both kinds of waiters are released under the pool's task_mutex, so a pool thread
+		// can't return from wait() and free the graph before the semaphore is posted.
+		// Nothing can be touched after this, since the waiter may free the graph.
+		WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+		MutexLock lock(pool->task_mutex);
+		completion_task.completed = true;
+		pool->_notify_awaiters(&completion_task);
+		done_semaphore.post();
+	}
+}
+
+Error TaskGraph::submit() {
+	ERR_FAIL_COND_V_MSG(submitted, ERR_BUSY, "Task graph was already submitted and not waited for.");
+	ERR_FAIL_NULL_V(WorkerThreadPool::get_singleton(), ERR_UNCONFIGURED);
+
+	if (nodes.is_empty()) {
+		return OK;
+	}
+
+	for (Node *node : nodes) {
+		node->pending_dependencies.set(node->dependency_count);
+		node->index.set(0);
+		node->exited_tasks.set(0);
+	}
+	completion_task.completed = false;
+	nodes_remaining.set(nodes.size());
+	submitted = true;
+
+	// Collect roots first; once posted, nodes may finish and post others concurrently.
+	Node **roots = (Node **)alloca(sizeof(Node *) * nodes.size());
+	uint32_t root_count = 0;
+	for (Node *node : nodes) {
+		if (node->dependency_count == 0) {
+			roots[root_count++] = node;
+		}
+	}
+	for (uint32_t i = 0; i < root_count; i++) {
+		_post_node(roots[i]);
+	}
+
+	return OK;
+}
+
+void TaskGraph::wait() {
+	if (!submitted) {
+		return;
+	}
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	WorkerThreadPool::ThreadData *caller_pool_thread = pool->_get_caller_pool_thread();
+	if (caller_pool_thread) {
+		// Blocking a pool thread could starve the graph itself, so it runs other tasks meanwhile.
+		pool->_wait_collaboratively(caller_pool_thread, &completion_task);
+		// Already posted by now; consumed so the next run starts from zero.
+		done_semaphore.wait();
+	} else {
+		CommandQueueMT *flushing_cmd_queue = WorkerThreadPool::flushing_cmd_queue;
+		if (flushing_cmd_queue) {
+			flushing_cmd_queue->unlock();
+		}
+		done_semaphore.wait();
+		if (flushing_cmd_queue) {
+			flushing_cmd_queue->lock();
+		}
+	}
+	submitted = false;
+}
+
+void TaskGraph::clear() {
+	ERR_FAIL_COND_MSG(submitted, "Can't clear a task graph while it's submitted.");
+	for (Node *node : nodes) {
+		if (node->template_userdata) {
+			memdelete(node->template_userdata);
+		}
+		memdelete(node);
+	}
+	nodes.clear();
+}
+
+TaskGraph::~TaskGraph() {
+	wait();
+	clear();
+}
@@ -0,0 +1,132 @@
+/**************************************************************************/
+/*  task_graph.h                                                          */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TASK_GRAPH_H
+#define TASK_GRAPH_H
+
+#include "core/object/worker_thread_pool.h"
+
+// A set of tasks with dependencies among them, run on the WorkerThreadPool.
+// A task is started as soon as all the tasks it depends on are done, so
+// multi-phase work doesn't need blocking joins between phases. The graph is
+// meant to be built once and submitted again every time the work is needed
+// (for instance, every frame). It can't be modified while it's submitted.
+
+class TaskGraph {
+public:
+	typedef int32_t NodeID;
+
+	enum {
+		INVALID_NODE_ID = -1
+	};
+
+private:
+	struct Node {
+		TaskGraph *graph = nullptr;
+		void (*native_func)(void *) = nullptr;
+		void (*native_group_func)(void *, uint32_t) = nullptr;
+		void *native_func_userdata = nullptr;
+		WorkerThreadPool::BaseTemplateUserdata *template_userdata = nullptr;
+		String description;
+		bool is_group = false;
+		uint32_t elements = 0;
+		int tasks = -1;
+		uint32_t task_count = 0; // Posted for the current run.
+
+		LocalVector<NodeID> successors;
+		uint32_t dependency_count = 0;
+
+		// Run state.
+		SafeNumeric<uint32_t> pending_dependencies;
+		SafeNumeric<uint32_t> index;
+		SafeNumeric<uint32_t> exited_tasks;
+	};
+
+	LocalVector<Node *> nodes;
+	bool high_priority = true;
+
+	bool submitted = false; // Until waited for.
+	SafeNumeric<uint32_t> nodes_remaining;
+	Semaphore done_semaphore;
+	// Never posted, only marked as completed, so pool threads can wait on the graph as they do on tasks.
+	WorkerThreadPool::Task completion_task;
+
+	NodeID _add_node(void (*p_func)(void *), void (*p_group_func)(void *, uint32_t), void *p_userdata, WorkerThreadPool::BaseTemplateUserdata *p_template_userdata, bool p_is_group, int p_elements, int p_tasks, const String &p_description);
+
+	void _post_node(Node *p_node);
+	void _node_done(Node *p_node);
+	static void _node_task(void *p_node);
+
+public:
+	template <class C, class M, class U>
+	NodeID add_template_task(C *p_instance, M p_method, U p_userdata, const String &p_description = String()) {
+		typedef WorkerThreadPool::TaskUserData<C, M, U> TUD;
+		TUD *ud = memnew(TUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_node(nullptr, nullptr, nullptr, ud, false, 0, 0, p_description);
+	}
+	NodeID add_native_task(void (*p_func)(void *), void *p_userdata, const String &p_description = String());
+
+	template <class C, class M, class U>
+	NodeID add_template_group_task(C *p_instance, M p_method, U p_userdata, int p_elements, int p_tasks = -1, const String &p_description = String()) {
+		typedef WorkerThreadPool::GroupUserData<C, M, U> GroupUD;
+		GroupUD *ud = memnew(GroupUD);
+		ud->instance = p_instance;
+		ud->method = p_method;
+		ud->userdata = p_userdata;
+		return _add_node(nullptr, nullptr, nullptr, ud, true, p_elements, p_tasks, p_description);
+	}
+	NodeID add_native_group_task(void (*p_func)(void *, uint32_t), void *p_userdata, int p_elements, int p_tasks = -1, const String &p_description = String());
+
+	// Makes p_node start only after p_dependency is done.
+	void depends_on(NodeID p_node, NodeID p_dependency);
+	// The element count of group tasks can be changed between runs.
+	void set_group_elements(NodeID p_node, int p_elements);
+	uint32_t get_node_count() const { return nodes.size(); }
+
+	void set_high_priority(bool p_high_priority);
+	bool is_high_priority() const { return high_priority; }
+
+	// Starts running the graph and returns immediately.
+	// wait() must be called before it can be submitted again or modified.
+	Error submit();
+	bool is_submitted() const { return submitted; }
+	bool is_completed() const { return nodes_remaining.get() == 0; }
+	void wait();
+
+	void clear();
+
+	TaskGraph() {}
+	~TaskGraph();
+};
+
+#endif // TASK_GRAPH_H
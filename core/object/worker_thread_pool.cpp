@@ -45,10 +45,12 @@ void WorkerThreadPool::Task::free_template_userdata() {
 WorkerThreadPool *WorkerThreadPool::singleton = nullptr;
 
 thread_local CommandQueueMT *WorkerThreadPool::flushing_cmd_queue = nullptr;
+thread_local WorkerThreadPool::ThreadData *WorkerThreadPool::current_thread_data = nullptr;
 
 void WorkerThreadPool::_process_task(Task *p_task) {
 #ifdef THREADS_ENABLED
 	int pool_thread_index = thread_ids[Thread::get_caller_id()];
+	bool low_priority = p_task->low_priority; // The task may be freed before it's needed below.
 	ThreadData &curr_thread = threads[pool_thread_index];
 	Task *prev_task = nullptr; // In case this is recursively called.
 	bool safe_for_nodes_backup = is_current_thread_safe_for_nodes();
@@ -111,13 +113,17 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 
 		if (finished_users == max_users) {
 			// Get rid of the group, because nobody else is using it.
-			task_mutex.lock();
 			group_allocator.free(p_task->group);
-			task_mutex.unlock();
 		}
 
 		// For groups, tasks get rid of themselves.
 
+		task_mutex.lock();
+		task_allocator.free(p_task);
+	} else if (p_task->detached) {
+		p_task->native_func(p_task->native_func_userdata);
+
+		// Nobody can be waiting for it, so it's freed right away.
 		task_mutex.lock();
 		task_allocator.free(p_task);
 	} else {
@@ -136,20 +142,14 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 		if (p_task->waiting_user) {
 			p_task->done_semaphore.post(p_task->waiting_user);
 		}
-		// Let awaiters know.
-		for (uint32_t i = 0; i < threads.size(); i++) {
-			if (threads[i].awaited_task == p_task) {
-				threads[i].cond_var.notify_one();
-				threads[i].signaled = true;
-			}
-		}
+		_notify_awaiters(p_task);
 	}
 
 #ifdef THREADS_ENABLED
 	{
 		curr_thread.current_task = prev_task;
-		if (p_task->low_priority) {
-			low_priority_threads_used--;
+		if (low_priority) {
+			low_priority_threads_used.decrement();
 
 			if (_try_promote_low_priority_task()) {
 				if (prev_task) { // Otherwise, this thread will catch it.
@@ -167,9 +167,15 @@ void WorkerThreadPool::_process_task(Task *p_task) {
 
 void WorkerThreadPool::_thread_function(void *p_user) {
 	ThreadData *thread_data = (ThreadData *)p_user;
+	current_thread_data = thread_data;
 	while (true) {
 		Task *task_to_process = nullptr;
-		{
+		if (singleton->work_stealing) {
+			// Fast path: own deque first (LIFO), then other threads' (FIFO), without locking.
+			task_to_process = singleton->_pop_or_steal_task(thread_data);
+		}
+
+		if (!task_to_process) {
 			MutexLock lock(singleton->task_mutex);
 			if (singleton->exit_threads) {
 				return;
@@ -179,8 +185,12 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 			if (singleton->task_queue.first()) {
 				task_to_process = singleton->task_queue.first()->self();
 				singleton->task_queue.remove(singleton->task_queue.first());
+			} else if (!singleton->_prepare_to_idle()) {
+				// Lost a race for a stolen task, but there's still work around. Try again.
+				continue;
 			} else {
 				thread_data->cond_var.wait(lock);
+				singleton->idle_threads.decrement();
 				DEV_ASSERT(singleton->exit_threads || thread_data->signaled);
 			}
 		}
@@ -191,31 +201,41 @@ void WorkerThreadPool::_thread_function(void *p_user) {
 	}
 }
 
-void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count, bool p_high_priority) {
+void WorkerThreadPool::_post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority) {
 	// Fall back to processing on the calling thread if there are no worker threads.
 	// Separated into its own variable to make it easier to extend this logic
 	// in custom builds.
 	bool process_on_calling_thread = threads.size() == 0;
 	if (process_on_calling_thread) {
-		task_mutex.unlock();
 		for (uint32_t i = 0; i < p_count; i++) {
 			_process_task(p_tasks[i]);
 		}
 		return;
 	}
 
+	ThreadData *caller_pool_thread = _get_caller_pool_thread();
+
+	// In work-stealing mode, tasks posted from a pool thread go to its own deque, where
+	// it will pick them up and other threads can steal them, all without task_mutex.
+	if (work_stealing && caller_pool_thread) {
+		uint32_t posted = _post_tasks_to_own_queue(caller_pool_thread, p_tasks, p_count, p_high_priority);
+		p_tasks += posted;
+		p_count -= posted;
+		if (p_count == 0) {
+			return;
+		}
+	}
+
+	// Tasks posted from other threads, throttled or overflowing the deque use the shared queues.
 	uint32_t to_process = 0;
 	uint32_t to_promote = 0;
 
-	ThreadData *caller_pool_thread = thread_ids.has(Thread::get_caller_id()) ? &threads[thread_ids[Thread::get_caller_id()]] : nullptr;
+	MutexLock lock(task_mutex);
 
 	for (uint32_t i = 0; i < p_count; i++) {
 		p_tasks[i]->low_priority = !p_high_priority;
-		if (p_high_priority || low_priority_threads_used < max_low_priority_threads) {
+		if (p_high_priority || _try_acquire_low_priority_slot()) {
 			task_queue.add_last(&p_tasks[i]->task_elem);
-			if (!p_high_priority) {
-				low_priority_threads_used++;
-			}
 			to_process++;
 		} else {
 			// Too many threads using low priority, must go to queue.
@@ -225,8 +245,35 @@ void WorkerThreadPool::_post_tasks_and_unlock(Task **p_tasks, uint32_t p_count,
 	}
 
 	_notify_threads(caller_pool_thread, to_process, to_promote);
+}
 
-	task_mutex.unlock();
+uint32_t WorkerThreadPool::_post_tasks_to_own_queue(ThreadData *p_caller_pool_thread, Task **p_tasks, uint32_t p_count, bool p_high_priority) {
+	uint32_t posted = 0;
+	while (posted < p_count) {
+		if (!p_high_priority && !_try_acquire_low_priority_slot()) {
+			break; // Throttled; the rest must wait in the low priority queue.
+		}
+		p_tasks[posted]->low_priority = !p_high_priority;
+		if (!p_caller_pool_thread->work_queue.push(p_tasks[posted])) {
+			if (!p_high_priority) {
+				low_priority_threads_used.decrement();
+			}
+			break;
+		}
+		posted++;
+	}
+
+	if (posted) {
+		// Pairs with the fence in _prepare_to_idle(): either a thread about to wait sees the
+		// new tasks, or this sees it counted as idle and wakes it up.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (idle_threads.get()) {
+			MutexLock lock(task_mutex);
+			_notify_threads(p_caller_pool_thread, posted, 0);
+		}
+	}
+
+	return posted;
 }
 
 void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count) {
@@ -293,47 +340,127 @@ void WorkerThreadPool::_notify_threads(const ThreadData *p_current_thread_data,
 	}
 }
 
+void WorkerThreadPool::_notify_awaiters(Task *p_task) {
+	for (uint32_t i = 0; i < threads.size(); i++) {
+		if (threads[i].awaited_task == p_task) {
+			threads[i].cond_var.notify_one();
+			threads[i].signaled = true;
+		}
+	}
+}
+
 bool WorkerThreadPool::_try_promote_low_priority_task() {
-	if (low_priority_task_queue.first()) {
+	if (low_priority_task_queue.first() && _try_acquire_low_priority_slot()) {
 		Task *low_prio_task = low_priority_task_queue.first()->self();
 		low_priority_task_queue.remove(low_priority_task_queue.first());
 		task_queue.add_last(&low_prio_task->task_elem);
-		low_priority_threads_used++;
 		return true;
 	} else {
 		return false;
 	}
 }
 
+WorkerThreadPool::Task *WorkerThreadPool::_pop_or_steal_task(ThreadData *p_thread_data) {
+	Task *task = p_thread_data->work_queue.pop();
+	if (task) {
+		return task;
+	}
+
+	uint32_t thread_count = threads.size();
+	for (uint32_t i = 1; i < thread_count; i++) {
+		ThreadData &victim = threads[(p_thread_data->index + i) % thread_count];
+		task = victim.work_queue.steal();
+		if (task) {
+			return task;
+		}
+	}
+	return nullptr;
+}
+
+bool WorkerThreadPool::_has_stealable_tasks() const {
+	for (const ThreadData &th : threads) {
+		if (!th.work_queue.is_empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Called with task_mutex held right before a pool thread waits. Returns false, without
+// counting the thread as idle, if there's work in the deques it should look at instead.
+bool WorkerThreadPool::_prepare_to_idle() {
+	idle_threads.increment();
+	if (work_stealing) {
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (_has_stealable_tasks()) {
+			idle_threads.decrement();
+			return false;
+		}
+	}
+	return true;
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::add_native_task(void (*p_func)(void *), void *p_userdata, bool p_high_priority, const String &p_description) {
 	return _add_task(Callable(), p_func, p_userdata, nullptr, p_high_priority, p_description);
 }
 
 WorkerThreadPool::TaskID WorkerThreadPool::_add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description) {
-	task_mutex.lock();
 	// Get a free task
 	Task *task = task_allocator.alloc();
-	TaskID id = last_task++;
+	TaskID id = last_task.postincrement();
 	task->self = id;
 	task->callable = p_callable;
 	task->native_func = p_func;
 	task->native_func_userdata = p_userdata;
 	task->description = p_description;
 	task->template_userdata = p_template_userdata;
-	tasks.insert(id, task);
+	{
+		MutexLock registry_lock(registry_mutex);
+		tasks.insert(id, task);
+	}
 
-	_post_tasks_and_unlock(&task, 1, p_high_priority);
+	_post_tasks(&task, 1, p_high_priority);
 
 	return id;
 }
 
+void WorkerThreadPool::_add_detached_native_tasks(void (*p_func)(void *), void *p_userdata, uint32_t p_count, bool p_high_priority, const String &p_description) {
+	ERR_FAIL_NULL(p_func);
+	if (p_count == 0) {
+		return;
+	}
+
+	Task **tasks_posted = (Task **)alloca(sizeof(Task *) * p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		Task *task = task_allocator.alloc();
+		task->native_func = p_func;
+		task->native_func_userdata = p_userdata;
+		task->description = p_description;
+		task->detached = true;
+		tasks_posted[i] = task;
+		// No task ID is used.
+	}
+
+	_post_tasks(tasks_posted, p_count, p_high_priority);
+}
+
 WorkerThreadPool::TaskID WorkerThreadPool::add_task(const Callable &p_action, bool p_high_priority, const String &p_description) {
 	return _add_task(p_action, nullptr, nullptr, nullptr, p_high_priority, p_description);
 }
 
+// Called with task_mutex held, once nobody is waiting for the task anymore.
+void WorkerThreadPool::_erase_task(TaskID p_task_id, Task *p_task) {
+	registry_mutex.lock();
+	tasks.erase(p_task_id);
+	registry_mutex.unlock();
+	task_allocator.free(p_task);
+}
+
 bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	task_mutex.lock();
+	registry_mutex.lock();
 	const Task *const *taskp = tasks.getptr(p_task_id);
+	registry_mutex.unlock();
 	if (!taskp) {
 		task_mutex.unlock();
 		ERR_FAIL_V_MSG(false, "Invalid Task ID"); // Invalid task
@@ -345,9 +472,80 @@ bool WorkerThreadPool::is_task_completed(TaskID p_task_id) const {
 	return completed;
 }
 
+void WorkerThreadPool::_wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task) {
+	// This is a thread from the pool. It shouldn't just idle.
+	// Let's try to process other tasks while we wait.
+	while (true) {
+		Task *task_to_process = nullptr;
+		{
+			MutexLock lock(task_mutex);
+			bool was_signaled = p_caller_pool_thread->signaled;
+			p_caller_pool_thread->signaled = false;
+
+			if (p_task->completed) {
+				// This thread was awaken also for some reason, but it's about to exit.
+				// Let's find out what may be pending and forward the requests.
+				if (!exit_threads && was_signaled) {
+					uint32_t to_process = (task_queue.first() || (work_stealing && !p_caller_pool_thread->work_queue.is_empty())) ? 1 : 0;
+					uint32_t to_promote = p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
+					if (to_process || to_promote) {
+						// This thread must be left alone since it won't loop again.
+						p_caller_pool_thread->signaled = true;
+						_notify_threads(p_caller_pool_thread, to_process, to_promote);
+					}
+				}
+
+				break;
+			}
+
+			if (!exit_threads) {
+				if (p_caller_pool_thread->current_task->low_priority && low_priority_task_queue.first()) {
+					if (_try_promote_low_priority_task()) {
+						_notify_threads(p_caller_pool_thread, 1, 0);
+					}
+				}
+
+				if (work_stealing) {
+					task_to_process = _pop_or_steal_task(p_caller_pool_thread);
+				}
+
+				if (!task_to_process && singleton->task_queue.first()) {
+					task_to_process = task_queue.first()->self();
+					task_queue.remove(task_queue.first());
+				}
+
+				if (!task_to_process) {
+					if (!_prepare_to_idle()) {
+						continue;
+					}
+					p_caller_pool_thread->awaited_task = p_task;
+
+					if (flushing_cmd_queue) {
+						flushing_cmd_queue->unlock();
+					}
+					p_caller_pool_thread->cond_var.wait(lock);
+					if (flushing_cmd_queue) {
+						flushing_cmd_queue->lock();
+					}
+					idle_threads.decrement();
+
+					DEV_ASSERT(exit_threads || p_caller_pool_thread->signaled || p_task->completed);
+					p_caller_pool_thread->awaited_task = nullptr;
+				}
+			}
+		}
+
+		if (task_to_process) {
+			_process_task(task_to_process);
+		}
+	}
+}
+
 Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	task_mutex.lock();
+	registry_mutex.lock();
 	Task **taskp = tasks.getptr(p_task_id);
+	registry_mutex.unlock();
 	if (!taskp) {
 		task_mutex.unlock();
 		ERR_FAIL_V_MSG(ERR_INVALID_PARAMETER, "Invalid Task ID"); // Invalid task
@@ -356,8 +554,7 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 
 	if (task->completed) {
 		if (task->waiting_pool == 0 && task->waiting_user == 0) {
-			tasks.erase(p_task_id);
-			task_allocator.free(task);
+			_erase_task(p_task_id, task);
 		}
 		task_mutex.unlock();
 		return OK;
@@ -389,78 +586,20 @@ Error WorkerThreadPool::wait_for_task_completion(TaskID p_task_id) {
 	task_mutex.unlock();
 
 	if (caller_pool_thread) {
-		while (true) {
-			Task *task_to_process = nullptr;
-			{
-				MutexLock lock(task_mutex);
-				bool was_signaled = caller_pool_thread->signaled;
-				caller_pool_thread->signaled = false;
-
-				if (task->completed) {
-					// This thread was awaken also for some reason, but it's about to exit.
-					// Let's find out what may be pending and forward the requests.
-					if (!exit_threads && was_signaled) {
-						uint32_t to_process = task_queue.first() ? 1 : 0;
-						uint32_t to_promote = caller_pool_thread->current_task->low_priority && low_priority_task_queue.first() ? 1 : 0;
-						if (to_process || to_promote) {
-							// This thread must be left alone since it won't loop again.
-							caller_pool_thread->signaled = true;
-							_notify_threads(caller_pool_thread, to_process, to_promote);
-						}
-					}
-
-					task->waiting_pool--;
-					if (task->waiting_pool == 0 && task->waiting_user == 0) {
-						tasks.erase(p_task_id);
-						task_allocator.free(task);
-					}
-
-					break;
-				}
+		_wait_collaboratively(caller_pool_thread, task);
 
-				if (!exit_threads) {
-					// This is a thread from the pool. It shouldn't just idle.
-					// Let's try to process other tasks while we wait.
-
-					if (caller_pool_thread->current_task->low_priority && low_priority_task_queue.first()) {
-						if (_try_promote_low_priority_task()) {
-							_notify_threads(caller_pool_thread, 1, 0);
-						}
-					}
-
-					if (singleton->task_queue.first()) {
-						task_to_process = task_queue.first()->self();
-						task_queue.remove(task_queue.first());
-					}
-
-					if (!task_to_process) {
-						caller_pool_thread->awaited_task = task;
-
-						if (flushing_cmd_queue) {
-							flushing_cmd_queue->unlock();
-						}
-						caller_pool_thread->cond_var.wait(lock);
-						if (flushing_cmd_queue) {
-							flushing_cmd_queue->lock();
-						}
-
-						DEV_ASSERT(exit_threads || caller_pool_thread->signaled || task->completed);
-						caller_pool_thread->awaited_task = nullptr;
-					}
-				}
-			}
-
-			if (task_to_process) {
-				_process_task(task_to_process);
-			}
+		task_mutex.lock();
+		task->waiting_pool--;
+		if (task->waiting_pool == 0 && task->waiting_user == 0) {
+			_erase_task(p_task_id, task);
 		}
+		task_mutex.unlock();
 	} else {
 		task->done_semaphore.wait();
 		task_mutex.lock();
 		task->waiting_user--;
 		if (task->waiting_pool == 0 && task->waiting_user == 0) {
-			tasks.erase(p_task_id);
-			task_allocator.free(task);
+			_erase_task(p_task_id, task);
 		}
 		task_mutex.unlock();
 	}
@@ -474,9 +613,8 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 		p_tasks = MAX(1u, threads.size());
 	}
 
-	task_mutex.lock();
 	Group *group = group_allocator.alloc();
-	GroupID id = last_task++;
+	GroupID id = last_task.postincrement();
 	group->max = p_elements;
 	group->self = id;
 
@@ -507,9 +645,12 @@ WorkerThreadPool::GroupID WorkerThreadPool::_add_group_task(const Callable &p_ca
 		}
 	}
 
-	groups[id] = group;
+	{
+		MutexLock registry_lock(registry_mutex);
+		groups[id] = group;
+	}
 
-	_post_tasks_and_unlock(tasks_posted, p_tasks, p_high_priority);
+	_post_tasks(tasks_posted, p_tasks, p_high_priority);
 
 	return id;
 }
@@ -523,39 +664,39 @@ WorkerThreadPool::GroupID WorkerThreadPool::add_group_task(const Callable &p_act
 }
 
 uint32_t WorkerThreadPool::get_group_processed_element_count(GroupID p_group) const {
-	task_mutex.lock();
+	registry_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
 	if (!groupp) {
-		task_mutex.unlock();
+		registry_mutex.unlock();
 		ERR_FAIL_V_MSG(0, "Invalid Group ID");
 	}
 	uint32_t elements = (*groupp)->completed_index.get();
-	task_mutex.unlock();
+	registry_mutex.unlock();
 	return elements;
 }
 bool WorkerThreadPool::is_group_task_completed(GroupID p_group) const {
-	task_mutex.lock();
+	registry_mutex.lock();
 	const Group *const *groupp = groups.getptr(p_group);
 	if (!groupp) {
-		task_mutex.unlock();
+		registry_mutex.unlock();
 		ERR_FAIL_V_MSG(false, "Invalid Group ID");
 	}
 	bool completed = (*groupp)->completed.is_set();
-	task_mutex.unlock();
+	registry_mutex.unlock();
 	return completed;
 }
 
 void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 #ifdef THREADS_ENABLED
-	task_mutex.lock();
+	registry_mutex.lock();
 	Group **groupp = groups.getptr(p_group);
-	task_mutex.unlock();
-	if (!groupp) {
+	Group *group = groupp ? *groupp : nullptr;
+	registry_mutex.unlock();
+	if (!group) {
 		ERR_FAIL_MSG("Invalid Group ID.");
 	}
 
 	{
-		Group *group = *groupp;
 
 		if (flushing_cmd_queue) {
 			flushing_cmd_queue->unlock();
@@ -570,15 +711,13 @@ void WorkerThreadPool::wait_for_group_task_completion(GroupID p_group) {
 
 		if (finished_users == max_users) {
 			// All tasks using this group are gone (finished before the group), so clear the group too.
-			task_mutex.lock();
 			group_allocator.free(group);
-			task_mutex.unlock();
 		}
 	}
 
-	task_mutex.lock(); // This mutex is needed when Physics 2D and/or 3D is selected to run on a separate thread.
+	registry_mutex.lock(); // This mutex is needed when Physics 2D and/or 3D is selected to run on a separate thread.
 	groups.erase(p_group);
-	task_mutex.unlock();
+	registry_mutex.unlock();
 #endif
 }
 
@@ -597,18 +736,26 @@ void WorkerThreadPool::thread_exit_command_queue_mt_flush() {
 	flushing_cmd_queue = nullptr;
 }
 
-void WorkerThreadPool::init(int p_thread_count, float p_low_priority_task_ratio) {
+void WorkerThreadPool::init(int p_thread_count, float p_low_priority_task_ratio, bool p_work_stealing) {
 	ERR_FAIL_COND(threads.size() > 0);
 	if (p_thread_count < 0) {
 		p_thread_count = OS::get_singleton()->get_default_thread_pool_size();
 	}
 
+	low_priority_task_ratio = p_low_priority_task_ratio;
 	max_low_priority_threads = CLAMP(p_thread_count * p_low_priority_task_ratio, 1, p_thread_count - 1);
+	work_stealing = p_work_stealing && p_thread_count > 1;
 
 	threads.resize(p_thread_count);
 
 	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].index = i;
+		if (work_stealing) {
+			threads[i].work_queue.setup(WORK_STEALING_DEQUE_SIZE);
+		}
+	}
+
+	for (uint32_t i = 0; i < threads.size(); i++) {
 		threads[i].thread.start(&WorkerThreadPool::_thread_function, &threads[i]);
 		thread_ids.insert(threads[i].thread.get_id(), i);
 	}
@@ -641,12 +788,18 @@ void WorkerThreadPool::finish() {
 
 	{
 		MutexLock lock(task_mutex);
+		MutexLock registry_lock(registry_mutex);
 		for (KeyValue<TaskID, Task *> &E : tasks) {
 			task_allocator.free(E.value);
 		}
+		tasks.clear();
 	}
 
 	threads.clear();
+	thread_ids.clear();
+	low_priority_threads_used.set(0);
+	exit_threads = false;
+	work_stealing = false;
 }
 
 void WorkerThreadPool::_bind_methods() {
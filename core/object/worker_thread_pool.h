@@ -40,11 +40,16 @@
 #include "core/templates/paged_allocator.h"
 #include "core/templates/rid.h"
 #include "core/templates/safe_refcount.h"
+#include "core/templates/work_stealing_deque.h"
 
 class CommandQueueMT;
+class TaskGraph;
 
 class WorkerThreadPool : public Object {
 	GDCLASS(WorkerThreadPool, Object)
+
+	friend class TaskGraph;
+
 public:
 	enum {
 		INVALID_TASK_ID = -1
@@ -87,6 +92,7 @@ private:
 		uint32_t waiting_pool = 0;
 		uint32_t waiting_user = 0;
 		bool low_priority = false;
+		bool detached = false; // Not tracked by ID; freed as soon as it's done.
 		BaseTemplateUserdata *template_userdata = nullptr;
 		int pool_thread_index = -1;
 
@@ -97,14 +103,17 @@ private:
 
 	static const uint32_t TASKS_PAGE_SIZE = 1024;
 	static const uint32_t GROUPS_PAGE_SIZE = 256;
+	static const uint32_t WORK_STEALING_DEQUE_SIZE = 1024;
 
-	PagedAllocator<Task, false, TASKS_PAGE_SIZE> task_allocator;
-	PagedAllocator<Group, false, GROUPS_PAGE_SIZE> group_allocator;
+	// Thread-safe on their own, so tasks can be posted from pool threads without task_mutex.
+	PagedAllocator<Task, true, TASKS_PAGE_SIZE> task_allocator;
+	PagedAllocator<Group, true, GROUPS_PAGE_SIZE> group_allocator;
 
 	SelfList<Task>::List low_priority_task_queue;
 	SelfList<Task>::List task_queue;
 
 	BinaryMutex task_mutex;
+	BinaryMutex registry_mutex; // Guards tasks and groups. If both are needed, task_mutex goes first.
 
 	struct ThreadData {
 		uint32_t index = 0;
@@ -114,10 +123,12 @@ private:
 		Task *current_task = nullptr;
 		Task *awaited_task = nullptr; // Null if not awaiting the condition variable. Special value for idle-waiting.
 		ConditionVariable cond_var;
+		WorkStealingDeque<Task> work_queue; // Only used in work-stealing mode.
 	};
 
 	TightLocalVector<ThreadData> threads;
 	bool exit_threads = false;
+	bool work_stealing = false;
 
 	HashMap<Thread::ID, int> thread_ids;
 	HashMap<
@@ -135,25 +146,50 @@ private:
 			PagedAllocator<HashMapElement<GroupID, Group *>, false, GROUPS_PAGE_SIZE>>
 			groups;
 
+	float low_priority_task_ratio = 0.3;
 	uint32_t max_low_priority_threads = 0;
-	uint32_t low_priority_threads_used = 0;
+	SafeNumeric<uint32_t> low_priority_threads_used;
+	SafeNumeric<uint32_t> idle_threads; // Pool threads about to wait, or waiting, on their condition variable.
 	uint32_t notify_index = 0; // For rotating across threads, no help distributing load.
 
-	uint64_t last_task = 1;
+	SafeNumeric<uint64_t> last_task{ 1 };
 
 	static void _thread_function(void *p_user);
 
 	void _process_task(Task *task);
+	void _erase_task(TaskID p_task_id, Task *p_task);
 
-	void _post_tasks_and_unlock(Task **p_tasks, uint32_t p_count, bool p_high_priority);
+	void _post_tasks(Task **p_tasks, uint32_t p_count, bool p_high_priority);
+	uint32_t _post_tasks_to_own_queue(ThreadData *p_caller_pool_thread, Task **p_tasks, uint32_t p_count, bool p_high_priority);
 	void _notify_threads(const ThreadData *p_current_thread_data, uint32_t p_process_count, uint32_t p_promote_count);
+	void _notify_awaiters(Task *p_task);
 
 	bool _try_promote_low_priority_task();
+	_FORCE_INLINE_ bool _try_acquire_low_priority_slot() {
+		return low_priority_threads_used.increment_if_less(max_low_priority_threads);
+	}
+
+	Task *_pop_or_steal_task(ThreadData *p_thread_data);
+	bool _has_stealable_tasks() const;
+	bool _prepare_to_idle();
+	// Runs other tasks on a pool thread until p_task is completed.
+	void _wait_collaboratively(ThreadData *p_caller_pool_thread, Task *p_task);
+
+	// Only valid if the calling thread belongs to this pool; it's set when the thread starts,
+	// so callers can be identified without locking or looking up thread_ids.
+	static thread_local ThreadData *current_thread_data;
+	_FORCE_INLINE_ ThreadData *_get_caller_pool_thread() {
+		ThreadData *thread_data = current_thread_data;
+		return (thread_data && thread_data >= threads.ptr() && thread_data < threads.ptr() + threads.size()) ? thread_data : nullptr;
+	}
 
 	static WorkerThreadPool *singleton;
 
 	static thread_local CommandQueueMT *flushing_cmd_queue;
 
+	// For TaskGraph, which tracks completion on its own.
+	void _add_detached_native_tasks(void (*p_func)(void *), void *p_userdata, uint32_t p_count, bool p_high_priority, const String &p_description);
+
 	TaskID _add_task(const Callable &p_callable, void (*p_func)(void *), void *p_userdata, BaseTemplateUserdata *p_template_userdata, bool p_high_priority, const String &p_description);
 	GroupID _add_group_task(const Callable &p_callable, void (*p_func)(void *, uint32_t), void *p_userdata, BaseTemplateUserdata *p_template_userdata, int p_elements, int p_tasks, bool p_high_priority, const String &p_description);
 
@@ -212,6 +248,8 @@ public:
 	void wait_for_group_task_completion(GroupID p_group);
 
 	_FORCE_INLINE_ int get_thread_count() const { return threads.size(); }
+	_FORCE_INLINE_ bool is_work_stealing() const { return work_stealing; }
+	_FORCE_INLINE_ float get_low_priority_task_ratio() const { return low_priority_task_ratio; }
 
 	static WorkerThreadPool *get_singleton() { return singleton; }
 	static int get_thread_index();
@@ -219,7 +257,7 @@ public:
 	static void thread_enter_command_queue_mt_flush(CommandQueueMT *p_queue);
 	static void thread_exit_command_queue_mt_flush();
 
-	void init(int p_thread_count = -1, float p_low_priority_task_ratio = 0.3);
+	void init(int p_thread_count = -1, float p_low_priority_task_ratio = 0.3, bool p_work_stealing = false);
 	void finish();
 	WorkerThreadPool();
 	~WorkerThreadPool();
@@ -33,8 +33,13 @@
 #include "core/error/error_macros.h"
 #include "core/templates/safe_refcount.h"
 
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+#include "core/os/size_class_allocator.h"
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 void *operator new(size_t p_size, const char *p_description) {
 	return Memory::alloc_static(p_size, false);
@@ -65,6 +70,50 @@ SafeNumeric<uint64_t> Memory::max_usage;
 
 SafeNumeric<uint64_t> Memory::alloc_count;
 
+static _FORCE_INLINE_ void *_system_alloc(size_t p_bytes) {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	if (p_bytes <= SizeClassAllocator::MAX_SIZE) {
+		void *mem = SizeClassAllocator::alloc(p_bytes);
+		if (likely(mem)) {
+			return mem;
+		}
+	}
+#endif
+	return malloc(p_bytes);
+}
+
+static _FORCE_INLINE_ void *_system_realloc(void *p_memory, size_t p_bytes) {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	if (SizeClassAllocator::owns(p_memory)) {
+		if (p_bytes == 0) {
+			SizeClassAllocator::free(p_memory);
+			return nullptr;
+		}
+		const size_t block_size = SizeClassAllocator::get_block_size(p_memory);
+		if (p_bytes <= block_size) {
+			return p_memory;
+		}
+		void *mem = _system_alloc(p_bytes);
+		if (mem) {
+			memcpy(mem, p_memory, block_size);
+			SizeClassAllocator::free(p_memory);
+		}
+		return mem;
+	}
+#endif
+	return realloc(p_memory, p_bytes);
+}
+
+static _FORCE_INLINE_ void _system_free(void *p_memory) {
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	if (SizeClassAllocator::owns(p_memory)) {
+		SizeClassAllocator::free(p_memory);
+		return;
+	}
+#endif
+	free(p_memory);
+}
+
 void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 #ifdef DEBUG_ENABLED
 	bool prepad = true;
@@ -72,7 +121,7 @@ void *Memory::alloc_static(size_t p_bytes, bool p_pad_align) {
 	bool prepad = p_pad_align;
 #endif
 
-	void *mem = malloc(p_bytes + (prepad ? DATA_OFFSET : 0));
+	void *mem = _system_alloc(p_bytes + (prepad ? DATA_OFFSET : 0));
 
 	ERR_FAIL_NULL_V(mem, nullptr);
 
@@ -121,12 +170,12 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 #endif
 
 		if (p_bytes == 0) {
-			free(mem);
+			_system_free(mem);
 			return nullptr;
 		} else {
 			*s = p_bytes;
 
-			mem = (uint8_t *)realloc(mem, p_bytes + DATA_OFFSET);
+			mem = (uint8_t *)_system_realloc(mem, p_bytes + DATA_OFFSET);
 			ERR_FAIL_NULL_V(mem, nullptr);
 
 			s = (uint64_t *)(mem + SIZE_OFFSET);
@@ -136,7 +185,7 @@ void *Memory::realloc_static(void *p_memory, size_t p_bytes, bool p_pad_align) {
 			return mem + DATA_OFFSET;
 		}
 	} else {
-		mem = (uint8_t *)realloc(mem, p_bytes);
+		mem = (uint8_t *)_system_realloc(mem, p_bytes);
 
 		ERR_FAIL_COND_V(mem == nullptr && p_bytes > 0, nullptr);
 
@@ -165,9 +214,9 @@ void Memory::free_static(void *p_ptr, bool p_pad_align) {
 		mem_usage.sub(*s);
 #endif
 
-		free(mem);
+		_system_free(mem);
 	} else {
-		free(mem);
+		_system_free(mem);
 	}
 }
 
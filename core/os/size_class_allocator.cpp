@@ -0,0 +1,322 @@
+/**************************************************************************/
+/*  size_class_allocator.cpp                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "size_class_allocator.h"
+
+#include "core/error/error_macros.h"
+#include "core/os/spin_lock.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+// Spans are aligned to their size, so the span of any block is found by masking its address.
+// A two-level page map, indexed by span number, stores the size class of every span (plus one, zero means not ours),
+// covering 48-bit address spaces.
+static constexpr uint32_t SPAN_SHIFT = 16;
+static constexpr size_t SPAN_SIZE = size_t(1) << SPAN_SHIFT;
+static constexpr uint32_t CHUNK_SPANS = 16;
+static constexpr uint32_t PAGE_MAP_LEAF_BITS = 16;
+static constexpr uint32_t PAGE_MAP_LEAF_SIZE = 1 << PAGE_MAP_LEAF_BITS;
+static constexpr uint32_t PAGE_MAP_ROOT_SIZE = 1 << 16;
+
+// Blocks a thread keeps per size class, and how many it moves from or to the shared lists at once.
+static constexpr uint32_t THREAD_CACHE_MAX_BLOCKS = 64;
+static constexpr uint32_t THREAD_CACHE_BATCH_BLOCKS = 32;
+
+static const size_t size_classes[SizeClassAllocator::SIZE_CLASS_COUNT] = { 16, 32, 48, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 448, 512 };
+
+static std::atomic<uint8_t *> page_map[PAGE_MAP_ROOT_SIZE];
+
+static SpinLock span_lock;
+static uint8_t *chunk_next = nullptr;
+static uint8_t *chunk_end = nullptr;
+
+struct alignas(64) CentralList {
+	SpinLock lock;
+	void *head = nullptr;
+};
+
+struct alignas(64) SizeClassStats {
+	std::atomic<uint64_t> usage;
+	std::atomic<uint64_t> reserved;
+};
+
+static CentralList central_lists[SizeClassAllocator::SIZE_CLASS_COUNT];
+static SizeClassStats size_class_stats[SizeClassAllocator::SIZE_CLASS_COUNT];
+
+struct ThreadCache {
+	struct List {
+		void *head = nullptr;
+		uint32_t count = 0;
+	};
+
+	List lists[SizeClassAllocator::SIZE_CLASS_COUNT];
+
+	~ThreadCache();
+};
+
+static thread_local ThreadCache thread_cache;
+// Frees can still happen after the cache of the thread was destroyed, they go to the shared lists then.
+static thread_local bool thread_cache_released = false;
+
+static _FORCE_INLINE_ void *&_next_block(void *p_block) {
+	return *(void **)p_block;
+}
+
+static _FORCE_INLINE_ uint32_t _get_size_class(size_t p_bytes) {
+	if (p_bytes <= 128) {
+		return p_bytes == 0 ? 0 : (p_bytes - 1) / 16;
+	}
+	uint32_t size_class = 8;
+	while (size_classes[size_class] < p_bytes) {
+		size_class++;
+	}
+	return size_class;
+}
+
+static _FORCE_INLINE_ uint8_t _get_span_entry(const void *p_ptr) {
+	const uintptr_t span_index = (uintptr_t)p_ptr >> SPAN_SHIFT;
+	const uintptr_t root_index = span_index >> PAGE_MAP_LEAF_BITS;
+	if (root_index >= PAGE_MAP_ROOT_SIZE) {
+		return 0;
+	}
+	const uint8_t *leaf = page_map[root_index].load(std::memory_order_acquire);
+	return leaf ? leaf[span_index & (PAGE_MAP_LEAF_SIZE - 1)] : 0;
+}
+
+static uint8_t *_reserve_span(uint32_t p_size_class) {
+	span_lock.lock();
+
+	if (chunk_next == chunk_end) {
+		// Chunks are never released, so spans never overlap memory handed out by the system allocator.
+		uint8_t *chunk = (uint8_t *)malloc(SPAN_SIZE * (CHUNK_SPANS + 1));
+		if (!chunk) {
+			span_lock.unlock();
+			return nullptr;
+		}
+		chunk_next = (uint8_t *)(((uintptr_t)chunk + SPAN_SIZE - 1) & ~(uintptr_t)(SPAN_SIZE - 1));
+		chunk_end = chunk_next + SPAN_SIZE * CHUNK_SPANS;
+	}
+
+	const uintptr_t span_index = (uintptr_t)chunk_next >> SPAN_SHIFT;
+	const uintptr_t root_index = span_index >> PAGE_MAP_LEAF_BITS;
+	if (root_index >= PAGE_MAP_ROOT_SIZE) {
+		span_lock.unlock();
+		return nullptr;
+	}
+
+	uint8_t *leaf = page_map[root_index].load(std::memory_order_relaxed);
+	if (!leaf) {
+		leaf = (uint8_t *)calloc(PAGE_MAP_LEAF_SIZE, 1);
+		if (!leaf) {
+			span_lock.unlock();
+			return nullptr;
+		}
+		page_map[root_index].store(leaf, std::memory_order_release);
+	}
+	leaf[span_index & (PAGE_MAP_LEAF_SIZE - 1)] = p_size_class + 1;
+
+	uint8_t *span = chunk_next;
+	chunk_next += SPAN_SIZE;
+	span_lock.unlock();
+
+	size_class_stats[p_size_class].reserved.fetch_add(SPAN_SIZE, std::memory_order_relaxed);
+	return span;
+}
+
+// Takes up to p_max_blocks blocks from the shared list of the size class, reserving a new span if it is empty.
+// Returns the number of blocks linked from r_head.
+static uint32_t _take_blocks(uint32_t p_size_class, uint32_t p_max_blocks, void *&r_head) {
+	CentralList &central_list = central_lists[p_size_class];
+
+	central_list.lock.lock();
+	if (central_list.head) {
+		void *head = central_list.head;
+		void *tail = head;
+		uint32_t count = 1;
+		while (count < p_max_blocks && _next_block(tail)) {
+			tail = _next_block(tail);
+			count++;
+		}
+		central_list.head = _next_block(tail);
+		central_list.lock.unlock();
+
+		_next_block(tail) = nullptr;
+		r_head = head;
+		return count;
+	}
+	central_list.lock.unlock();
+
+	uint8_t *span = _reserve_span(p_size_class);
+	if (!span) {
+		r_head = nullptr;
+		return 0;
+	}
+
+	const size_t block_size = size_classes[p_size_class];
+	const uint32_t block_count = SPAN_SIZE / block_size;
+	for (uint32_t i = 0; i < block_count; i++) {
+		_next_block(span + i * block_size) = i + 1 < block_count ? span + (i + 1) * block_size : nullptr;
+	}
+
+	// Keep what was asked for, the rest of the span goes to the shared list.
+	const uint32_t count = MIN(p_max_blocks, block_count);
+	if (count < block_count) {
+		void *tail = span + (count - 1) * block_size;
+		void *rest = _next_block(tail);
+		void *rest_tail = span + (block_count - 1) * block_size;
+		_next_block(tail) = nullptr;
+
+		central_list.lock.lock();
+		_next_block(rest_tail) = central_list.head;
+		central_list.head = rest;
+		central_list.lock.unlock();
+	}
+
+	r_head = span;
+	return count;
+}
+
+static void _give_blocks(uint32_t p_size_class, void *p_head, void *p_tail) {
+	CentralList &central_list = central_lists[p_size_class];
+	central_list.lock.lock();
+	_next_block(p_tail) = central_list.head;
+	central_list.head = p_head;
+	central_list.lock.unlock();
+}
+
+ThreadCache::~ThreadCache() {
+	thread_cache_released = true;
+	for (uint32_t i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		List &list = lists[i];
+		if (!list.head) {
+			continue;
+		}
+		void *tail = list.head;
+		while (_next_block(tail)) {
+			tail = _next_block(tail);
+		}
+		_give_blocks(i, list.head, tail);
+		list.head = nullptr;
+		list.count = 0;
+	}
+}
+
+void *SizeClassAllocator::alloc(size_t p_bytes) {
+	const uint32_t size_class = _get_size_class(p_bytes);
+
+	void *block = nullptr;
+	if (likely(!thread_cache_released)) {
+		ThreadCache::List &list = thread_cache.lists[size_class];
+		if (unlikely(!list.head)) {
+			list.count = _take_blocks(size_class, THREAD_CACHE_BATCH_BLOCKS, list.head);
+			if (!list.head) {
+				return nullptr;
+			}
+		}
+		block = list.head;
+		list.head = _next_block(block);
+		list.count--;
+	} else {
+		if (_take_blocks(size_class, 1, block) == 0) {
+			return nullptr;
+		}
+	}
+
+	size_class_stats[size_class].usage.fetch_add(size_classes[size_class], std::memory_order_relaxed);
+	return block;
+}
+
+void SizeClassAllocator::free(void *p_ptr) {
+	const uint32_t size_class = _get_span_entry(p_ptr) - 1;
+	size_class_stats[size_class].usage.fetch_sub(size_classes[size_class], std::memory_order_relaxed);
+
+	if (unlikely(thread_cache_released)) {
+		_give_blocks(size_class, p_ptr, p_ptr);
+		return;
+	}
+
+	ThreadCache::List &list = thread_cache.lists[size_class];
+	_next_block(p_ptr) = list.head;
+	list.head = p_ptr;
+	list.count++;
+
+	if (unlikely(list.count > THREAD_CACHE_MAX_BLOCKS)) {
+		// Hand a batch back, so blocks freed by one thread can be reused by the others.
+		void *head = list.head;
+		void *tail = head;
+		for (uint32_t i = 1; i < THREAD_CACHE_BATCH_BLOCKS; i++) {
+			tail = _next_block(tail);
+		}
+		list.head = _next_block(tail);
+		list.count -= THREAD_CACHE_BATCH_BLOCKS;
+		_give_blocks(size_class, head, tail);
+	}
+}
+
+bool SizeClassAllocator::owns(const void *p_ptr) {
+	return _get_span_entry(p_ptr) != 0;
+}
+
+size_t SizeClassAllocator::get_block_size(const void *p_ptr) {
+	return size_classes[_get_span_entry(p_ptr) - 1];
+}
+
+size_t SizeClassAllocator::get_size_class_size(uint32_t p_size_class) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_size_class, SIZE_CLASS_COUNT, 0);
+	return size_classes[p_size_class];
+}
+
+uint64_t SizeClassAllocator::get_size_class_usage(uint32_t p_size_class) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_size_class, SIZE_CLASS_COUNT, 0);
+	return size_class_stats[p_size_class].usage.load(std::memory_order_relaxed);
+}
+
+uint64_t SizeClassAllocator::get_size_class_reserved(uint32_t p_size_class) {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_size_class, SIZE_CLASS_COUNT, 0);
+	return size_class_stats[p_size_class].reserved.load(std::memory_order_relaxed);
+}
+
+uint64_t SizeClassAllocator::get_usage() {
+	uint64_t usage = 0;
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		usage += size_class_stats[i].usage.load(std::memory_order_relaxed);
+	}
+	return usage;
+}
+
+uint64_t SizeClassAllocator::get_reserved() {
+	uint64_t reserved = 0;
+	for (uint32_t i = 0; i < SIZE_CLASS_COUNT; i++) {
+		reserved += size_class_stats[i].reserved.load(std::memory_order_relaxed);
+	}
+	return reserved;
+}
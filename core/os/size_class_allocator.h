@@ -0,0 +1,60 @@
+/**************************************************************************/
+/*  size_class_allocator.h                                                */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef SIZE_CLASS_ALLOCATOR_H
+#define SIZE_CLASS_ALLOCATOR_H
+
+#include "core/typedefs.h"
+
+#include <stddef.h>
+
+// Serves small allocations from size classes carved out of 64 KiB spans. Each thread keeps a short
+// list of free blocks per size class, so most allocations and frees don't take any lock.
+// Memory routes small requests here when built with SIZE_CLASS_ALLOCATOR_ENABLED (`size_class_allocator=yes`).
+class SizeClassAllocator {
+public:
+	static constexpr uint32_t SIZE_CLASS_COUNT = 16;
+	static constexpr size_t MAX_SIZE = 512;
+
+	// Returns nullptr if no span could be reserved, the caller should fall back to the system allocator.
+	static void *alloc(size_t p_bytes);
+	static void free(void *p_ptr);
+
+	static bool owns(const void *p_ptr);
+	static size_t get_block_size(const void *p_ptr);
+
+	static size_t get_size_class_size(uint32_t p_size_class);
+	static uint64_t get_size_class_usage(uint32_t p_size_class);
+	static uint64_t get_size_class_reserved(uint32_t p_size_class);
+	static uint64_t get_usage();
+	static uint64_t get_reserved();
+};
+
+#endif // SIZE_CLASS_ALLOCATOR_H
@@ -48,7 +48,10 @@ class StringName {
 	enum {
 		STRING_TABLE_BITS = 16,
 		STRING_TABLE_LEN = 1 << STRING_TABLE_BITS,
-		STRING_TABLE_MASK = STRING_TABLE_LEN - 1
+		STRING_TABLE_MASK = STRING_TABLE_LEN - 1,
+		STRING_TABLE_SHARD_BITS = 6,
+		STRING_TABLE_SHARDS = 1 << STRING_TABLE_SHARD_BITS,
+		STRING_TABLE_SHARD_MASK = STRING_TABLE_SHARDS - 1
 	};
 
 	struct _Data {
@@ -75,7 +78,18 @@ class StringName {
 	friend void register_core_types();
 	friend void unregister_core_types();
 	friend class Main;
-	static Mutex mutex;
+	static Mutex mutex; // Guards unique class name assignment and cleanup.
+
+	// Each bucket of the table is guarded by the lock of its shard, so threads interning unrelated names rarely contend.
+	struct alignas(64) Shard {
+		Mutex mutex;
+	};
+	static Shard shards[STRING_TABLE_SHARDS];
+
+	_FORCE_INLINE_ static Mutex &_get_bucket_mutex(uint32_t p_idx) {
+		return shards[p_idx & STRING_TABLE_SHARD_MASK].mutex;
+	}
+
 	static void setup();
 	static void cleanup();
 	static bool configured;
@@ -0,0 +1,543 @@
+/**************************************************************************/
+/*  flat_hash_map.h                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/pair.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLAT_HASH_MAP_USE_SSE2
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+/**
+ * An unordered hash map using open addressing in the style of a "Swiss table".
+ *
+ * Slots are split in groups of 16. Each slot has a control byte, holding 7 bits
+ * of the key hash for used slots, or marking it as empty or deleted. Lookups
+ * compare a whole group of control bytes at once (with SSE2 where available) and
+ * only compare keys for the slots whose bits match, so a lookup usually touches a
+ * single group and a single key.
+ *
+ * Unlike HashMap, elements are stored inline without a per-element allocation
+ * and no insertion order is kept. Use it for lookup tables whose iteration order
+ * doesn't matter.
+ *
+ * Inserting may move elements around, invalidating pointers and iterators.
+ * Erasing leaves the other elements in place. Like LocalVector, elements are
+ * relocated with memcpy when growing.
+ */
+
+struct FlatHashMapGroup {
+	static constexpr uint32_t SIZE = 16;
+	static constexpr int8_t CTRL_EMPTY = -128;
+	static constexpr int8_t CTRL_DELETED = -2;
+
+#ifdef FLAT_HASH_MAP_USE_SSE2
+	__m128i ctrl;
+
+	_FORCE_INLINE_ explicit FlatHashMapGroup(const int8_t *p_ctrl) {
+		ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p_ctrl));
+	}
+
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(p_h2), ctrl));
+	}
+
+	_FORCE_INLINE_ uint32_t match_empty() const {
+		return match(CTRL_EMPTY);
+	}
+
+	// Empty and deleted control bytes are the only ones with the sign bit set.
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		return (uint32_t)_mm_movemask_epi8(ctrl);
+	}
+#else
+	// Portable version, working on 8 control bytes at a time.
+	static constexpr uint64_t LSBS = 0x0101010101010101ull;
+	static constexpr uint64_t MSBS = 0x8080808080808080ull;
+
+	uint64_t ctrl_low;
+	uint64_t ctrl_high;
+
+	_FORCE_INLINE_ explicit FlatHashMapGroup(const int8_t *p_ctrl) {
+		memcpy(&ctrl_low, p_ctrl, sizeof(uint64_t));
+		memcpy(&ctrl_high, p_ctrl + sizeof(uint64_t), sizeof(uint64_t));
+#ifdef BIG_ENDIAN_ENABLED
+		ctrl_low = BSWAP64(ctrl_low);
+		ctrl_high = BSWAP64(ctrl_high);
+#endif
+	}
+
+	// Gathers the most significant bit of each byte into one bit per byte.
+	static _FORCE_INLINE_ uint32_t _gather(uint64_t p_msbs) {
+		return uint32_t(((p_msbs >> 7) * 0x0102040810204080ull) >> 56);
+	}
+
+	static _FORCE_INLINE_ uint64_t _match_word(uint64_t p_word, int8_t p_h2) {
+		// Can report a false positive for a byte following a match, which is harmless
+		// since keys are compared anyway, and those bytes always belong to used slots.
+		const uint64_t x = p_word ^ (LSBS * (uint8_t)p_h2);
+		return (x - LSBS) & ~x & MSBS;
+	}
+
+	_FORCE_INLINE_ uint32_t match(int8_t p_h2) const {
+		return _gather(_match_word(ctrl_low, p_h2)) | (_gather(_match_word(ctrl_high, p_h2)) << 8);
+	}
+
+	_FORCE_INLINE_ uint32_t match_empty() const {
+		// Empty is the only control byte with the high bit set and bit 1 unset.
+		return _gather(ctrl_low & ~(ctrl_low << 6) & MSBS) | (_gather(ctrl_high & ~(ctrl_high << 6) & MSBS) << 8);
+	}
+
+	_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+		return _gather(ctrl_low & MSBS) | (_gather(ctrl_high & MSBS) << 8);
+	}
+#endif
+};
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+	static constexpr uint32_t GROUP_SIZE = FlatHashMapGroup::SIZE;
+
+	int8_t *ctrl = nullptr;
+	KeyValue<TKey, TValue> *slots = nullptr;
+	uint32_t capacity = 0; // Zero, or a power of two multiple of GROUP_SIZE.
+	uint32_t num_elements = 0;
+	uint32_t growth_left = 0; // Empty slots that can still be used before rehashing.
+
+	static _FORCE_INLINE_ uint32_t _get_max_load(uint32_t p_capacity) {
+		return p_capacity - p_capacity / 8;
+	}
+
+	static _FORCE_INLINE_ int8_t _get_h2(uint32_t p_hash) {
+		return int8_t(p_hash & 0x7F);
+	}
+
+	_FORCE_INLINE_ uint32_t _get_first_group(uint32_t p_hash) const {
+		return (p_hash >> 7) & (capacity / GROUP_SIZE - 1);
+	}
+
+	_FORCE_INLINE_ uint32_t _get_next_group(uint32_t p_group, uint32_t p_step) const {
+		// Triangular probing, which visits every group when their count is a power of two.
+		return (p_group + p_step) & (capacity / GROUP_SIZE - 1);
+	}
+
+	bool _lookup_pos_with_hash(const TKey &p_key, uint32_t p_hash, uint32_t &r_pos) const {
+		if (num_elements == 0) {
+			return false;
+		}
+
+		const int8_t h2 = _get_h2(p_hash);
+		uint32_t group = _get_first_group(p_hash);
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * GROUP_SIZE;
+			const FlatHashMapGroup g(ctrl + base);
+			for (uint32_t mask = g.match(h2); mask; mask &= mask - 1) {
+				const uint32_t pos = base + count_trailing_zeros_32(mask);
+				if (Comparator::compare(slots[pos].key, p_key)) {
+					r_pos = pos;
+					return true;
+				}
+			}
+			if (g.match_empty()) {
+				return false;
+			}
+			group = _get_next_group(group, step);
+		}
+	}
+
+	_FORCE_INLINE_ bool _lookup_pos(const TKey &p_key, uint32_t &r_pos) const {
+		return _lookup_pos_with_hash(p_key, Hasher::hash(p_key), r_pos);
+	}
+
+	uint32_t _find_free_pos(uint32_t p_hash) const {
+		uint32_t group = _get_first_group(p_hash);
+		for (uint32_t step = 1;; step++) {
+			const uint32_t base = group * GROUP_SIZE;
+			const uint32_t mask = FlatHashMapGroup(ctrl + base).match_empty_or_deleted();
+			if (mask) {
+				return base + count_trailing_zeros_32(mask);
+			}
+			group = _get_next_group(group, step);
+		}
+	}
+
+	void _resize_and_rehash(uint32_t p_new_capacity) {
+		int8_t *old_ctrl = ctrl;
+		KeyValue<TKey, TValue> *old_slots = slots;
+		const uint32_t old_capacity = capacity;
+
+		capacity = p_new_capacity;
+		ctrl = reinterpret_cast<int8_t *>(Memory::alloc_static(capacity));
+		slots = reinterpret_cast<KeyValue<TKey, TValue> *>(Memory::alloc_static(sizeof(KeyValue<TKey, TValue>) * capacity));
+		memset(ctrl, (uint8_t)FlatHashMapGroup::CTRL_EMPTY, capacity);
+		growth_left = _get_max_load(capacity) - num_elements;
+
+		if (old_ctrl == nullptr) {
+			return;
+		}
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] < 0) {
+				continue;
+			}
+			const uint32_t hash = Hasher::hash(old_slots[i].key);
+			const uint32_t pos = _find_free_pos(hash);
+			ctrl[pos] = _get_h2(hash);
+			memcpy((void *)&slots[pos], (const void *)&old_slots[i], sizeof(KeyValue<TKey, TValue>));
+		}
+
+		Memory::free_static(old_ctrl);
+		Memory::free_static(old_slots);
+	}
+
+	uint32_t _insert_new(const TKey &p_key, const TValue &p_value, uint32_t p_hash) {
+		uint32_t pos = 0;
+		if (capacity > 0) {
+			pos = _find_free_pos(p_hash);
+		}
+		if (unlikely(capacity == 0 || (growth_left == 0 && ctrl[pos] == FlatHashMapGroup::CTRL_EMPTY))) {
+			if (capacity == 0) {
+				_resize_and_rehash(GROUP_SIZE);
+			} else if (num_elements < _get_max_load(capacity) / 2) {
+				// Mostly deleted slots, clean them up without growing.
+				_resize_and_rehash(capacity);
+			} else {
+				CRASH_COND_MSG(capacity > (UINT32_MAX >> 1), "FlatHashMap maximum capacity reached.");
+				_resize_and_rehash(capacity * 2);
+			}
+			pos = _find_free_pos(p_hash);
+		}
+
+		if (ctrl[pos] == FlatHashMapGroup::CTRL_EMPTY) {
+			growth_left--;
+		}
+		ctrl[pos] = _get_h2(p_hash);
+		new (&slots[pos]) KeyValue<TKey, TValue>(p_key, p_value);
+		num_elements++;
+		return pos;
+	}
+
+	void _erase_pos(uint32_t p_pos) {
+		// If the group still has an empty slot, no probe went past it, so the slot can be
+		// marked as empty again. Otherwise it must stay a tombstone to keep probes going.
+		const uint32_t base = p_pos & ~(GROUP_SIZE - 1);
+		if (FlatHashMapGroup(ctrl + base).match_empty()) {
+			ctrl[p_pos] = FlatHashMapGroup::CTRL_EMPTY;
+			growth_left++;
+		} else {
+			ctrl[p_pos] = FlatHashMapGroup::CTRL_DELETED;
+		}
+		slots[p_pos].~KeyValue<TKey, TValue>();
+		num_elements--;
+	}
+
+	_FORCE_INLINE_ uint32_t _get_next_used_pos(uint32_t p_pos) const {
+		while (p_pos < capacity && ctrl[p_pos] < 0) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+public:
+	_FORCE_INLINE_ uint32_t get_capacity() const { return capacity; }
+	_FORCE_INLINE_ uint32_t size() const { return num_elements; }
+
+	/* Standard Godot Container API */
+
+	bool is_empty() const {
+		return num_elements == 0;
+	}
+
+	void clear() {
+		if (num_elements > 0) {
+			for (uint32_t i = 0; i < capacity; i++) {
+				if (ctrl[i] >= 0) {
+					slots[i].~KeyValue<TKey, TValue>();
+				}
+			}
+		}
+		if (ctrl) {
+			memset(ctrl, (uint8_t)FlatHashMapGroup::CTRL_EMPTY, capacity);
+		}
+		num_elements = 0;
+		growth_left = _get_max_load(capacity);
+	}
+
+	// Like clear(), but also releases the memory.
+	void reset() {
+		clear();
+		if (ctrl) {
+			Memory::free_static(ctrl);
+			Memory::free_static(slots);
+			ctrl = nullptr;
+			slots = nullptr;
+			capacity = 0;
+			growth_left = 0;
+		}
+	}
+
+	TValue &get(const TKey &p_key) {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue &get(const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND_MSG(!exists, "FlatHashMap key not found.");
+		return slots[pos].value;
+	}
+
+	const TValue *getptr(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	TValue *getptr(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (_lookup_pos(p_key, pos)) {
+			return &slots[pos].value;
+		}
+		return nullptr;
+	}
+
+	_FORCE_INLINE_ bool has(const TKey &p_key) const {
+		uint32_t _pos = 0;
+		return _lookup_pos(p_key, _pos);
+	}
+
+	bool erase(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return false;
+		}
+		_erase_pos(pos);
+		return true;
+	}
+
+	// Reserves space for a number of elements, to avoid rehashing while inserting them.
+	void reserve(uint32_t p_new_size) {
+		if (p_new_size == 0) {
+			return;
+		}
+		uint32_t new_capacity = MAX(capacity, GROUP_SIZE);
+		while (_get_max_load(new_capacity) < p_new_size) {
+			ERR_FAIL_COND_MSG(new_capacity > (UINT32_MAX >> 1), "FlatHashMap maximum capacity reached.");
+			new_capacity *= 2;
+		}
+		if (new_capacity != capacity) {
+			_resize_and_rehash(new_capacity);
+		}
+	}
+
+	/** Iterator API **/
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ const KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			if (map && pos < map->capacity) {
+				pos = map->_get_next_used_pos(pos + 1);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const ConstIterator &b) const { return pos == b.pos && map == b.map; }
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &b) const { return pos != b.pos || map != b.map; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ ConstIterator(const FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ ConstIterator() {}
+
+	private:
+		const FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+	};
+
+	struct Iterator {
+		_FORCE_INLINE_ KeyValue<TKey, TValue> &operator*() const {
+			return map->slots[pos];
+		}
+		_FORCE_INLINE_ KeyValue<TKey, TValue> *operator->() const { return &map->slots[pos]; }
+		_FORCE_INLINE_ Iterator &operator++() {
+			if (map && pos < map->capacity) {
+				pos = map->_get_next_used_pos(pos + 1);
+			}
+			return *this;
+		}
+
+		_FORCE_INLINE_ bool operator==(const Iterator &b) const { return pos == b.pos && map == b.map; }
+		_FORCE_INLINE_ bool operator!=(const Iterator &b) const { return pos != b.pos || map != b.map; }
+
+		_FORCE_INLINE_ explicit operator bool() const {
+			return map && pos < map->capacity;
+		}
+
+		_FORCE_INLINE_ Iterator(FlatHashMap *p_map, uint32_t p_pos) {
+			map = p_map;
+			pos = p_pos;
+		}
+		_FORCE_INLINE_ Iterator() {}
+
+		operator ConstIterator() const {
+			return ConstIterator(map, pos);
+		}
+
+	private:
+		FlatHashMap *map = nullptr;
+		uint32_t pos = 0;
+		friend class FlatHashMap;
+	};
+
+	_FORCE_INLINE_ Iterator begin() {
+		return Iterator(this, _get_next_used_pos(0));
+	}
+	_FORCE_INLINE_ Iterator end() {
+		return Iterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ Iterator find(const TKey &p_key) {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return Iterator(this, pos);
+	}
+
+	_FORCE_INLINE_ void remove(const Iterator &p_iter) {
+		if (p_iter) {
+			_erase_pos(p_iter.pos);
+		}
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator(this, _get_next_used_pos(0));
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator(this, capacity);
+	}
+
+	_FORCE_INLINE_ ConstIterator find(const TKey &p_key) const {
+		uint32_t pos = 0;
+		if (!_lookup_pos(p_key, pos)) {
+			return end();
+		}
+		return ConstIterator(this, pos);
+	}
+
+	/* Indexing */
+
+	const TValue &operator[](const TKey &p_key) const {
+		uint32_t pos = 0;
+		bool exists = _lookup_pos(p_key, pos);
+		CRASH_COND(!exists);
+		return slots[pos].value;
+	}
+
+	TValue &operator[](const TKey &p_key) {
+		const uint32_t hash = Hasher::hash(p_key);
+		uint32_t pos = 0;
+		if (!_lookup_pos_with_hash(p_key, hash, pos)) {
+			pos = _insert_new(p_key, TValue(), hash);
+		}
+		return slots[pos].value;
+	}
+
+	/* Insert */
+
+	Iterator insert(const TKey &p_key, const TValue &p_value) {
+		const uint32_t hash = Hasher::hash(p_key);
+		uint32_t pos = 0;
+		if (_lookup_pos_with_hash(p_key, hash, pos)) {
+			slots[pos].value = p_value;
+		} else {
+			pos = _insert_new(p_key, p_value, hash);
+		}
+		return Iterator(this, pos);
+	}
+
+	/* Constructors */
+
+	FlatHashMap(const FlatHashMap &p_other) {
+		reserve(p_other.size());
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	void operator=(const FlatHashMap &p_other) {
+		if (this == &p_other) {
+			return; // Ignore self assignment.
+		}
+		clear();
+		reserve(p_other.size());
+		for (const KeyValue<TKey, TValue> &E : p_other) {
+			insert(E.key, E.value);
+		}
+	}
+
+	FlatHashMap(uint32_t p_initial_capacity) {
+		reserve(p_initial_capacity);
+	}
+	FlatHashMap() {}
+
+	~FlatHashMap() {
+		reset();
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
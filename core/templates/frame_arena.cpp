@@ -0,0 +1,194 @@
+/**************************************************************************/
+/*  frame_arena.cpp                                                       */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#include "frame_arena.h"
+
+#include "core/error/error_macros.h"
+
+#include <string.h>
+
+thread_local FrameArena::ThreadArena FrameArena::thread_arena;
+SafeNumeric<uint64_t> FrameArena::frame;
+
+FrameArena::ThreadArena::~ThreadArena() {
+	Chunk *chunk = first;
+	while (chunk) {
+		Chunk *next = chunk->next;
+		Memory::free_static(chunk, false);
+		chunk = next;
+	}
+}
+
+void FrameArena::_begin_thread_frame(ThreadArena &p_arena, uint64_t p_frame) {
+	// Chunks past the current one hold no live blocks. Keep the ones that were
+	// needed during the previous frame of this thread, release the rest.
+	if (p_arena.current) {
+		Chunk **link = &p_arena.current->next;
+		while (*link) {
+			Chunk *chunk = *link;
+			if (chunk->last_frame < p_arena.frame) {
+				*link = chunk->next;
+				Memory::free_static(chunk, false);
+			} else {
+				link = &chunk->next;
+			}
+		}
+	}
+	p_arena.frame = p_frame;
+}
+
+void *FrameArena::_alloc_from_new_chunk(ThreadArena &p_arena, size_t p_size, size_t p_align) {
+	// Move on to the next spare chunk if it's large enough, otherwise insert a new one.
+	Chunk *chunk = p_arena.current ? p_arena.current->next : p_arena.first;
+	if (!chunk || chunk->size < p_size + p_align) {
+		size_t size = MAX(CHUNK_SIZE, p_size + p_align);
+		Chunk *new_chunk = (Chunk *)Memory::alloc_static(sizeof(Chunk) + size, false);
+		CRASH_COND_MSG(!new_chunk, "Out of memory");
+		memnew_placement(new_chunk, Chunk);
+		new_chunk->size = size;
+		new_chunk->next = chunk;
+		if (p_arena.current) {
+			p_arena.current->next = new_chunk;
+		} else {
+			p_arena.first = new_chunk;
+		}
+		chunk = new_chunk;
+	}
+
+	chunk->used = 0;
+	p_arena.current = chunk;
+
+	uintptr_t base = (uintptr_t)chunk->get_data();
+	size_t offset = ((base + p_align - 1) & ~(uintptr_t)(p_align - 1)) - base;
+	chunk->used = offset + p_size;
+	chunk->last_frame = p_arena.frame;
+	p_arena.last_block = chunk->get_data() + offset;
+	p_arena.live_blocks++;
+	return p_arena.last_block;
+}
+
+void *FrameArena::alloc(size_t p_size, size_t p_align) {
+	DEV_ASSERT(p_align > 0 && (p_align & (p_align - 1)) == 0);
+	ThreadArena &arena = thread_arena;
+
+	uint64_t current_frame = frame.get();
+	if (unlikely(arena.frame != current_frame)) {
+		_begin_thread_frame(arena, current_frame);
+	}
+
+	Chunk *chunk = arena.current;
+	if (likely(chunk)) {
+		uintptr_t base = (uintptr_t)chunk->get_data();
+		size_t offset = ((base + chunk->used + p_align - 1) & ~(uintptr_t)(p_align - 1)) - base;
+		if (likely(offset + p_size <= chunk->size)) {
+			chunk->used = offset + p_size;
+			chunk->last_frame = current_frame;
+			arena.last_block = chunk->get_data() + offset;
+			arena.live_blocks++;
+			return arena.last_block;
+		}
+	}
+
+	return _alloc_from_new_chunk(arena, p_size, p_align);
+}
+
+void *FrameArena::realloc(void *p_ptr, size_t p_old_size, size_t p_new_size) {
+	if (!p_ptr) {
+		return alloc(p_new_size);
+	}
+	if (p_new_size == 0) {
+		free(p_ptr);
+		return nullptr;
+	}
+
+	// The most recent block can grow or shrink in place.
+	ThreadArena &arena = thread_arena;
+	if (p_ptr == arena.last_block) {
+		Chunk *chunk = arena.current;
+		size_t offset = arena.last_block - chunk->get_data();
+		if (offset + p_new_size <= chunk->size) {
+			chunk->used = offset + p_new_size;
+			return p_ptr;
+		}
+	}
+
+	void *new_ptr = alloc(p_new_size);
+	memcpy(new_ptr, p_ptr, MIN(p_old_size, p_new_size));
+	free(p_ptr);
+	return new_ptr;
+}
+
+void FrameArena::free(void *p_ptr) {
+	if (!p_ptr) {
+		return;
+	}
+
+	ThreadArena &arena = thread_arena;
+	ERR_FAIL_COND_MSG(arena.live_blocks == 0, "Freeing a block that wasn't allocated from the frame arena of this thread.");
+
+	arena.live_blocks--;
+	if (arena.live_blocks == 0) {
+		// Nothing is left alive, start over from the first chunk.
+		arena.current = arena.first;
+		arena.current->used = 0;
+		arena.last_block = nullptr;
+	} else if (p_ptr == arena.last_block) {
+		arena.current->used = arena.last_block - arena.current->get_data();
+		arena.last_block = nullptr;
+	}
+}
+
+void FrameArena::begin_frame() {
+	frame.increment();
+}
+
+uint64_t FrameArena::get_frame() {
+	return frame.get();
+}
+
+size_t FrameArena::get_thread_used() {
+	const ThreadArena &arena = thread_arena;
+	size_t used = 0;
+	for (Chunk *chunk = arena.first; chunk; chunk = chunk->next) {
+		used += chunk->used;
+		if (chunk == arena.current) {
+			break;
+		}
+	}
+	return arena.live_blocks > 0 ? used : 0;
+}
+
+size_t FrameArena::get_thread_reserved() {
+	size_t reserved = 0;
+	for (Chunk *chunk = thread_arena.first; chunk; chunk = chunk->next) {
+		reserved += chunk->size;
+	}
+	return reserved;
+}
@@ -0,0 +1,125 @@
+/**************************************************************************/
+/*  frame_arena.h                                                         */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+#include "core/os/memory.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/safe_refcount.h"
+
+// Thread-local bump allocator for transient memory that doesn't outlive the frame
+// it was allocated in (culling lists, scratch buffers, etc.).
+// - Each thread carves blocks out of its own chunks, so neither alloc() nor free()
+//   takes a lock. Blocks must be freed on the thread that allocated them.
+// - free() only releases the most recent block for reuse; the whole arena of a
+//   thread is rewound once all of its blocks have been freed.
+// - begin_frame() is called by Main::iteration(). Chunks a thread didn't need during
+//   its previous frame are returned to the heap, so one-off spikes don't stay reserved.
+// Data kept across frames doesn't belong here: canvas item command blocks live until
+// the item is cleared, and the scene cull result lists are PagedArrays that already
+// recycle their pages from a pool.
+
+class FrameArena {
+public:
+	static constexpr size_t CHUNK_SIZE = 64 * 1024;
+	static constexpr size_t DEFAULT_ALIGN = 16;
+
+private:
+	struct Chunk {
+		Chunk *next = nullptr;
+		size_t size = 0;
+		size_t used = 0;
+		uint64_t last_frame = 0;
+
+		_FORCE_INLINE_ uint8_t *get_data() { return reinterpret_cast<uint8_t *>(this) + sizeof(Chunk); }
+	};
+
+	struct ThreadArena {
+		Chunk *first = nullptr;
+		Chunk *current = nullptr;
+		uint8_t *last_block = nullptr;
+		uint32_t live_blocks = 0;
+		uint64_t frame = 0;
+
+		~ThreadArena();
+	};
+
+	static thread_local ThreadArena thread_arena;
+	static SafeNumeric<uint64_t> frame;
+
+	static void _begin_thread_frame(ThreadArena &p_arena, uint64_t p_frame);
+	static void *_alloc_from_new_chunk(ThreadArena &p_arena, size_t p_size, size_t p_align);
+
+public:
+	static void *alloc(size_t p_size, size_t p_align = DEFAULT_ALIGN);
+	static void *realloc(void *p_ptr, size_t p_old_size, size_t p_new_size);
+	static void free(void *p_ptr);
+
+	static void begin_frame();
+	static uint64_t get_frame();
+
+	static size_t get_thread_used();
+	static size_t get_thread_reserved();
+};
+
+class FrameArenaAllocator {
+public:
+	_FORCE_INLINE_ static void *alloc(size_t p_memory) { return FrameArena::alloc(p_memory); }
+	_FORCE_INLINE_ static void *realloc(void *p_ptr, size_t p_old_size, size_t p_new_size) { return FrameArena::realloc(p_ptr, p_old_size, p_new_size); }
+	_FORCE_INLINE_ static void free(void *p_ptr) { FrameArena::free(p_ptr); }
+};
+
+template <class T>
+class FrameArenaTypedAllocator {
+public:
+	template <class... Args>
+	_FORCE_INLINE_ T *new_allocation(const Args &&...p_args) { return memnew_placement(FrameArena::alloc(sizeof(T), alignof(T)), T(p_args...)); }
+	_FORCE_INLINE_ void delete_allocation(T *p_allocation) {
+		p_allocation->~T();
+		FrameArena::free(p_allocation);
+	}
+};
+
+// Containers backed by the frame arena. They follow the same rules as the arena
+// itself: keep them local to a frame and to the thread that created them.
+// Only the elements of a FrameHashMap live in the arena; its bucket arrays still
+// come from the heap.
+
+template <class T, class U = uint32_t, bool force_trivial = false>
+using FrameLocalVector = LocalVector<T, U, force_trivial, false, FrameArenaAllocator>;
+
+template <class TKey, class TValue,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+using FrameHashMap = HashMap<TKey, TValue, Hasher, Comparator, FrameArenaTypedAllocator<HashMapElement<TKey, TValue>>>;
+
+#endif // FRAME_ARENA_H
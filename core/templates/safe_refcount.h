@@ -134,6 +134,17 @@ public:
 		}
 	}
 
+	// Returns whether the value was below the limit, and so got incremented.
+	_ALWAYS_INLINE_ bool increment_if_less(T p_limit) {
+		T c = value.load(std::memory_order_acquire);
+		while (c < p_limit) {
+			if (value.compare_exchange_weak(c, c + 1, std::memory_order_acq_rel)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
 	_ALWAYS_INLINE_ T conditional_increment() {
 		while (true) {
 			T c = value.load(std::memory_order_acquire);
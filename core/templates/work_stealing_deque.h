@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*  work_stealing_deque.h                                                 */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef WORK_STEALING_DEQUE_H
+#define WORK_STEALING_DEQUE_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/typedefs.h"
+
+#include <atomic>
+
+// Bounded Chase-Lev work-stealing deque.
+// - push() and pop() may only be called from the owner thread, which works in LIFO order.
+// - steal() may be called from any thread, which takes the oldest element (FIFO).
+// The capacity is fixed on setup, so push() fails instead of growing; callers are
+// expected to fall back to some other (shared) queue in that case.
+
+template <class T>
+class WorkStealingDeque {
+	static_assert(std::atomic<T *>::is_always_lock_free);
+
+	std::atomic<int64_t> top = 0;
+	std::atomic<int64_t> bottom = 0;
+	std::atomic<T *> *buffer = nullptr;
+	int64_t mask = 0;
+
+public:
+	void setup(uint32_t p_capacity) {
+		ERR_FAIL_COND(buffer != nullptr);
+		ERR_FAIL_COND(p_capacity == 0);
+		uint32_t capacity = next_power_of_2(p_capacity);
+		mask = capacity - 1;
+		buffer = memnew_arr(std::atomic<T *>, capacity);
+		for (uint32_t i = 0; i < capacity; i++) {
+			buffer[i].store(nullptr, std::memory_order_relaxed);
+		}
+		top.store(0, std::memory_order_relaxed);
+		bottom.store(0, std::memory_order_relaxed);
+	}
+
+	_FORCE_INLINE_ bool is_setup() const { return buffer != nullptr; }
+	_FORCE_INLINE_ uint32_t get_capacity() const { return buffer ? mask + 1 : 0; }
+
+	// Approximate when called from a thread other than the owner.
+	_FORCE_INLINE_ bool is_empty() const {
+		int64_t b = bottom.load(std::memory_order_acquire);
+		int64_t t = top.load(std::memory_order_acquire);
+		return b <= t;
+	}
+
+	// Owner only.
+	bool push(T *p_elem) {
+		int64_t b = bottom.load(std::memory_order_relaxed);
+		int64_t t = top.load(std::memory_order_acquire);
+		if (b - t > mask) {
+			return false; // Full.
+		}
+		buffer[b & mask].store(p_elem, std::memory_order_relaxed);
+		bottom.store(b + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Owner only. Returns the most recently pushed element, or null.
+	T *pop() {
+		int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t t = top.load(std::memory_order_relaxed);
+
+		if (t > b) {
+			// Empty.
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		T *elem = buffer[b & mask].load(std::memory_order_relaxed);
+		if (t == b) {
+			// Last element; race against thieves for it.
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+				elem = nullptr;
+			}
+			bottom.store(b + 1, std::memory_order_relaxed);
+		}
+		return elem;
+	}
+
+	// Any thread. Returns the oldest element, or null if empty or the race for it was lost.
+	T *steal() {
+		int64_t t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		int64_t b = bottom.load(std::memory_order_acquire);
+		if (t >= b) {
+			return nullptr;
+		}
+
+		T *elem = buffer[t & mask].load(std::memory_order_relaxed);
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+			return nullptr;
+		}
+		return elem;
+	}
+
+	void clear() {
+		if (buffer) {
+			memdelete_arr(buffer);
+			buffer = nullptr;
+		}
+		mask = 0;
+		top.store(0, std::memory_order_relaxed);
+		bottom.store(0, std::memory_order_relaxed);
+	}
+
+	WorkStealingDeque() {}
+	WorkStealingDeque(const WorkStealingDeque &p_from) = delete;
+	void operator=(const WorkStealingDeque &p_from) = delete;
+	~WorkStealingDeque() {
+		clear();
+	}
+};
+
+#endif // WORK_STEALING_DEQUE_H
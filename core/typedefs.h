@@ -255,6 +255,99 @@ static inline uint64_t BSWAP64(uint64_t x) {
 }
 #endif
 
+// Count the zero bits below the lowest set bit (trailing) or above the highest set bit (leading).
+// The value must not be zero.
+#if defined(__GNUC__)
+static _FORCE_INLINE_ uint32_t count_trailing_zeros_32(uint32_t p_value) {
+	return __builtin_ctz(p_value);
+}
+
+static _FORCE_INLINE_ uint32_t count_trailing_zeros_64(uint64_t p_value) {
+	return __builtin_ctzll(p_value);
+}
+
+static _FORCE_INLINE_ uint32_t count_leading_zeros_32(uint32_t p_value) {
+	return __builtin_clz(p_value);
+}
+
+static _FORCE_INLINE_ uint32_t count_leading_zeros_64(uint64_t p_value) {
+	return __builtin_clzll(p_value);
+}
+#elif defined(_MSC_VER)
+#include <intrin.h>
+static _FORCE_INLINE_ uint32_t count_trailing_zeros_32(uint32_t p_value) {
+	unsigned long index;
+	_BitScanForward(&index, p_value);
+	return index;
+}
+
+static _FORCE_INLINE_ uint32_t count_leading_zeros_32(uint32_t p_value) {
+	unsigned long index;
+	_BitScanReverse(&index, p_value);
+	return 31 - index;
+}
+
+#if defined(_WIN64)
+static _FORCE_INLINE_ uint32_t count_trailing_zeros_64(uint64_t p_value) {
+	unsigned long index;
+	_BitScanForward64(&index, p_value);
+	return index;
+}
+
+static _FORCE_INLINE_ uint32_t count_leading_zeros_64(uint64_t p_value) {
+	unsigned long index;
+	_BitScanReverse64(&index, p_value);
+	return 63 - index;
+}
+#else
+static _FORCE_INLINE_ uint32_t count_trailing_zeros_64(uint64_t p_value) {
+	const uint32_t low = (uint32_t)p_value;
+	return low ? count_trailing_zeros_32(low) : 32 + count_trailing_zeros_32((uint32_t)(p_value >> 32));
+}
+
+static _FORCE_INLINE_ uint32_t count_leading_zeros_64(uint64_t p_value) {
+	const uint32_t high = (uint32_t)(p_value >> 32);
+	return high ? count_leading_zeros_32(high) : 32 + count_leading_zeros_32((uint32_t)p_value);
+}
+#endif
+#else
+static inline uint32_t count_trailing_zeros_32(uint32_t p_value) {
+	uint32_t count = 0;
+	while (!(p_value & 1)) {
+		p_value >>= 1;
+		count++;
+	}
+	return count;
+}
+
+static inline uint32_t count_trailing_zeros_64(uint64_t p_value) {
+	uint32_t count = 0;
+	while (!(p_value & 1)) {
+		p_value >>= 1;
+		count++;
+	}
+	return count;
+}
+
+static inline uint32_t count_leading_zeros_32(uint32_t p_value) {
+	uint32_t count = 0;
+	while (!(p_value & 0x80000000)) {
+		p_value <<= 1;
+		count++;
+	}
+	return count;
+}
+
+static inline uint32_t count_leading_zeros_64(uint64_t p_value) {
+	uint32_t count = 0;
+	while (!(p_value & 0x8000000000000000)) {
+		p_value <<= 1;
+		count++;
+	}
+	return count;
+}
+#endif
+
 // Generic comparator used in Map, List, etc.
 template <class T>
 struct Comparator {
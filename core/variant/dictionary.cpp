@@ -30,7 +30,7 @@
 
 #include "dictionary.h"
 
-#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/safe_refcount.h"
 #include "core/variant/variant.h"
 // required in this order by VariantInternal, do not remove this comment.
@@ -39,25 +39,313 @@
 #include "core/variant/type_info.h"
 #include "core/variant/variant_internal.h"
 
+#include <string.h>
+
+// Entries live in slots, in blocks that double in size and never move, so pointers
+// to keys and values stay valid until their own key is erased. The slots of erased
+// entries are reused by later insertions.
+// Insertion order is kept separately as a list of slots. Erasing leaves a hole in it,
+// and the list is compacted once holes outnumber the live entries.
+// Small dictionaries are searched linearly (comparing the cached hashes first),
+// larger ones get an open-addressing index of slots.
 struct DictionaryPrivate {
+	struct Entry {
+		Variant key;
+		Variant value;
+		uint32_t hash = 0;
+		uint32_t order_pos = 0; // Position in the order, or the next free slot once erased.
+	};
+
+	struct ConstIterator {
+		_FORCE_INLINE_ const Entry &operator*() const { return dictionary->get_entry(dictionary->order[pos]); }
+		_FORCE_INLINE_ const Entry *operator->() const { return &dictionary->get_entry(dictionary->order[pos]); }
+		_FORCE_INLINE_ ConstIterator &operator++() {
+			pos = dictionary->get_next_pos(pos);
+			return *this;
+		}
+		_FORCE_INLINE_ bool operator!=(const ConstIterator &p_other) const { return pos != p_other.pos; }
+
+		const DictionaryPrivate *dictionary = nullptr;
+		uint32_t pos = 0;
+	};
+
+	static constexpr uint32_t FIRST_BLOCK_SHIFT = 2;
+	static constexpr uint32_t FIRST_BLOCK_SIZE = 1 << FIRST_BLOCK_SHIFT;
+	static constexpr uint32_t LINEAR_SEARCH_MAX = 8;
+	static constexpr uint32_t MIN_INDEX_CAPACITY = 32;
+	static constexpr uint32_t NOT_FOUND = UINT32_MAX;
+	static constexpr uint32_t HOLE = UINT32_MAX;
+	static constexpr uint32_t INDEX_EMPTY = UINT32_MAX;
+	static constexpr uint32_t INDEX_DELETED = UINT32_MAX - 1;
+
 	SafeRefCount refcount;
 	Variant *read_only = nullptr; // If enabled, a pointer is used to a temporary value that is used to return read-only values.
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator> variant_map;
-};
 
-void Dictionary::get_key_list(List<Variant> *p_keys) const {
-	if (_p->variant_map.is_empty()) {
-		return;
+	LocalVector<Entry *> blocks;
+	uint32_t slot_count = 0; // Including free slots.
+	uint32_t free_slot = NOT_FOUND;
+
+	LocalVector<uint32_t> order; // Slots in insertion order, including holes.
+	uint32_t hole_count = 0;
+
+	uint32_t *index = nullptr;
+	uint32_t index_capacity = 0;
+	uint32_t index_used = 0; // Including deleted slots.
+
+	_FORCE_INLINE_ uint32_t size() const { return order.size() - hole_count; }
+
+	static _FORCE_INLINE_ uint32_t _get_block_size(uint32_t p_block) {
+		return p_block == 0 ? FIRST_BLOCK_SIZE : FIRST_BLOCK_SIZE << (p_block - 1);
+	}
+
+	_FORCE_INLINE_ Entry &get_entry(uint32_t p_slot) const {
+		if (p_slot < FIRST_BLOCK_SIZE) {
+			return blocks[0][p_slot];
+		}
+		const uint32_t shift = 31 - count_leading_zeros_32(p_slot);
+		return blocks[shift - FIRST_BLOCK_SHIFT + 1][p_slot - (1u << shift)];
+	}
+
+	_FORCE_INLINE_ uint32_t _skip_holes(uint32_t p_pos) const {
+		while (p_pos < order.size() && order[p_pos] == HOLE) {
+			p_pos++;
+		}
+		return p_pos;
+	}
+
+	_FORCE_INLINE_ uint32_t get_next_pos(uint32_t p_pos) const {
+		return _skip_holes(p_pos + 1);
+	}
+
+	_FORCE_INLINE_ ConstIterator begin() const {
+		return ConstIterator{ this, _skip_holes(0) };
+	}
+	_FORCE_INLINE_ ConstIterator end() const {
+		return ConstIterator{ this, order.size() };
+	}
+
+	static _FORCE_INLINE_ uint32_t hash(const Variant &p_key) {
+		return VariantHasher::hash(p_key);
+	}
+
+	uint32_t find(const Variant &p_key, uint32_t p_hash) const {
+		if (index == nullptr) {
+			for (const uint32_t slot : order) {
+				if (slot == HOLE) {
+					continue;
+				}
+				const Entry &entry = get_entry(slot);
+				if (entry.hash == p_hash && StringLikeVariantComparator::compare(entry.key, p_key)) {
+					return slot;
+				}
+			}
+			return NOT_FOUND;
+		}
+
+		const uint32_t mask = index_capacity - 1;
+		for (uint32_t index_pos = hash_fmix32(p_hash) & mask;; index_pos = (index_pos + 1) & mask) {
+			const uint32_t slot = index[index_pos];
+			if (slot == INDEX_EMPTY) {
+				return NOT_FOUND;
+			}
+			if (slot != INDEX_DELETED) {
+				const Entry &entry = get_entry(slot);
+				if (entry.hash == p_hash && StringLikeVariantComparator::compare(entry.key, p_key)) {
+					return slot;
+				}
+			}
+		}
+	}
+
+	_FORCE_INLINE_ uint32_t find(const Variant &p_key) const {
+		return size() == 0 ? NOT_FOUND : find(p_key, hash(p_key));
+	}
+
+	void _index_insert(uint32_t p_slot, uint32_t p_hash) {
+		const uint32_t mask = index_capacity - 1;
+		uint32_t index_pos = hash_fmix32(p_hash) & mask;
+		while (index[index_pos] != INDEX_EMPTY) {
+			index_pos = (index_pos + 1) & mask;
+		}
+		index[index_pos] = p_slot;
+		index_used++;
+	}
+
+	void _index_erase(uint32_t p_slot, uint32_t p_hash) {
+		const uint32_t mask = index_capacity - 1;
+		uint32_t index_pos = hash_fmix32(p_hash) & mask;
+		while (index[index_pos] != p_slot) {
+			index_pos = (index_pos + 1) & mask;
+		}
+		index[index_pos] = INDEX_DELETED;
+	}
+
+	void _rebuild_index() {
+		if (index) {
+			Memory::free_static(index);
+			index = nullptr;
+			index_capacity = 0;
+			index_used = 0;
+		}
+		if (size() <= LINEAR_SEARCH_MAX) {
+			return;
+		}
+
+		// Keep the load factor at 1/2 at most after rebuilding.
+		index_capacity = MAX(MIN_INDEX_CAPACITY, next_power_of_2(size() * 2));
+		index = reinterpret_cast<uint32_t *>(Memory::alloc_static(sizeof(uint32_t) * index_capacity));
+		memset(index, 0xFF, sizeof(uint32_t) * index_capacity);
+		for (const uint32_t slot : order) {
+			if (slot != HOLE) {
+				_index_insert(slot, get_entry(slot).hash);
+			}
+		}
+	}
+
+	Variant &insert(const Variant &p_key, uint32_t p_hash) {
+		uint32_t slot;
+		Entry *entry;
+		if (free_slot != NOT_FOUND) {
+			slot = free_slot;
+			entry = &get_entry(slot);
+			free_slot = entry->order_pos;
+		} else {
+			const uint32_t capacity = blocks.is_empty() ? 0 : FIRST_BLOCK_SIZE << (blocks.size() - 1);
+			if (slot_count == capacity) {
+				const uint32_t block_size = _get_block_size(blocks.size());
+				blocks.push_back(reinterpret_cast<Entry *>(Memory::alloc_static(sizeof(Entry) * block_size)));
+			}
+			slot = slot_count++;
+			entry = memnew_placement(&get_entry(slot), Entry);
+		}
+		entry->key = p_key;
+		entry->hash = p_hash;
+		entry->order_pos = order.size();
+		order.push_back(slot);
+
+		if (index) {
+			if ((index_used + 1) * 4 > index_capacity * 3) {
+				_rebuild_index();
+			} else {
+				_index_insert(slot, p_hash);
+			}
+		} else if (size() > LINEAR_SEARCH_MAX) {
+			_rebuild_index();
+		}
+
+		return entry->value;
+	}
+
+	Variant &get_or_insert(const Variant &p_key) {
+		const uint32_t key_hash = hash(p_key);
+		const uint32_t slot = size() == 0 ? NOT_FOUND : find(p_key, key_hash);
+		if (slot != NOT_FOUND) {
+			return get_entry(slot).value;
+		}
+		return insert(p_key, key_hash);
+	}
+
+	// Only the order is compacted, entries stay in their slots.
+	void _compact_order() {
+		uint32_t write = 0;
+		for (uint32_t read = 0; read < order.size(); read++) {
+			const uint32_t slot = order[read];
+			if (slot == HOLE) {
+				continue;
+			}
+			order[write] = slot;
+			get_entry(slot).order_pos = write;
+			write++;
+		}
+		order.resize(write);
+		hole_count = 0;
+		_rebuild_index();
+	}
+
+	void erase_at(uint32_t p_slot) {
+		Entry &entry = get_entry(p_slot);
+		if (index) {
+			_index_erase(p_slot, entry.hash);
+		}
+		order[entry.order_pos] = HOLE;
+		hole_count++;
+
+		// Destroying the key and value may run arbitrary code, so do it only once
+		// the dictionary is in a consistent state again.
+		Variant old_key = entry.key;
+		Variant old_value = entry.value;
+		entry.key = Variant();
+		entry.value = Variant();
+		entry.order_pos = free_slot;
+		free_slot = p_slot;
+
+		if (size() == 0) {
+			_clear_entries();
+			return;
+		}
+		// Trim the holes at the end, no need to keep them around.
+		while (order[order.size() - 1] == HOLE) {
+			order.resize(order.size() - 1);
+			hole_count--;
+		}
+		if (hole_count >= FIRST_BLOCK_SIZE && hole_count > size()) {
+			_compact_order();
+		}
 	}
 
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	void _clear_entries() {
+		for (uint32_t slot = 0; slot < slot_count; slot++) {
+			get_entry(slot).~Entry();
+		}
+		slot_count = 0;
+		free_slot = NOT_FOUND;
+		order.clear();
+		hole_count = 0;
+		_rebuild_index();
+	}
+
+	void clear() {
+		// Take the entries out first, destroying them may run arbitrary code.
+		DictionaryPrivate old;
+		SWAP(old.blocks, blocks);
+		SWAP(old.slot_count, slot_count);
+		SWAP(old.free_slot, free_slot);
+		SWAP(old.order, order);
+		SWAP(old.hole_count, hole_count);
+		SWAP(old.index, index);
+		SWAP(old.index_capacity, index_capacity);
+		SWAP(old.index_used, index_used);
+	}
+
+	~DictionaryPrivate() {
+		for (uint32_t slot = 0; slot < slot_count; slot++) {
+			get_entry(slot).~Entry();
+		}
+		for (Entry *block : blocks) {
+			Memory::free_static(block);
+		}
+		if (index) {
+			Memory::free_static(index);
+		}
+	}
+};
+
+void Dictionary::get_key_list(List<Variant> *p_keys) const {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		p_keys->push_back(E.key);
 	}
 }
 
 Variant Dictionary::get_key_at_index(int p_index) const {
+	if (p_index < 0 || (uint32_t)p_index >= _p->size()) {
+		return Variant();
+	}
+	if (_p->hole_count == 0) {
+		return _p->get_entry(_p->order[p_index]).key;
+	}
+
 	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		if (index == p_index) {
 			return E.key;
 		}
@@ -68,8 +356,15 @@ Variant Dictionary::get_key_at_index(int p_index) const {
 }
 
 Variant Dictionary::get_value_at_index(int p_index) const {
+	if (p_index < 0 || (uint32_t)p_index >= _p->size()) {
+		return Variant();
+	}
+	if (_p->hole_count == 0) {
+		return _p->get_entry(_p->order[p_index]).value;
+	}
+
 	int index = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		if (index == p_index) {
 			return E.value;
 		}
@@ -81,16 +376,9 @@ Variant Dictionary::get_value_at_index(int p_index) const {
 
 Variant &Dictionary::operator[](const Variant &p_key) {
 	if (unlikely(_p->read_only)) {
-		if (p_key.get_type() == Variant::STRING_NAME) {
-			const StringName *sn = VariantInternal::get_string_name(&p_key);
-			const String &key = sn->operator String();
-			if (likely(_p->variant_map.has(key))) {
-				*_p->read_only = _p->variant_map[key];
-			} else {
-				*_p->read_only = Variant();
-			}
-		} else if (likely(_p->variant_map.has(p_key))) {
-			*_p->read_only = _p->variant_map[p_key];
+		const uint32_t slot = _p->find(p_key);
+		if (likely(slot != DictionaryPrivate::NOT_FOUND)) {
+			*_p->read_only = _p->get_entry(slot).value;
 		} else {
 			*_p->read_only = Variant();
 		}
@@ -99,46 +387,47 @@ Variant &Dictionary::operator[](const Variant &p_key) {
 	} else {
 		if (p_key.get_type() == Variant::STRING_NAME) {
 			const StringName *sn = VariantInternal::get_string_name(&p_key);
-			return _p->variant_map[sn->operator String()];
+			return _p->get_or_insert(sn->operator String());
 		} else {
-			return _p->variant_map[p_key];
+			return _p->get_or_insert(p_key);
 		}
 	}
 }
 
 const Variant &Dictionary::operator[](const Variant &p_key) const {
 	// Will not insert key, so no conversion is necessary.
-	return _p->variant_map[p_key];
+	const uint32_t slot = _p->find(p_key);
+	CRASH_COND_MSG(slot == DictionaryPrivate::NOT_FOUND, "Dictionary key not found.");
+	return _p->get_entry(slot).value;
 }
 
 const Variant *Dictionary::getptr(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(_p->variant_map.find(p_key));
-	if (!E) {
+	const uint32_t slot = _p->find(p_key);
+	if (slot == DictionaryPrivate::NOT_FOUND) {
 		return nullptr;
 	}
-	return &E->value;
+	return &_p->get_entry(slot).value;
 }
 
 Variant *Dictionary::getptr(const Variant &p_key) {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::Iterator E(_p->variant_map.find(p_key));
-	if (!E) {
+	const uint32_t slot = _p->find(p_key);
+	if (slot == DictionaryPrivate::NOT_FOUND) {
 		return nullptr;
 	}
 	if (unlikely(_p->read_only != nullptr)) {
-		*_p->read_only = E->value;
+		*_p->read_only = _p->get_entry(slot).value;
 		return _p->read_only;
 	} else {
-		return &E->value;
+		return &_p->get_entry(slot).value;
 	}
 }
 
 Variant Dictionary::get_valid(const Variant &p_key) const {
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator E(_p->variant_map.find(p_key));
-
-	if (!E) {
+	const uint32_t slot = _p->find(p_key);
+	if (slot == DictionaryPrivate::NOT_FOUND) {
 		return Variant();
 	}
-	return E->value;
+	return _p->get_entry(slot).value;
 }
 
 Variant Dictionary::get(const Variant &p_key, const Variant &p_default) const {
@@ -160,15 +449,15 @@ Variant Dictionary::get_or_add(const Variant &p_key, const Variant &p_default) {
 }
 
 int Dictionary::size() const {
-	return _p->variant_map.size();
+	return _p->size();
 }
 
 bool Dictionary::is_empty() const {
-	return !_p->variant_map.size();
+	return !_p->size();
 }
 
 bool Dictionary::has(const Variant &p_key) const {
-	return _p->variant_map.has(p_key);
+	return _p->find(p_key) != DictionaryPrivate::NOT_FOUND;
 }
 
 bool Dictionary::has_all(const Array &p_keys) const {
@@ -181,7 +470,7 @@ bool Dictionary::has_all(const Array &p_keys) const {
 }
 
 Variant Dictionary::find_key(const Variant &p_value) const {
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		if (E.value == p_value) {
 			return E.key;
 		}
@@ -191,7 +480,12 @@ Variant Dictionary::find_key(const Variant &p_value) const {
 
 bool Dictionary::erase(const Variant &p_key) {
 	ERR_FAIL_COND_V_MSG(_p->read_only, false, "Dictionary is in read-only state.");
-	return _p->variant_map.erase(p_key);
+	const uint32_t slot = _p->find(p_key);
+	if (slot == DictionaryPrivate::NOT_FOUND) {
+		return false;
+	}
+	_p->erase_at(slot);
+	return true;
 }
 
 bool Dictionary::operator==(const Dictionary &p_dictionary) const {
@@ -207,7 +501,7 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 	if (_p == p_dictionary._p) {
 		return true;
 	}
-	if (_p->variant_map.size() != p_dictionary._p->variant_map.size()) {
+	if (_p->size() != p_dictionary._p->size()) {
 		return false;
 	}
 
@@ -217,9 +511,9 @@ bool Dictionary::recursive_equal(const Dictionary &p_dictionary, int recursion_c
 		return true;
 	}
 	recursion_count++;
-	for (const KeyValue<Variant, Variant> &this_E : _p->variant_map) {
-		HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::ConstIterator other_E(p_dictionary._p->variant_map.find(this_E.key));
-		if (!other_E || !this_E.value.hash_compare(other_E->value, recursion_count, false)) {
+	for (const DictionaryPrivate::Entry &this_E : *_p) {
+		const uint32_t other_slot = p_dictionary._p->find(this_E.key, this_E.hash);
+		if (other_slot == DictionaryPrivate::NOT_FOUND || !this_E.value.hash_compare(p_dictionary._p->get_entry(other_slot).value, recursion_count, false)) {
 			return false;
 		}
 	}
@@ -245,12 +539,12 @@ void Dictionary::_ref(const Dictionary &p_from) const {
 
 void Dictionary::clear() {
 	ERR_FAIL_COND_MSG(_p->read_only, "Dictionary is in read-only state.");
-	_p->variant_map.clear();
+	_p->clear();
 }
 
 void Dictionary::merge(const Dictionary &p_dictionary, bool p_overwrite) {
 	ERR_FAIL_COND_MSG(_p->read_only, "Dictionary is in read-only state.");
-	for (const KeyValue<Variant, Variant> &E : p_dictionary._p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *p_dictionary._p) {
 		if (p_overwrite || !has(E.key)) {
 			operator[](E.key) = E.value;
 		}
@@ -287,7 +581,7 @@ uint32_t Dictionary::recursive_hash(int recursion_count) const {
 	uint32_t h = hash_murmur3_one_32(Variant::DICTIONARY);
 
 	recursion_count++;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		h = hash_murmur3_one_32(E.key.recursive_hash(recursion_count), h);
 		h = hash_murmur3_one_32(E.value.recursive_hash(recursion_count), h);
 	}
@@ -297,14 +591,14 @@ uint32_t Dictionary::recursive_hash(int recursion_count) const {
 
 Array Dictionary::keys() const {
 	Array varr;
-	if (_p->variant_map.is_empty()) {
+	if (_p->size() == 0) {
 		return varr;
 	}
 
 	varr.resize(size());
 
 	int i = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		varr[i] = E.key;
 		i++;
 	}
@@ -314,14 +608,14 @@ Array Dictionary::keys() const {
 
 Array Dictionary::values() const {
 	Array varr;
-	if (_p->variant_map.is_empty()) {
+	if (_p->size() == 0) {
 		return varr;
 	}
 
 	varr.resize(size());
 
 	int i = 0;
-	for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+	for (const DictionaryPrivate::Entry &E : *_p) {
 		varr[i] = E.value;
 		i++;
 	}
@@ -332,21 +626,22 @@ Array Dictionary::values() const {
 const Variant *Dictionary::next(const Variant *p_key) const {
 	if (p_key == nullptr) {
 		// caller wants to get the first element
-		if (_p->variant_map.begin()) {
-			return &_p->variant_map.begin()->key;
+		DictionaryPrivate::ConstIterator E = _p->begin();
+		if (E != _p->end()) {
+			return &E->key;
 		}
 		return nullptr;
 	}
-	HashMap<Variant, Variant, VariantHasher, StringLikeVariantComparator>::Iterator E = _p->variant_map.find(*p_key);
+	const uint32_t slot = _p->find(*p_key);
 
-	if (!E) {
+	if (slot == DictionaryPrivate::NOT_FOUND) {
 		return nullptr;
 	}
 
-	++E;
+	const uint32_t next_pos = _p->get_next_pos(_p->get_entry(slot).order_pos);
 
-	if (E) {
-		return &E->key;
+	if (next_pos < _p->order.size()) {
+		return &_p->get_entry(_p->order[next_pos]).key;
 	}
 
 	return nullptr;
@@ -375,11 +670,11 @@ Dictionary Dictionary::recursive_duplicate(bool p_deep, int recursion_count) con
 
 	if (p_deep) {
 		recursion_count++;
-		for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+		for (const DictionaryPrivate::Entry &E : *_p) {
 			n[E.key.recursive_duplicate(true, recursion_count)] = E.value.recursive_duplicate(true, recursion_count);
 		}
 	} else {
-		for (const KeyValue<Variant, Variant> &E : _p->variant_map) {
+		for (const DictionaryPrivate::Entry &E : *_p) {
 			n[E.key] = E.value;
 		}
 	}
@@ -50,6 +50,8 @@ public:
 	Variant get_key_at_index(int p_index) const;
 	Variant get_value_at_index(int p_index) const;
 
+	// References and pointers to values stay valid until their own key is erased,
+	// or the dictionary is cleared. Inserting and erasing other keys doesn't move them.
 	Variant &operator[](const Variant &p_key);
 	const Variant &operator[](const Variant &p_key) const;
 
@@ -51,6 +51,7 @@
 #include "core/os/time.h"
 #include "core/register_core_types.h"
 #include "core/string/translation.h"
+#include "core/templates/frame_arena.h"
 #include "core/version.h"
 #include "drivers/register_driver_types.h"
 #include "main/app_icon.gen.h"
@@ -1753,7 +1754,8 @@ Error Main::setup(const char *execpath, int argc, char *argv[], bool p_second_ph
 		} else {
 			int worker_threads = GLOBAL_GET("threading/worker_pool/max_threads");
 			float low_priority_ratio = GLOBAL_GET("threading/worker_pool/low_priority_thread_ratio");
-			WorkerThreadPool::get_singleton()->init(worker_threads, low_priority_ratio);
+			bool work_stealing = GLOBAL_GET("threading/worker_pool/use_work_stealing");
+			WorkerThreadPool::get_singleton()->init(worker_threads, low_priority_ratio, work_stealing);
 		}
 #else
 		WorkerThreadPool::get_singleton()->init(0, 0);
@@ -3910,6 +3912,8 @@ bool Main::iteration() {
 
 	iterating++;
 
+	FrameArena::begin_frame();
+
 	const uint64_t ticks = OS::get_singleton()->get_ticks_usec();
 	Engine::get_singleton()->_frame_ticks = ticks;
 	main_timer_sync.set_cpu_ticks_usec(ticks);
@@ -31,6 +31,7 @@
 #include "performance.h"
 
 #include "core/os/os.h"
+#include "core/os/size_class_allocator.h"
 #include "core/variant/typed_array.h"
 #include "scene/main/node.h"
 #include "scene/main/scene_tree.h"
@@ -89,6 +90,12 @@ void Performance::_bind_methods() {
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_MERGE_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_CONNECTION_COUNT);
 	BIND_ENUM_CONSTANT(NAVIGATION_EDGE_FREE_COUNT);
+	BIND_ENUM_CONSTANT(PHYSICS_3D_SLEEPING_OBJECTS);
+	BIND_ENUM_CONSTANT(NAVIGATION_ABSTRACT_NODE_COUNT);
+	BIND_ENUM_CONSTANT(NAVIGATION_ABSTRACT_EDGE_COUNT);
+	BIND_ENUM_CONSTANT(TIME_NAVIGATION_AVOIDANCE);
+	BIND_ENUM_CONSTANT(MEMORY_SIZE_CLASS_USAGE);
+	BIND_ENUM_CONSTANT(MEMORY_SIZE_CLASS_RESERVED);
 	BIND_ENUM_CONSTANT(MONITOR_MAX);
 }
 
@@ -139,6 +146,12 @@ String Performance::get_monitor_name(Monitor p_monitor) const {
 		"navigation/edges_merged",
 		"navigation/edges_connected",
 		"navigation/edges_free",
+		"physics_3d/sleeping_objects",
+		"navigation/abstract_nodes",
+		"navigation/abstract_edges",
+		"time/navigation_avoidance",
+		"memory/size_class_usage",
+		"memory/size_class_reserved",
 
 	};
 
@@ -223,6 +236,23 @@ double Performance::get_monitor(Monitor p_monitor) const {
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
 		case NAVIGATION_EDGE_FREE_COUNT:
 			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+#ifdef _3D_DISABLED
+		case PHYSICS_3D_SLEEPING_OBJECTS:
+			return 0;
+#else
+		case PHYSICS_3D_SLEEPING_OBJECTS:
+			return PhysicsServer3D::get_singleton()->get_process_info(PhysicsServer3D::INFO_SLEEPING_OBJECTS);
+#endif // _3D_DISABLED
+		case NAVIGATION_ABSTRACT_NODE_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_ABSTRACT_NODE_COUNT);
+		case NAVIGATION_ABSTRACT_EDGE_COUNT:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_ABSTRACT_EDGE_COUNT);
+		case TIME_NAVIGATION_AVOIDANCE:
+			return NavigationServer3D::get_singleton()->get_process_info(NavigationServer3D::INFO_AVOIDANCE_TIME) / 1000000.0;
+		case MEMORY_SIZE_CLASS_USAGE:
+			return SizeClassAllocator::get_usage();
+		case MEMORY_SIZE_CLASS_RESERVED:
+			return SizeClassAllocator::get_reserved();
 
 		default: {
 		}
@@ -270,6 +300,12 @@ Performance::MonitorType Performance::get_monitor_type(Monitor p_monitor) const
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
 		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_QUANTITY,
+		MONITOR_TYPE_TIME,
+		MONITOR_TYPE_MEMORY,
+		MONITOR_TYPE_MEMORY,
 
 	};
 
@@ -337,6 +373,13 @@ Performance::Performance() {
 	_navigation_process_time = 0;
 	_monitor_modification_time = 0;
 	singleton = this;
+
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	// Break the size class usage down per class, next to the built-in totals.
+	for (uint32_t i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		add_custom_monitor(vformat("memory/size_class_%d", (uint64_t)SizeClassAllocator::get_size_class_size(i)), callable_mp_static(&SizeClassAllocator::get_size_class_usage), varray(i));
+	}
+#endif
 }
 
 Performance::MonitorCall::MonitorCall(Callable p_callable, Vector<Variant> p_arguments) {
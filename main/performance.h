@@ -100,6 +100,12 @@ public:
 		NAVIGATION_EDGE_MERGE_COUNT,
 		NAVIGATION_EDGE_CONNECTION_COUNT,
 		NAVIGATION_EDGE_FREE_COUNT,
+		PHYSICS_3D_SLEEPING_OBJECTS,
+		NAVIGATION_ABSTRACT_NODE_COUNT,
+		NAVIGATION_ABSTRACT_EDGE_COUNT,
+		TIME_NAVIGATION_AVOIDANCE,
+		MEMORY_SIZE_CLASS_USAGE,
+		MEMORY_SIZE_CLASS_RESERVED,
 		MONITOR_MAX
 	};
 
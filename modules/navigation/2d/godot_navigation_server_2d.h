@@ -68,7 +68,12 @@ public:
 	virtual real_t map_get_edge_connection_margin(RID p_map) const override;
 	virtual void map_set_link_connection_radius(RID p_map, real_t p_connection_radius) override;
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) override;
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+	virtual void map_set_path_cache_size(RID p_map, int p_size) override;
+	virtual int map_get_path_cache_size(RID p_map) const override;
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
+	virtual Vector2 map_get_flow_field_direction(RID p_map, const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const override;
 	virtual Vector2 map_get_closest_point(RID p_map, const Vector2 &p_point) const override;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector2 &p_point) const override;
 	virtual TypedArray<RID> map_get_links(RID p_map) const override;
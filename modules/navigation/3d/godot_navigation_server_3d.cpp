@@ -237,6 +237,35 @@ real_t GodotNavigationServer3D::map_get_link_connection_radius(RID p_map) const
 	return map->get_link_connection_radius();
 }
 
+COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+
+	map->set_use_hierarchical_pathfinding(p_enabled);
+}
+
+bool GodotNavigationServer3D::map_get_use_hierarchical_pathfinding(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, false);
+
+	return map->get_use_hierarchical_pathfinding();
+}
+
+COMMAND_2(map_set_path_cache_size, RID, p_map, int, p_size) {
+	NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL(map);
+	ERR_FAIL_COND(p_size < 0);
+
+	map->set_path_cache_size(p_size);
+}
+
+int GodotNavigationServer3D::map_get_path_cache_size(RID p_map) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, 0);
+
+	return map->get_path_cache_size();
+}
+
 Vector<Vector3> GodotNavigationServer3D::map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL_V(map, Vector<Vector3>());
@@ -244,6 +273,13 @@ Vector<Vector3> GodotNavigationServer3D::map_get_path(RID p_map, Vector3 p_origi
 	return map->get_path(p_origin, p_destination, p_optimize, p_navigation_layers, nullptr, nullptr, nullptr);
 }
 
+Vector3 GodotNavigationServer3D::map_get_flow_field_direction(RID p_map, const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	const NavMap *map = map_owner.get_or_null(p_map);
+	ERR_FAIL_NULL_V(map, Vector3());
+
+	return map->get_flow_field_direction(p_target_position, p_position, p_navigation_layers);
+}
+
 Vector3 GodotNavigationServer3D::map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	const NavMap *map = map_owner.get_or_null(p_map);
 	ERR_FAIL_NULL_V(map, Vector3());
@@ -419,6 +455,9 @@ COMMAND_2(region_set_enter_cost, RID, p_region, real_t, p_enter_cost) {
 	ERR_FAIL_COND(p_enter_cost < 0.0);
 
 	region->set_enter_cost(p_enter_cost);
+	if (region->get_map()) {
+		region->get_map()->clear_query_caches();
+	}
 }
 
 real_t GodotNavigationServer3D::region_get_enter_cost(RID p_region) const {
@@ -434,6 +473,9 @@ COMMAND_2(region_set_travel_cost, RID, p_region, real_t, p_travel_cost) {
 	ERR_FAIL_COND(p_travel_cost < 0.0);
 
 	region->set_travel_cost(p_travel_cost);
+	if (region->get_map()) {
+		region->get_map()->clear_query_caches();
+	}
 }
 
 real_t GodotNavigationServer3D::region_get_travel_cost(RID p_region) const {
@@ -473,6 +515,9 @@ COMMAND_2(region_set_navigation_layers, RID, p_region, uint32_t, p_navigation_la
 	ERR_FAIL_NULL(region);
 
 	region->set_navigation_layers(p_navigation_layers);
+	if (region->get_map()) {
+		region->get_map()->clear_query_caches();
+	}
 }
 
 uint32_t GodotNavigationServer3D::region_get_navigation_layers(RID p_region) const {
@@ -595,6 +640,9 @@ COMMAND_2(link_set_navigation_layers, RID, p_link, uint32_t, p_navigation_layers
 	ERR_FAIL_NULL(link);
 
 	link->set_navigation_layers(p_navigation_layers);
+	if (link->get_map()) {
+		link->get_map()->clear_query_caches();
+	}
 }
 
 uint32_t GodotNavigationServer3D::link_get_navigation_layers(const RID p_link) const {
@@ -637,6 +685,9 @@ COMMAND_2(link_set_enter_cost, RID, p_link, real_t, p_enter_cost) {
 	ERR_FAIL_NULL(link);
 
 	link->set_enter_cost(p_enter_cost);
+	if (link->get_map()) {
+		link->get_map()->clear_query_caches();
+	}
 }
 
 real_t GodotNavigationServer3D::link_get_enter_cost(const RID p_link) const {
@@ -651,6 +702,9 @@ COMMAND_2(link_set_travel_cost, RID, p_link, real_t, p_travel_cost) {
 	ERR_FAIL_NULL(link);
 
 	link->set_travel_cost(p_travel_cost);
+	if (link->get_map()) {
+		link->get_map()->clear_query_caches();
+	}
 }
 
 real_t GodotNavigationServer3D::link_get_travel_cost(const RID p_link) const {
@@ -1131,6 +1185,16 @@ void GodotNavigationServer3D::bake_from_source_geometry_data_async(const Ref<Nav
 #endif // _3D_DISABLED
 }
 
+void GodotNavigationServer3D::bake_tile_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Vector2i &p_tile, const Callable &p_callback) {
+#ifndef _3D_DISABLED
+	ERR_FAIL_COND_MSG(!p_navigation_mesh.is_valid(), "Invalid navigation mesh.");
+	ERR_FAIL_COND_MSG(!p_source_geometry_data.is_valid(), "Invalid NavigationMeshSourceGeometryData3D.");
+
+	ERR_FAIL_NULL(NavMeshGenerator3D::get_singleton());
+	NavMeshGenerator3D::get_singleton()->bake_tile_from_source_geometry_data(p_navigation_mesh, p_source_geometry_data, p_tile, p_callback);
+#endif // _3D_DISABLED
+}
+
 bool GodotNavigationServer3D::is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const {
 #ifdef _3D_DISABLED
 	return false;
@@ -1242,6 +1306,9 @@ void GodotNavigationServer3D::set_active(bool p_active) {
 }
 
 void GodotNavigationServer3D::flush_queries() {
+	// Commands modify the maps, the async path queries reading them must be done.
+	_wait_path_queries();
+
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
 	MutexLock lock(commands_mutex);
@@ -1279,9 +1346,16 @@ void GodotNavigationServer3D::sync() {
 }
 
 void GodotNavigationServer3D::process(real_t p_delta_time) {
+	// Deliver the async path queries run since the last step, before the maps change.
+	_wait_path_queries();
+	_dispatch_path_queries();
+
 	flush_queries();
 
 	if (!active) {
+		// The maps aren't synchronized, but queued path queries still run against them as they are,
+		// like query_path() does, so their callbacks aren't held back until the server is active again.
+		_start_path_queries();
 		return;
 	}
 
@@ -1293,6 +1367,9 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	int _new_pm_edge_merge_count = 0;
 	int _new_pm_edge_connection_count = 0;
 	int _new_pm_edge_free_count = 0;
+	int _new_pm_abstract_node_count = 0;
+	int _new_pm_abstract_edge_count = 0;
+	int _new_pm_avoidance_time = 0;
 
 	// In c++ we can't be sure that this is performed in the main thread
 	// even with mutable functions.
@@ -1310,6 +1387,9 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 		_new_pm_edge_merge_count += active_maps[i]->get_pm_edge_merge_count();
 		_new_pm_edge_connection_count += active_maps[i]->get_pm_edge_connection_count();
 		_new_pm_edge_free_count += active_maps[i]->get_pm_edge_free_count();
+		_new_pm_abstract_node_count += active_maps[i]->get_pm_abstract_node_count();
+		_new_pm_abstract_edge_count += active_maps[i]->get_pm_abstract_edge_count();
+		_new_pm_avoidance_time += active_maps[i]->get_pm_avoidance_time();
 
 		// Emit a signal if a map changed.
 		const uint32_t new_map_iteration_id = active_maps[i]->get_iteration_id();
@@ -1327,6 +1407,12 @@ void GodotNavigationServer3D::process(real_t p_delta_time) {
 	pm_edge_merge_count = _new_pm_edge_merge_count;
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
+	pm_abstract_node_count = _new_pm_abstract_node_count;
+	pm_abstract_edge_count = _new_pm_abstract_edge_count;
+	pm_avoidance_time = _new_pm_avoidance_time;
+
+	// The maps stay unchanged until the next flush, run the queued path queries against them in the meantime.
+	_start_path_queries();
 }
 
 void GodotNavigationServer3D::init() {
@@ -1337,6 +1423,11 @@ void GodotNavigationServer3D::init() {
 
 void GodotNavigationServer3D::finish() {
 	flush_queries();
+	{
+		MutexLock lock(path_queries_mutex);
+		pending_path_queries.clear();
+	}
+	running_path_queries.clear();
 #ifndef _3D_DISABLED
 	if (navmesh_generator_3d) {
 		navmesh_generator_3d->finish();
@@ -1346,6 +1437,60 @@ void GodotNavigationServer3D::finish() {
 #endif // _3D_DISABLED
 }
 
+void GodotNavigationServer3D::query_path_async(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, Ref<NavigationPathQueryResult3D> p_query_result, const Callable &p_callback) {
+	ERR_FAIL_COND(!p_query_parameters.is_valid());
+	ERR_FAIL_COND(!p_query_result.is_valid());
+
+	PathQueryTask3D task;
+	task.parameters = p_query_parameters->get_parameters();
+	task.query_result = p_query_result;
+	task.callback = p_callback;
+
+	MutexLock lock(path_queries_mutex);
+	pending_path_queries.push_back(task);
+}
+
+void GodotNavigationServer3D::_start_path_queries() {
+	DEV_ASSERT(path_queries_group_id == -1);
+
+	{
+		MutexLock lock(path_queries_mutex);
+		if (pending_path_queries.is_empty()) {
+			return;
+		}
+		SWAP(running_path_queries, pending_path_queries);
+	}
+
+	path_queries_group_id = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotNavigationServer3D::_run_path_query, running_path_queries.ptr(), running_path_queries.size(), -1, true, SNAME("NavigationServer3DPathQueries"));
+}
+
+void GodotNavigationServer3D::_run_path_query(uint32_t p_index, PathQueryTask3D *p_tasks) {
+	PathQueryTask3D &task = p_tasks[p_index];
+	task.result = _query_path(task.parameters);
+}
+
+void GodotNavigationServer3D::_wait_path_queries() {
+	if (path_queries_group_id == -1) {
+		return;
+	}
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(path_queries_group_id);
+	path_queries_group_id = -1;
+}
+
+void GodotNavigationServer3D::_dispatch_path_queries() {
+	for (PathQueryTask3D &task : running_path_queries) {
+		task.query_result->set_path(task.result.path);
+		task.query_result->set_path_types(task.result.path_types);
+		task.query_result->set_path_rids(task.result.path_rids);
+		task.query_result->set_path_owner_ids(task.result.path_owner_ids);
+
+		if (task.callback.is_valid()) {
+			task.callback.call();
+		}
+	}
+	running_path_queries.clear();
+}
+
 PathQueryResult GodotNavigationServer3D::_query_path(const PathQueryParameters &p_parameters) const {
 	PathQueryResult r_query_result;
 
@@ -1415,6 +1560,15 @@ int GodotNavigationServer3D::get_process_info(ProcessInfo p_info) const {
 		case INFO_EDGE_FREE_COUNT: {
 			return pm_edge_free_count;
 		} break;
+		case INFO_ABSTRACT_NODE_COUNT: {
+			return pm_abstract_node_count;
+		} break;
+		case INFO_ABSTRACT_EDGE_COUNT: {
+			return pm_abstract_edge_count;
+		} break;
+		case INFO_AVOIDANCE_TIME: {
+			return pm_avoidance_time;
+		} break;
 	}
 
 	return 0;
@@ -37,6 +37,7 @@
 #include "../nav_obstacle.h"
 #include "../nav_region.h"
 
+#include "core/object/worker_thread_pool.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
 #include "core/templates/rid_owner.h"
@@ -86,6 +87,20 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	NavMeshGenerator3D *navmesh_generator_3d = nullptr;
 #endif // _3D_DISABLED
 
+	struct PathQueryTask3D {
+		NavigationUtilities::PathQueryParameters parameters;
+		NavigationUtilities::PathQueryResult result;
+		Ref<NavigationPathQueryResult3D> query_result;
+		Callable callback;
+	};
+
+	/// Async path queries are submitted to `pending_path_queries`, run after the map synchronization
+	/// while the maps can not change, and are delivered at the start of the next process step.
+	Mutex path_queries_mutex;
+	LocalVector<PathQueryTask3D> pending_path_queries;
+	LocalVector<PathQueryTask3D> running_path_queries;
+	WorkerThreadPool::GroupID path_queries_group_id = -1;
+
 	// Performance Monitor
 	int pm_region_count = 0;
 	int pm_agent_count = 0;
@@ -95,6 +110,9 @@ class GodotNavigationServer3D : public NavigationServer3D {
 	int pm_edge_merge_count = 0;
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
+	int pm_abstract_node_count = 0;
+	int pm_abstract_edge_count = 0;
+	int pm_avoidance_time = 0;
 
 public:
 	GodotNavigationServer3D();
@@ -129,7 +147,14 @@ public:
 	COMMAND_2(map_set_link_connection_radius, RID, p_map, real_t, p_connection_radius);
 	virtual real_t map_get_link_connection_radius(RID p_map) const override;
 
+	COMMAND_2(map_set_use_hierarchical_pathfinding, RID, p_map, bool, p_enabled);
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const override;
+
+	COMMAND_2(map_set_path_cache_size, RID, p_map, int, p_size);
+	virtual int map_get_path_cache_size(RID p_map) const override;
+
 	virtual Vector<Vector3> map_get_path(RID p_map, Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const override;
+	virtual Vector3 map_get_flow_field_direction(RID p_map, const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers = 1) const override;
 
 	virtual Vector3 map_get_closest_point_to_segment(RID p_map, const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision = false) const override;
 	virtual Vector3 map_get_closest_point(RID p_map, const Vector3 &p_point) const override;
@@ -262,6 +287,7 @@ public:
 	virtual void parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
 	virtual void bake_from_source_geometry_data_async(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Callable &p_callback = Callable()) override;
+	virtual void bake_tile_from_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Vector2i &p_tile, const Callable &p_callback = Callable()) override;
 	virtual bool is_baking_navigation_mesh(Ref<NavigationMesh> p_navigation_mesh) const override;
 
 	COMMAND_1(free, RID, p_object);
@@ -274,6 +300,7 @@ public:
 	virtual void sync() override;
 	virtual void finish() override;
 
+	virtual void query_path_async(const Ref<NavigationPathQueryParameters3D> &p_query_parameters, Ref<NavigationPathQueryResult3D> p_query_result, const Callable &p_callback = Callable()) override;
 	virtual NavigationUtilities::PathQueryResult _query_path(const NavigationUtilities::PathQueryParameters &p_parameters) const override;
 
 	int get_process_info(ProcessInfo p_info) const override;
@@ -281,6 +308,11 @@ public:
 private:
 	void internal_free_agent(RID p_object);
 	void internal_free_obstacle(RID p_object);
+
+	void _start_path_queries();
+	void _run_path_query(uint32_t p_index, PathQueryTask3D *p_tasks);
+	void _wait_path_queries();
+	void _dispatch_path_queries();
 };
 
 #undef COMMAND_1
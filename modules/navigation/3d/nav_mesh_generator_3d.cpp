@@ -65,11 +65,14 @@
 NavMeshGenerator3D *NavMeshGenerator3D::singleton = nullptr;
 Mutex NavMeshGenerator3D::baking_navmesh_mutex;
 Mutex NavMeshGenerator3D::generator_task_mutex;
+Mutex NavMeshGenerator3D::tile_cache_mutex;
 bool NavMeshGenerator3D::use_threads = true;
 bool NavMeshGenerator3D::baking_use_multiple_threads = true;
 bool NavMeshGenerator3D::baking_use_high_priority_threads = true;
 HashSet<Ref<NavigationMesh>> NavMeshGenerator3D::baking_navmeshes;
 HashMap<WorkerThreadPool::TaskID, NavMeshGenerator3D::NavMeshGeneratorTask3D *> NavMeshGenerator3D::generator_tasks;
+int NavMeshGenerator3D::tile_cache_size = 0;
+LRUCache<NavMeshGenerator3D::NavMeshTileKey3D, NavMeshGenerator3D::NavMeshTileResult3D, NavMeshGenerator3D::NavMeshTileKey3D> NavMeshGenerator3D::tile_cache;
 
 NavMeshGenerator3D *NavMeshGenerator3D::get_singleton() {
 	return singleton;
@@ -82,6 +85,11 @@ NavMeshGenerator3D::NavMeshGenerator3D() {
 	baking_use_multiple_threads = GLOBAL_GET("navigation/baking/thread_model/baking_use_multiple_threads");
 	baking_use_high_priority_threads = GLOBAL_GET("navigation/baking/thread_model/baking_use_high_priority_threads");
 
+	tile_cache_size = GLOBAL_GET("navigation/baking/tile_cache_size");
+	if (tile_cache_size > 0) {
+		tile_cache.set_capacity(tile_cache_size);
+	}
+
 	// Using threads might cause problems on certain exports or with the Editor on certain devices.
 	// This is the main switch to turn threaded navmesh baking off should the need arise.
 	use_threads = baking_use_multiple_threads && !Engine::get_singleton()->is_editor_hint();
@@ -140,6 +148,10 @@ void NavMeshGenerator3D::cleanup() {
 
 	generator_task_mutex.unlock();
 	baking_navmesh_mutex.unlock();
+
+	tile_cache_mutex.lock();
+	tile_cache.clear();
+	tile_cache_mutex.unlock();
 }
 
 void NavMeshGenerator3D::finish() {
@@ -226,6 +238,29 @@ void NavMeshGenerator3D::bake_from_source_geometry_data_async(Ref<NavigationMesh
 	generator_task_mutex.unlock();
 }
 
+void NavMeshGenerator3D::bake_tile_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Vector2i &p_tile, const Callable &p_callback) {
+	ERR_FAIL_COND(!p_navigation_mesh.is_valid());
+	ERR_FAIL_COND(!p_source_geometry_data.is_valid());
+	ERR_FAIL_COND_MSG(p_navigation_mesh->get_tile_size() <= 0.0, "NavigationMesh tile_size needs to be greater than zero to bake a single tile.");
+
+	if (is_baking(p_navigation_mesh)) {
+		ERR_FAIL_MSG("NavigationMesh is already baking. Wait for current bake to finish.");
+	}
+	baking_navmesh_mutex.lock();
+	baking_navmeshes.insert(p_navigation_mesh);
+	baking_navmesh_mutex.unlock();
+
+	generator_bake_tiles(p_navigation_mesh, p_source_geometry_data, &p_tile);
+
+	baking_navmesh_mutex.lock();
+	baking_navmeshes.erase(p_navigation_mesh);
+	baking_navmesh_mutex.unlock();
+
+	if (p_callback.is_valid()) {
+		generator_emit_callback(p_callback);
+	}
+}
+
 bool NavMeshGenerator3D::is_baking(Ref<NavigationMesh> p_navigation_mesh) {
 	baking_navmesh_mutex.lock();
 	bool baking = baking_navmeshes.has(p_navigation_mesh);
@@ -598,6 +633,11 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		return;
 	}
 
+	if (p_navigation_mesh->get_tile_size() > 0.0) {
+		generator_bake_tiles(p_navigation_mesh, p_source_geometry_data);
+		return;
+	}
+
 	const Vector<float> &vertices = p_source_geometry_data->get_vertices();
 	const Vector<int> &indices = p_source_geometry_data->get_indices();
 
@@ -605,91 +645,514 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 		return;
 	}
 
-	rcHeightfield *hf = nullptr;
-	rcCompactHeightfield *chf = nullptr;
-	rcContourSet *cset = nullptr;
-	rcPolyMesh *poly_mesh = nullptr;
-	rcPolyMeshDetail *detail_mesh = nullptr;
-	rcContext ctx;
+	const float *verts = vertices.ptr();
+	const int nverts = vertices.size() / 3;
+	const int *tris = indices.ptr();
+	const int ntris = indices.size() / 3;
 
-	// added to keep track of steps, no functionality right now
-	String bake_state = "";
+	rcConfig cfg;
+	generator_setup_config(p_navigation_mesh, cfg);
+
+	rcCalcBounds(verts, nverts, cfg.bmin, cfg.bmax);
+
+	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+	if (baking_aabb.has_volume()) {
+		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
+		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
+		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
+		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
+		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
+		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
+		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+	}
 
-	bake_state = "Setting up Configuration..."; // step #1
+	NavMeshTileResult3D result;
+	if (!generator_bake_recast(p_navigation_mesh, cfg, verts, nverts, tris, ntris, result)) {
+		return;
+	}
+
+	p_navigation_mesh->set_vertices(result.vertices);
+	p_navigation_mesh->clear_polygons();
+	for (const Vector<int> &polygon : result.polygons) {
+		p_navigation_mesh->add_polygon(polygon);
+	}
+}
+
+void NavMeshGenerator3D::generator_bake_tiles(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Vector2i *p_single_tile) {
+	const Vector<float> &vertices = p_source_geometry_data->get_vertices();
+	const Vector<int> &indices = p_source_geometry_data->get_indices();
+
+	// An empty tile is a valid result when replacing a single tile, it removes the tile from the navigation mesh.
+	const bool has_geometry = vertices.size() >= 3 && indices.size() >= 3;
+	if (!has_geometry && p_single_tile == nullptr) {
+		return;
+	}
 
 	const float *verts = vertices.ptr();
 	const int nverts = vertices.size() / 3;
 	const int *tris = indices.ptr();
-	const int ntris = indices.size() / 3;
-
-	float bmin[3], bmax[3];
-	rcCalcBounds(verts, nverts, bmin, bmax);
+	const int ntris = has_geometry ? indices.size() / 3 : 0;
 
 	rcConfig cfg;
-	memset(&cfg, 0, sizeof(cfg));
+	generator_setup_config(p_navigation_mesh, cfg);
+
+	// Tiles are aligned to a world grid of whole cells so that a tile always rasterizes the same way,
+	// no matter what else is part of the bake. This is what makes cached tiles reusable.
+	const int tile_cells = MAX(1, (int)Math::round(p_navigation_mesh->get_tile_size() / cfg.cs));
+	const float tile_world_size = tile_cells * cfg.cs;
 
-	cfg.cs = p_navigation_mesh->get_cell_size();
-	cfg.ch = p_navigation_mesh->get_cell_height();
+	// The border gives erosion and region partitioning enough of the neighboring geometry
+	// that both sides of a tile seam end up with matching edges.
+	cfg.borderSize = MAX(cfg.borderSize, cfg.walkableRadius + 3);
+	const float border_world_size = cfg.borderSize * cfg.cs;
+
+	if (nverts > 0) {
+		rcCalcBounds(verts, nverts, cfg.bmin, cfg.bmax);
+	}
+
+	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
+	if (baking_aabb.has_volume()) {
+		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
+		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
+		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
+		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
+		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
+		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
+		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
+	}
+
+	Rect2i tile_rect;
+	if (p_single_tile) {
+		tile_rect = Rect2i(*p_single_tile, Size2i(1, 1));
+	} else {
+		const Vector2i tile_from((int)Math::floor(cfg.bmin[0] / tile_world_size), (int)Math::floor(cfg.bmin[2] / tile_world_size));
+		const Vector2i tile_to((int)Math::floor(cfg.bmax[0] / tile_world_size), (int)Math::floor(cfg.bmax[2] / tile_world_size));
+		tile_rect = Rect2i(tile_from, tile_to - tile_from + Vector2i(1, 1));
+	}
+	ERR_FAIL_COND_MSG((int64_t)tile_rect.size.x * tile_rect.size.y > 65536, "NavigationMesh tile_size is too small for the size of the source geometry.");
+
+	uint32_t settings_hash = hash_murmur3_one_32(tile_cells);
+	settings_hash = hash_murmur3_one_float(cfg.cs, settings_hash);
+	settings_hash = hash_murmur3_one_float(cfg.ch, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.borderSize, settings_hash);
+	settings_hash = hash_murmur3_one_float(cfg.walkableSlopeAngle, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.walkableHeight, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.walkableClimb, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.walkableRadius, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.maxEdgeLen, settings_hash);
+	settings_hash = hash_murmur3_one_float(cfg.maxSimplificationError, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.minRegionArea, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.mergeRegionArea, settings_hash);
+	settings_hash = hash_murmur3_one_32(cfg.maxVertsPerPoly, settings_hash);
+	settings_hash = hash_murmur3_one_float(cfg.detailSampleDist, settings_hash);
+	settings_hash = hash_murmur3_one_float(cfg.detailSampleMaxError, settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_sample_partition_type(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_low_hanging_obstacles(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_ledge_spans(), settings_hash);
+	settings_hash = hash_murmur3_one_32(p_navigation_mesh->get_filter_walkable_low_height_spans(), settings_hash);
+	if (baking_aabb.has_volume()) {
+		for (int i = 0; i < 3; i++) {
+			settings_hash = hash_murmur3_one_float(cfg.bmin[i], settings_hash);
+			settings_hash = hash_murmur3_one_float(cfg.bmax[i], settings_hash);
+		}
+	}
+
+	LocalVector<NavMeshTileBake3D> tiles;
+	tiles.resize(tile_rect.size.x * tile_rect.size.y);
+	for (int z = 0; z < tile_rect.size.y; z++) {
+		for (int x = 0; x < tile_rect.size.x; x++) {
+			NavMeshTileBake3D &tile = tiles[z * tile_rect.size.x + x];
+			tile.navigation_mesh = p_navigation_mesh;
+			tile.config = &cfg;
+			tile.tile_world_size = tile_world_size;
+			tile.key.coords = tile_rect.position + Vector2i(x, z);
+			tile.key.settings_hash = settings_hash;
+			tile.source_vertices = verts;
+			tile.source_indices = tris;
+		}
+	}
+
+	// Assign every triangle to all tiles whose bordered bounds it overlaps.
+	for (int i = 0; i < ntris; i++) {
+		const float *v0 = &verts[tris[i * 3 + 0] * 3];
+		const float *v1 = &verts[tris[i * 3 + 1] * 3];
+		const float *v2 = &verts[tris[i * 3 + 2] * 3];
+
+		const int from_x = MAX((int)Math::floor((MIN(v0[0], MIN(v1[0], v2[0])) - border_world_size) / tile_world_size), tile_rect.position.x);
+		const int from_z = MAX((int)Math::floor((MIN(v0[2], MIN(v1[2], v2[2])) - border_world_size) / tile_world_size), tile_rect.position.y);
+		const int to_x = MIN((int)Math::floor((MAX(v0[0], MAX(v1[0], v2[0])) + border_world_size) / tile_world_size), tile_rect.position.x + tile_rect.size.x - 1);
+		const int to_z = MIN((int)Math::floor((MAX(v0[2], MAX(v1[2], v2[2])) + border_world_size) / tile_world_size), tile_rect.position.y + tile_rect.size.y - 1);
+
+		for (int z = from_z; z <= to_z; z++) {
+			for (int x = from_x; x <= to_x; x++) {
+				tiles[(z - tile_rect.position.y) * tile_rect.size.x + (x - tile_rect.position.x)].triangles.push_back(i);
+			}
+		}
+	}
+
+	LocalVector<NavMeshTileBake3D *> bake_tiles;
+	for (NavMeshTileBake3D &tile : tiles) {
+		if (!tile.triangles.is_empty()) {
+			bake_tiles.push_back(&tile);
+		}
+	}
+
+	if (use_threads && bake_tiles.size() > 1) {
+		// Native tasks can be awaited from within another pool task (e.g. an async bake) without starving the pool.
+		LocalVector<WorkerThreadPool::TaskID> tile_task_ids;
+		tile_task_ids.resize(bake_tiles.size());
+		for (uint32_t i = 0; i < bake_tiles.size(); i++) {
+			tile_task_ids[i] = WorkerThreadPool::get_singleton()->add_native_task(&NavMeshGenerator3D::generator_bake_tile_task, bake_tiles[i], NavMeshGenerator3D::baking_use_high_priority_threads, SNAME("NavMeshGeneratorBakeTile3D"));
+		}
+		for (WorkerThreadPool::TaskID tile_task_id : tile_task_ids) {
+			WorkerThreadPool::get_singleton()->wait_for_task_completion(tile_task_id);
+		}
+	} else {
+		for (NavMeshTileBake3D *tile : bake_tiles) {
+			generator_bake_tile_task(tile);
+		}
+	}
+
+	LocalVector<const NavMeshTileResult3D *> merge_tiles;
+	for (const NavMeshTileBake3D *tile : bake_tiles) {
+		merge_tiles.push_back(&tile->result);
+	}
+
+	NavMeshTileResult3D remaining_tiles;
+	if (p_single_tile) {
+		// Keep everything of the current navigation mesh outside of the replaced tile.
+		remaining_tiles.vertices = p_navigation_mesh->get_vertices();
+		const Rect2 tile_area(Vector2(*p_single_tile) * tile_world_size, Vector2(tile_world_size, tile_world_size));
+		for (int i = 0; i < p_navigation_mesh->get_polygon_count(); i++) {
+			const Vector<int> polygon = p_navigation_mesh->get_polygon(i);
+			if (polygon.is_empty()) {
+				continue;
+			}
+			Vector3 polygon_center;
+			for (int index : polygon) {
+				ERR_FAIL_INDEX(index, remaining_tiles.vertices.size());
+				polygon_center += remaining_tiles.vertices[index];
+			}
+			polygon_center /= polygon.size();
+			if (!tile_area.has_point(Vector2(polygon_center.x, polygon_center.z))) {
+				remaining_tiles.polygons.push_back(polygon);
+			}
+		}
+		merge_tiles.push_back(&remaining_tiles);
+	}
+
+	generator_merge_tiles(p_navigation_mesh, merge_tiles, tile_world_size, cfg.cs, MAX(cfg.walkableClimb, 1) * cfg.ch);
+}
+
+void NavMeshGenerator3D::generator_bake_tile_task(void *p_arg) {
+	NavMeshTileBake3D *tile = static_cast<NavMeshTileBake3D *>(p_arg);
+
+	LocalVector<float> tile_vertices;
+	LocalVector<int> tile_indices;
+	tile_vertices.resize(tile->triangles.size() * 9);
+	tile_indices.resize(tile->triangles.size() * 3);
+	for (uint32_t i = 0; i < tile->triangles.size(); i++) {
+		for (int j = 0; j < 3; j++) {
+			const float *vertex = &tile->source_vertices[tile->source_indices[tile->triangles[i] * 3 + j] * 3];
+			tile_vertices[i * 9 + j * 3 + 0] = vertex[0];
+			tile_vertices[i * 9 + j * 3 + 1] = vertex[1];
+			tile_vertices[i * 9 + j * 3 + 2] = vertex[2];
+			tile_indices[i * 3 + j] = i * 3 + j;
+		}
+	}
+
+	tile->key.geometry_hash = hash_murmur3_buffer(tile_vertices.ptr(), tile_vertices.size() * sizeof(float));
+	tile->key.geometry_check = hash_murmur3_buffer(tile_vertices.ptr(), tile_vertices.size() * sizeof(float), tile->key.geometry_hash);
+
+	if (tile_cache_size > 0) {
+		MutexLock lock(tile_cache_mutex);
+		const NavMeshTileResult3D *cached_result = tile_cache.getptr(tile->key);
+		if (cached_result) {
+			tile->result = *cached_result;
+			return;
+		}
+	}
+
+	rcConfig cfg = *tile->config;
+	const float tile_world_size = tile->tile_world_size;
+	const float border_world_size = cfg.borderSize * cfg.cs;
+
+	float tile_bmin[3], tile_bmax[3];
+	rcCalcBounds(tile_vertices.ptr(), tile_vertices.size() / 3, tile_bmin, tile_bmax);
+
+	cfg.bmin[0] = tile->key.coords.x * tile_world_size - border_world_size;
+	cfg.bmin[1] = MAX(cfg.bmin[1], tile_bmin[1]);
+	cfg.bmin[2] = tile->key.coords.y * tile_world_size - border_world_size;
+	cfg.bmax[0] = (tile->key.coords.x + 1) * tile_world_size + border_world_size;
+	cfg.bmax[1] = MIN(cfg.bmax[1], tile_bmax[1]);
+	cfg.bmax[2] = (tile->key.coords.y + 1) * tile_world_size + border_world_size;
+
+	if (cfg.bmin[1] <= cfg.bmax[1] && generator_bake_recast(tile->navigation_mesh, cfg, tile_vertices.ptr(), tile_vertices.size() / 3, tile_indices.ptr(), tile->triangles.size(), tile->result)) {
+		AABB baking_aabb = tile->navigation_mesh->get_filter_baking_aabb();
+		if (baking_aabb.has_volume()) {
+			// The tile grid can not follow the baking AABB, so polygons outside of it are dropped instead.
+			const Rect2 baking_area(tile->config->bmin[0], tile->config->bmin[2], tile->config->bmax[0] - tile->config->bmin[0], tile->config->bmax[2] - tile->config->bmin[2]);
+			Vector<Vector<int>> polygons;
+			for (const Vector<int> &polygon : tile->result.polygons) {
+				Vector3 polygon_center;
+				for (int index : polygon) {
+					polygon_center += tile->result.vertices[index];
+				}
+				polygon_center /= polygon.size();
+				if (baking_area.has_point(Vector2(polygon_center.x, polygon_center.z))) {
+					polygons.push_back(polygon);
+				}
+			}
+			tile->result.polygons = polygons;
+		}
+	} else {
+		tile->result = NavMeshTileResult3D();
+	}
+
+	if (tile_cache_size > 0) {
+		MutexLock lock(tile_cache_mutex);
+		tile_cache.insert(tile->key, tile->result);
+	}
+}
+
+void NavMeshGenerator3D::generator_merge_tiles(Ref<NavigationMesh> p_navigation_mesh, const LocalVector<const NavMeshTileResult3D *> &p_tiles, float p_tile_world_size, float p_cell_size, float p_height_tolerance) {
+	const float snap_epsilon = p_cell_size * 0.01f;
+	const int no_line = INT32_MAX;
+
+	struct LineVertex {
+		float offset = 0.0;
+		int vertex_id = -1;
+
+		bool operator<(const LineVertex &p_other) const { return offset < p_other.offset; }
+	};
+
+	LocalVector<Vector3> merged_vertices;
+	// Index of the tile boundary line of constant x and z each vertex lies on, or no_line.
+	LocalVector<Vector2i> vertex_lines;
+	LocalVector<LocalVector<int>> merged_polygons;
+	// Boundary vertices are welded by their horizontal position, as neighboring tiles sample slightly different heights.
+	HashMap<Vector2i, LocalVector<int>> boundary_vertices;
+	// Keyed by line index and axis, 0 for lines of constant x and 1 for lines of constant z.
+	HashMap<Vector2i, LocalVector<LineVertex>> boundary_lines;
+
+	auto snap_to_line = [&](float p_value, int &r_line) -> float {
+		const float line = Math::round(p_value / p_tile_world_size);
+		if (Math::abs(p_value - line * p_tile_world_size) <= snap_epsilon) {
+			r_line = (int)line;
+			return line * p_tile_world_size;
+		}
+		r_line = no_line;
+		return p_value;
+	};
+
+	auto add_vertex = [&](Vector3 p_vertex) -> int {
+		Vector2i lines;
+		p_vertex.x = snap_to_line(p_vertex.x, lines.x);
+		p_vertex.z = snap_to_line(p_vertex.z, lines.y);
+
+		if (lines.x == no_line && lines.y == no_line) {
+			merged_vertices.push_back(p_vertex);
+			vertex_lines.push_back(lines);
+			return merged_vertices.size() - 1;
+		}
+
+		LocalVector<int> &welded = boundary_vertices[Vector2i((int)Math::round(p_vertex.x / snap_epsilon), (int)Math::round(p_vertex.z / snap_epsilon))];
+		for (int vertex_id : welded) {
+			if (Math::abs(merged_vertices[vertex_id].y - p_vertex.y) <= p_height_tolerance) {
+				return vertex_id;
+			}
+		}
+
+		const int vertex_id = merged_vertices.size();
+		merged_vertices.push_back(p_vertex);
+		vertex_lines.push_back(lines);
+		welded.push_back(vertex_id);
+		if (lines.x != no_line) {
+			boundary_lines[Vector2i(lines.x, 0)].push_back({ p_vertex.z, vertex_id });
+		}
+		if (lines.y != no_line) {
+			boundary_lines[Vector2i(lines.y, 1)].push_back({ p_vertex.x, vertex_id });
+		}
+		return vertex_id;
+	};
+
+	for (const NavMeshTileResult3D *tile : p_tiles) {
+		LocalVector<int> vertex_ids;
+		vertex_ids.resize(tile->vertices.size());
+		for (int &vertex_id : vertex_ids) {
+			vertex_id = -1;
+		}
+
+		for (const Vector<int> &polygon : tile->polygons) {
+			LocalVector<int> merged_polygon;
+			for (int index : polygon) {
+				ERR_FAIL_INDEX(index, tile->vertices.size());
+				if (vertex_ids[index] == -1) {
+					vertex_ids[index] = add_vertex(tile->vertices[index]);
+				}
+				merged_polygon.push_back(vertex_ids[index]);
+			}
+			merged_polygons.push_back(merged_polygon);
+		}
+	}
+
+	auto share_line = [&](int p_a, int p_b, int p_axis) -> bool {
+		return vertex_lines[p_a][p_axis] != no_line && vertex_lines[p_a][p_axis] == vertex_lines[p_b][p_axis];
+	};
+
+	// Remove seam vertices inserted by a previous merge, the tile on the other side may have changed since.
+	for (LocalVector<int> &polygon : merged_polygons) {
+		for (uint32_t i = 0; polygon.size() > 3 && i < polygon.size();) {
+			const int prev = polygon[(i + polygon.size() - 1) % polygon.size()];
+			const int next = polygon[(i + 1) % polygon.size()];
+			if ((share_line(prev, polygon[i], 0) && share_line(polygon[i], next, 0)) || (share_line(prev, polygon[i], 1) && share_line(polygon[i], next, 1))) {
+				polygon.remove_at(i);
+			} else {
+				i++;
+			}
+		}
+	}
+
+	for (KeyValue<Vector2i, LocalVector<LineVertex>> &E : boundary_lines) {
+		E.value.sort();
+	}
+
+	// Split polygon edges on tile seams at every vertex of the neighboring tile so both sides share the exact same edges.
+	for (LocalVector<int> &polygon : merged_polygons) {
+		LocalVector<int> stitched_polygon;
+		for (uint32_t i = 0; i < polygon.size(); i++) {
+			const int a = polygon[i];
+			const int b = polygon[(i + 1) % polygon.size()];
+			stitched_polygon.push_back(a);
+
+			for (int axis = 0; axis < 2; axis++) {
+				if (!share_line(a, b, axis)) {
+					continue;
+				}
+
+				const LocalVector<LineVertex> &line = boundary_lines[Vector2i(vertex_lines[a][axis], axis)];
+				const int along = axis == 0 ? 2 : 0;
+				const float from = merged_vertices[a][along];
+				const float to = merged_vertices[b][along];
+				const float low = MIN(from, to) + snap_epsilon;
+				const float high = MAX(from, to) - snap_epsilon;
+
+				// Binary search for the first line vertex past the lower edge end.
+				uint32_t first = 0;
+				uint32_t last = line.size();
+				while (first < last) {
+					const uint32_t middle = (first + last) / 2;
+					if (line[middle].offset < low) {
+						first = middle + 1;
+					} else {
+						last = middle;
+					}
+				}
+
+				LocalVector<int> splits;
+				for (uint32_t j = first; j < line.size() && line[j].offset <= high; j++) {
+					const int vertex_id = line[j].vertex_id;
+					const float weight = (line[j].offset - from) / (to - from);
+					const float edge_height = Math::lerp(merged_vertices[a].y, merged_vertices[b].y, weight);
+					if (vertex_id != a && vertex_id != b && Math::abs(merged_vertices[vertex_id].y - edge_height) <= p_height_tolerance) {
+						splits.push_back(vertex_id);
+					}
+				}
+				if (from > to) {
+					splits.invert();
+				}
+				for (int vertex_id : splits) {
+					stitched_polygon.push_back(vertex_id);
+				}
+				break;
+			}
+		}
+		polygon = stitched_polygon;
+	}
+
+	Vector<Vector3> nav_vertices;
+	nav_vertices.resize(merged_vertices.size());
+	for (uint32_t i = 0; i < merged_vertices.size(); i++) {
+		nav_vertices.write[i] = merged_vertices[i];
+	}
+	p_navigation_mesh->set_vertices(nav_vertices);
+	p_navigation_mesh->clear_polygons();
+
+	for (const LocalVector<int> &polygon : merged_polygons) {
+		Vector<int> nav_indices;
+		nav_indices.resize(polygon.size());
+		for (uint32_t i = 0; i < polygon.size(); i++) {
+			nav_indices.write[i] = polygon[i];
+		}
+		p_navigation_mesh->add_polygon(nav_indices);
+	}
+}
+
+void NavMeshGenerator3D::generator_setup_config(const Ref<NavigationMesh> &p_navigation_mesh, rcConfig &r_cfg) {
+	memset(&r_cfg, 0, sizeof(r_cfg));
+
+	r_cfg.cs = p_navigation_mesh->get_cell_size();
+	r_cfg.ch = p_navigation_mesh->get_cell_height();
 	if (p_navigation_mesh->get_border_size() > 0.0) {
-		cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / cfg.cs);
-	}
-	cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
-	cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / cfg.ch);
-	cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / cfg.ch);
-	cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / cfg.cs);
-	cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
-	cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
-	cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
-	cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
-	cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
-	cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
-	cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
+		r_cfg.borderSize = (int)Math::ceil(p_navigation_mesh->get_border_size() / r_cfg.cs);
+	}
+	r_cfg.walkableSlopeAngle = p_navigation_mesh->get_agent_max_slope();
+	r_cfg.walkableHeight = (int)Math::ceil(p_navigation_mesh->get_agent_height() / r_cfg.ch);
+	r_cfg.walkableClimb = (int)Math::floor(p_navigation_mesh->get_agent_max_climb() / r_cfg.ch);
+	r_cfg.walkableRadius = (int)Math::ceil(p_navigation_mesh->get_agent_radius() / r_cfg.cs);
+	r_cfg.maxEdgeLen = (int)(p_navigation_mesh->get_edge_max_length() / p_navigation_mesh->get_cell_size());
+	r_cfg.maxSimplificationError = p_navigation_mesh->get_edge_max_error();
+	r_cfg.minRegionArea = (int)(p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size());
+	r_cfg.mergeRegionArea = (int)(p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size());
+	r_cfg.maxVertsPerPoly = (int)p_navigation_mesh->get_vertices_per_polygon();
+	r_cfg.detailSampleDist = MAX(p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance(), 0.1f);
+	r_cfg.detailSampleMaxError = p_navigation_mesh->get_cell_height() * p_navigation_mesh->get_detail_sample_max_error();
 
 	if (p_navigation_mesh->get_border_size() > 0.0 && !Math::is_equal_approx(p_navigation_mesh->get_cell_size(), p_navigation_mesh->get_border_size())) {
 		WARN_PRINT("Property border_size is ceiled to cell_size voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.walkableHeight * cfg.ch, p_navigation_mesh->get_agent_height())) {
+	if (!Math::is_equal_approx((float)r_cfg.walkableHeight * r_cfg.ch, p_navigation_mesh->get_agent_height())) {
 		WARN_PRINT("Property agent_height is ceiled to cell_height voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.walkableClimb * cfg.ch, p_navigation_mesh->get_agent_max_climb())) {
+	if (!Math::is_equal_approx((float)r_cfg.walkableClimb * r_cfg.ch, p_navigation_mesh->get_agent_max_climb())) {
 		WARN_PRINT("Property agent_max_climb is floored to cell_height voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.walkableRadius * cfg.cs, p_navigation_mesh->get_agent_radius())) {
+	if (!Math::is_equal_approx((float)r_cfg.walkableRadius * r_cfg.cs, p_navigation_mesh->get_agent_radius())) {
 		WARN_PRINT("Property agent_radius is ceiled to cell_size voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.maxEdgeLen * cfg.cs, p_navigation_mesh->get_edge_max_length())) {
+	if (!Math::is_equal_approx((float)r_cfg.maxEdgeLen * r_cfg.cs, p_navigation_mesh->get_edge_max_length())) {
 		WARN_PRINT("Property edge_max_length is rounded to cell_size voxel units and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
+	if (!Math::is_equal_approx((float)r_cfg.minRegionArea, p_navigation_mesh->get_region_min_size() * p_navigation_mesh->get_region_min_size())) {
 		WARN_PRINT("Property region_min_size is converted to int and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
+	if (!Math::is_equal_approx((float)r_cfg.mergeRegionArea, p_navigation_mesh->get_region_merge_size() * p_navigation_mesh->get_region_merge_size())) {
 		WARN_PRINT("Property region_merge_size is converted to int and loses precision.");
 	}
-	if (!Math::is_equal_approx((float)cfg.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
+	if (!Math::is_equal_approx((float)r_cfg.maxVertsPerPoly, p_navigation_mesh->get_vertices_per_polygon())) {
 		WARN_PRINT("Property vertices_per_polygon is converted to int and loses precision.");
 	}
 	if (p_navigation_mesh->get_cell_size() * p_navigation_mesh->get_detail_sample_distance() < 0.1f) {
 		WARN_PRINT("Property detail_sample_distance is clamped to 0.1 world units as the resulting value from multiplying with cell_size is too low.");
 	}
+}
 
-	cfg.bmin[0] = bmin[0];
-	cfg.bmin[1] = bmin[1];
-	cfg.bmin[2] = bmin[2];
-	cfg.bmax[0] = bmax[0];
-	cfg.bmax[1] = bmax[1];
-	cfg.bmax[2] = bmax[2];
+bool NavMeshGenerator3D::generator_bake_recast(const Ref<NavigationMesh> &p_navigation_mesh, rcConfig &p_cfg, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, NavMeshTileResult3D &r_result) {
+	rcHeightfield *hf = nullptr;
+	rcCompactHeightfield *chf = nullptr;
+	rcContourSet *cset = nullptr;
+	rcPolyMesh *poly_mesh = nullptr;
+	rcPolyMeshDetail *detail_mesh = nullptr;
+	rcContext ctx;
 
-	AABB baking_aabb = p_navigation_mesh->get_filter_baking_aabb();
-	if (baking_aabb.has_volume()) {
-		Vector3 baking_aabb_offset = p_navigation_mesh->get_filter_baking_aabb_offset();
-		cfg.bmin[0] = baking_aabb.position[0] + baking_aabb_offset.x;
-		cfg.bmin[1] = baking_aabb.position[1] + baking_aabb_offset.y;
-		cfg.bmin[2] = baking_aabb.position[2] + baking_aabb_offset.z;
-		cfg.bmax[0] = cfg.bmin[0] + baking_aabb.size[0];
-		cfg.bmax[1] = cfg.bmin[1] + baking_aabb.size[1];
-		cfg.bmax[2] = cfg.bmin[2] + baking_aabb.size[2];
-	}
+	rcConfig &cfg = p_cfg;
+	const float *verts = p_verts;
+	const int nverts = p_nverts;
+	const int *tris = p_tris;
+	const int ntris = p_ntris;
+
+	// added to keep track of steps, no functionality right now
+	String bake_state = "";
 
 	bake_state = "Calculating grid size..."; // step #2
 	rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
@@ -705,20 +1168,20 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	bake_state = "Creating heightfield..."; // step #3
 	hf = rcAllocHeightfield();
 
-	ERR_FAIL_NULL(hf);
-	ERR_FAIL_COND(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch));
+	ERR_FAIL_NULL_V(hf, false);
+	ERR_FAIL_COND_V(!rcCreateHeightfield(&ctx, *hf, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch), false);
 
 	bake_state = "Marking walkable triangles..."; // step #4
 	{
 		Vector<unsigned char> tri_areas;
 		tri_areas.resize(ntris);
 
-		ERR_FAIL_COND(tri_areas.is_empty());
+		ERR_FAIL_COND_V(tri_areas.is_empty(), false);
 
 		memset(tri_areas.ptrw(), 0, ntris * sizeof(unsigned char));
 		rcMarkWalkableTriangles(&ctx, cfg.walkableSlopeAngle, verts, nverts, tris, ntris, tri_areas.ptrw());
 
-		ERR_FAIL_COND(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb));
+		ERR_FAIL_COND_V(!rcRasterizeTriangles(&ctx, verts, nverts, tris, tri_areas.ptr(), ntris, *hf, cfg.walkableClimb), false);
 	}
 
 	if (p_navigation_mesh->get_filter_low_hanging_obstacles()) {
@@ -735,43 +1198,43 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	chf = rcAllocCompactHeightfield();
 
-	ERR_FAIL_NULL(chf);
-	ERR_FAIL_COND(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf));
+	ERR_FAIL_NULL_V(chf, false);
+	ERR_FAIL_COND_V(!rcBuildCompactHeightfield(&ctx, cfg.walkableHeight, cfg.walkableClimb, *hf, *chf), false);
 
 	rcFreeHeightField(hf);
 	hf = nullptr;
 
 	bake_state = "Eroding walkable area..."; // step #6
 
-	ERR_FAIL_COND(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf));
+	ERR_FAIL_COND_V(!rcErodeWalkableArea(&ctx, cfg.walkableRadius, *chf), false);
 
 	bake_state = "Partitioning..."; // step #7
 
 	if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_WATERSHED) {
-		ERR_FAIL_COND(!rcBuildDistanceField(&ctx, *chf));
-		ERR_FAIL_COND(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND_V(!rcBuildDistanceField(&ctx, *chf), false);
+		ERR_FAIL_COND_V(!rcBuildRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
 	} else if (p_navigation_mesh->get_sample_partition_type() == NavigationMesh::SAMPLE_PARTITION_MONOTONE) {
-		ERR_FAIL_COND(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea));
+		ERR_FAIL_COND_V(!rcBuildRegionsMonotone(&ctx, *chf, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea), false);
 	} else {
-		ERR_FAIL_COND(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea));
+		ERR_FAIL_COND_V(!rcBuildLayerRegions(&ctx, *chf, cfg.borderSize, cfg.minRegionArea), false);
 	}
 
 	bake_state = "Creating contours..."; // step #8
 
 	cset = rcAllocContourSet();
 
-	ERR_FAIL_NULL(cset);
-	ERR_FAIL_COND(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset));
+	ERR_FAIL_NULL_V(cset, false);
+	ERR_FAIL_COND_V(!rcBuildContours(&ctx, *chf, cfg.maxSimplificationError, cfg.maxEdgeLen, *cset), false);
 
 	bake_state = "Creating polymesh..."; // step #9
 
 	poly_mesh = rcAllocPolyMesh();
-	ERR_FAIL_NULL(poly_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh));
+	ERR_FAIL_NULL_V(poly_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMesh(&ctx, *cset, cfg.maxVertsPerPoly, *poly_mesh), false);
 
 	detail_mesh = rcAllocPolyMeshDetail();
-	ERR_FAIL_NULL(detail_mesh);
-	ERR_FAIL_COND(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh));
+	ERR_FAIL_NULL_V(detail_mesh, false);
+	ERR_FAIL_COND_V(!rcBuildPolyMeshDetail(&ctx, *poly_mesh, *chf, cfg.detailSampleDist, cfg.detailSampleMaxError, *detail_mesh), false);
 
 	rcFreeCompactHeightfield(chf);
 	chf = nullptr;
@@ -780,14 +1243,11 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 
 	bake_state = "Converting to native navigation mesh..."; // step #10
 
-	Vector<Vector3> nav_vertices;
-
+	r_result.vertices.resize(detail_mesh->nverts);
 	for (int i = 0; i < detail_mesh->nverts; i++) {
 		const float *v = &detail_mesh->verts[i * 3];
-		nav_vertices.push_back(Vector3(v[0], v[1], v[2]));
+		r_result.vertices.write[i] = Vector3(v[0], v[1], v[2]);
 	}
-	p_navigation_mesh->set_vertices(nav_vertices);
-	p_navigation_mesh->clear_polygons();
 
 	for (int i = 0; i < detail_mesh->nmeshes; i++) {
 		const unsigned int *detail_mesh_m = &detail_mesh->meshes[i * 4];
@@ -802,7 +1262,7 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 			nav_indices.write[0] = ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 0]));
 			nav_indices.write[1] = ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 2]));
 			nav_indices.write[2] = ((int)(detail_mesh_bverts + detail_mesh_tris[j * 4 + 1]));
-			p_navigation_mesh->add_polygon(nav_indices);
+			r_result.polygons.push_back(nav_indices);
 		}
 	}
 
@@ -814,6 +1274,8 @@ void NavMeshGenerator3D::generator_bake_from_source_geometry_data(Ref<Navigation
 	detail_mesh = nullptr;
 
 	bake_state = "Baking finished."; // step #12
+
+	return true;
 }
 
 bool NavMeshGenerator3D::generator_emit_callback(const Callable &p_callback) {
@@ -35,11 +35,13 @@
 
 #include "core/object/class_db.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/templates/lru.h"
 #include "modules/modules_enabled.gen.h" // For csg, gridmap.
 
 class Node;
 class NavigationMesh;
 class NavigationMeshSourceGeometryData3D;
+struct rcConfig;
 
 class NavMeshGenerator3D : public Object {
 	static NavMeshGenerator3D *singleton;
@@ -73,9 +75,55 @@ class NavMeshGenerator3D : public Object {
 
 	static HashSet<Ref<NavigationMesh>> baking_navmeshes;
 
+	struct NavMeshTileResult3D {
+		Vector<Vector3> vertices;
+		Vector<Vector<int>> polygons;
+	};
+
+	struct NavMeshTileKey3D {
+		Vector2i coords;
+		// Two hashes of the tile geometry with different seeds make collisions between edits practically impossible.
+		uint32_t geometry_hash = 0;
+		uint32_t geometry_check = 0;
+		uint32_t settings_hash = 0;
+
+		static uint32_t hash(const NavMeshTileKey3D &p_key) {
+			uint32_t h = hash_murmur3_one_32(p_key.coords.x);
+			h = hash_murmur3_one_32(p_key.coords.y, h);
+			h = hash_murmur3_one_32(p_key.geometry_hash, h);
+			h = hash_murmur3_one_32(p_key.geometry_check, h);
+			h = hash_murmur3_one_32(p_key.settings_hash, h);
+			return hash_fmix32(h);
+		}
+
+		bool operator==(const NavMeshTileKey3D &p_key) const {
+			return coords == p_key.coords && geometry_hash == p_key.geometry_hash && geometry_check == p_key.geometry_check && settings_hash == p_key.settings_hash;
+		}
+	};
+
+	struct NavMeshTileBake3D {
+		Ref<NavigationMesh> navigation_mesh;
+		const rcConfig *config = nullptr;
+		float tile_world_size = 0.0;
+		NavMeshTileKey3D key;
+		const float *source_vertices = nullptr;
+		const int *source_indices = nullptr;
+		LocalVector<int> triangles;
+		NavMeshTileResult3D result;
+	};
+
+	static Mutex tile_cache_mutex;
+	static int tile_cache_size;
+	static LRUCache<NavMeshTileKey3D, NavMeshTileResult3D, NavMeshTileKey3D> tile_cache;
+
 	static void generator_parse_geometry_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node, bool p_recurse_children);
 	static void generator_parse_source_geometry_data(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_root_node);
 	static void generator_bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data);
+	static void generator_bake_tiles(Ref<NavigationMesh> p_navigation_mesh, const Ref<NavigationMeshSourceGeometryData3D> &p_source_geometry_data, const Vector2i *p_single_tile = nullptr);
+	static void generator_bake_tile_task(void *p_arg);
+	static void generator_merge_tiles(Ref<NavigationMesh> p_navigation_mesh, const LocalVector<const NavMeshTileResult3D *> &p_tiles, float p_tile_world_size, float p_cell_size, float p_height_tolerance);
+	static void generator_setup_config(const Ref<NavigationMesh> &p_navigation_mesh, rcConfig &r_cfg);
+	static bool generator_bake_recast(const Ref<NavigationMesh> &p_navigation_mesh, rcConfig &p_cfg, const float *p_verts, int p_nverts, const int *p_tris, int p_ntris, NavMeshTileResult3D &r_result);
 
 	static void generator_parse_meshinstance3d_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node);
 	static void generator_parse_multimeshinstance3d_node(const Ref<NavigationMesh> &p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_node);
@@ -99,6 +147,7 @@ public:
 	static void parse_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, Node *p_root_node, const Callable &p_callback = Callable());
 	static void bake_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback = Callable());
 	static void bake_from_source_geometry_data_async(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Callable &p_callback = Callable());
+	static void bake_tile_from_source_geometry_data(Ref<NavigationMesh> p_navigation_mesh, Ref<NavigationMeshSourceGeometryData3D> p_source_geometry_data, const Vector2i &p_tile, const Callable &p_callback = Callable());
 	static bool is_baking(Ref<NavigationMesh> p_navigation_mesh);
 
 	NavMeshGenerator3D();
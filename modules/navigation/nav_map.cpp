@@ -36,7 +36,9 @@
 #include "nav_region.h"
 
 #include "core/config/project_settings.h"
+#include "core/os/os.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/templates/sort_array.h"
 
 #include <Obstacle2d.h>
 
@@ -103,6 +105,7 @@ void NavMap::set_use_edge_connections(bool p_enabled) {
 		return;
 	}
 	use_edge_connections = p_enabled;
+	regenerate_region_connections = true;
 	regenerate_links = true;
 }
 
@@ -111,6 +114,7 @@ void NavMap::set_edge_connection_margin(real_t p_edge_connection_margin) {
 		return;
 	}
 	edge_connection_margin = p_edge_connection_margin;
+	regenerate_region_connections = true;
 	regenerate_links = true;
 }
 
@@ -122,6 +126,35 @@ void NavMap::set_link_connection_radius(real_t p_link_connection_radius) {
 	regenerate_links = true;
 }
 
+void NavMap::set_path_cache_size(int p_size) {
+	MutexLock lock(path_cache_mutex);
+	path_cache_size = MAX(p_size, 0);
+	path_cache.clear();
+	if (path_cache_size > 0) {
+		path_cache.set_capacity(path_cache_size);
+	}
+}
+
+void NavMap::clear_query_caches() {
+	path_cache_mutex.lock();
+	path_cache.clear();
+	path_cache_mutex.unlock();
+
+	MutexLock lock(flow_field_mutex);
+	for (FlowField *flow_field : flow_fields) {
+		memdelete(flow_field);
+	}
+	flow_fields.clear();
+}
+
+void NavMap::set_use_hierarchical_pathfinding(bool p_enabled) {
+	if (use_hierarchical_pathfinding == p_enabled) {
+		return;
+	}
+	use_hierarchical_pathfinding = p_enabled;
+	regenerate_links = true;
+}
+
 gd::PointKey NavMap::get_point_key(const Vector3 &p_pos) const {
 	const int x = static_cast<int>(Math::floor(p_pos.x / merge_rasterizer_cell_size));
 	const int y = static_cast<int>(Math::floor(p_pos.y / merge_rasterizer_cell_height));
@@ -154,40 +187,11 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	}
 
 	// Find the start poly and the end poly on this map.
-	const gd::Polygon *begin_poly = nullptr;
-	const gd::Polygon *end_poly = nullptr;
 	Vector3 begin_point;
 	Vector3 end_point;
-	real_t begin_d = FLT_MAX;
+	const gd::Polygon *begin_poly = _get_closest_polygon(p_origin, true, p_navigation_layers, FLT_MAX, begin_point);
+	const gd::Polygon *end_poly = _get_closest_polygon(p_destination, true, p_navigation_layers, FLT_MAX, end_point);
 	real_t end_d = FLT_MAX;
-	// Find the initial poly and the end poly on this map.
-	for (const gd::Polygon &p : polygons) {
-		// Only consider the polygon if it in a region with compatible layers.
-		if ((p_navigation_layers & p.owner->get_navigation_layers()) == 0) {
-			continue;
-		}
-
-		// For each face check the distance between the origin/destination
-		for (size_t point_id = 2; point_id < p.points.size(); point_id++) {
-			const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-
-			Vector3 point = face.get_closest_point_to(p_origin);
-			real_t distance_to_point = point.distance_to(p_origin);
-			if (distance_to_point < begin_d) {
-				begin_d = distance_to_point;
-				begin_poly = &p;
-				begin_point = point;
-			}
-
-			point = face.get_closest_point_to(p_destination);
-			distance_to_point = point.distance_to(p_destination);
-			if (distance_to_point < end_d) {
-				end_d = distance_to_point;
-				end_poly = &p;
-				end_point = point;
-			}
-		}
-	}
 
 	// Check for trivial cases
 	if (!begin_poly || !end_poly) {
@@ -221,30 +225,47 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 	// List of all reachable navigation polys.
 	LocalVector<gd::NavigationPoly> navigation_polys;
-	navigation_polys.reserve(polygons.size() * 0.75);
 
-	// Add the start polygon to the reachable navigation polygons.
-	gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
-	begin_navigation_poly.self_id = 0;
-	begin_navigation_poly.entry = begin_point;
-	begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
-	begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
-	navigation_polys.push_back(begin_navigation_poly);
+	// Reuse the polygon route of an earlier query between the same polygons, only the path points depend on the exact positions.
+	const PathCacheKey path_cache_key(begin_poly, end_poly, p_navigation_layers, iteration_id);
+	bool use_path_cache = false;
+	{
+		// The size can be changed from another thread while queries run.
+		MutexLock lock(path_cache_mutex);
+		use_path_cache = path_cache_size > 0;
+	}
+	const bool path_cached = use_path_cache && _get_cached_route(path_cache_key, begin_point, navigation_polys);
+
+	if (!path_cached) {
+		navigation_polys.reserve(pm_polygon_count * 0.75);
+
+		// Add the start polygon to the reachable navigation polygons.
+		gd::NavigationPoly begin_navigation_poly = gd::NavigationPoly(begin_poly);
+		begin_navigation_poly.self_id = 0;
+		begin_navigation_poly.entry = begin_point;
+		begin_navigation_poly.back_navigation_edge_pathway_start = begin_point;
+		begin_navigation_poly.back_navigation_edge_pathway_end = begin_point;
+		navigation_polys.push_back(begin_navigation_poly);
+	}
+
+	// Plan over the abstract graph first and keep the polygon search inside the clusters along that plan.
+	HashSet<const NavBase *> corridor;
+	bool use_corridor = !path_cached && use_hierarchical_pathfinding && _get_hierarchy_corridor(begin_poly, begin_point, end_poly, end_point, p_navigation_layers, corridor);
 
 	// List of polygon IDs to visit.
 	List<uint32_t> to_visit;
 	to_visit.push_back(0);
 
 	// This is an implementation of the A* algorithm.
-	int least_cost_id = 0;
+	int least_cost_id = path_cached ? navigation_polys.size() - 1 : 0;
 	int prev_least_cost_id = -1;
-	bool found_route = false;
+	bool found_route = path_cached;
 
 	const gd::Polygon *reachable_end = nullptr;
 	real_t reachable_d = FLT_MAX;
 	bool is_reachable = true;
 
-	while (true) {
+	while (!found_route) {
 		// Takes the current least_cost_poly neighbors (iterating over its edges) and compute the traveled_distance.
 		for (const gd::Edge &edge : navigation_polys[least_cost_id].poly->edges) {
 			// Iterate over connections in this edge, then compute the new optimized travel distance assigned to this polygon.
@@ -256,6 +277,10 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 					continue;
 				}
 
+				if (use_corridor && !corridor.has(connection.polygon->owner)) {
+					continue;
+				}
+
 				const gd::NavigationPoly &least_cost_poly = navigation_polys[least_cost_id];
 				real_t poly_enter_cost = 0.0;
 				real_t poly_travel_cost = least_cost_poly.poly->owner->get_travel_cost();
@@ -305,6 +330,24 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 
 		// When the list of polygons to visit is empty at this point it means the End Polygon is not reachable
 		if (to_visit.size() == 0) {
+			if (use_corridor) {
+				// The abstract plan is built from estimated distances, search the whole map before giving up.
+				use_corridor = false;
+
+				gd::NavigationPoly np = navigation_polys[0];
+				navigation_polys.clear();
+				navigation_polys.push_back(np);
+				to_visit.clear();
+				to_visit.push_back(0);
+				least_cost_id = 0;
+				prev_least_cost_id = -1;
+
+				reachable_end = nullptr;
+				reachable_d = FLT_MAX;
+
+				continue;
+			}
+
 			// Thus use the further reachable polygon
 			ERR_BREAK_MSG(is_reachable == false, "It's not expect to not find the most reachable polygons");
 			is_reachable = false;
@@ -451,6 +494,10 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 		return path;
 	}
 
+	if (use_path_cache && !path_cached && is_reachable) {
+		_cache_route(path_cache_key, navigation_polys, least_cost_id);
+	}
+
 	Vector<Vector3> path;
 	// Optimize the path.
 	if (p_optimize) {
@@ -600,6 +647,72 @@ Vector<Vector3> NavMap::get_path(Vector3 p_origin, Vector3 p_destination, bool p
 	return path;
 }
 
+Vector3 NavMap::get_flow_field_direction(const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers) const {
+	RWLockRead read_lock(map_rwlock);
+	if (iteration_id == 0) {
+		NAVMAP_ITERATION_ZERO_ERROR_MSG();
+		return Vector3();
+	}
+
+	MutexLock lock(flow_field_mutex);
+
+	if (polygon_grid_iteration_id != iteration_id) {
+		_update_polygon_grid();
+	}
+
+	FlowField *flow_field = nullptr;
+	for (FlowField *existing_flow_field : flow_fields) {
+		if (existing_flow_field->target_position == p_target_position && existing_flow_field->navigation_layers == p_navigation_layers) {
+			flow_field = existing_flow_field;
+			break;
+		}
+	}
+
+	if (!flow_field) {
+		if (flow_fields.size() >= FLOW_FIELD_MAX_COUNT) {
+			// Replace the least recently used flow field.
+			uint32_t oldest_index = 0;
+			for (uint32_t i = 1; i < flow_fields.size(); i++) {
+				if (flow_fields[i]->last_used < flow_fields[oldest_index]->last_used) {
+					oldest_index = i;
+				}
+			}
+			memdelete(flow_fields[oldest_index]);
+			flow_fields.remove_at_unordered(oldest_index);
+		}
+		flow_field = memnew(FlowField);
+		flow_field->target_position = p_target_position;
+		flow_field->navigation_layers = p_navigation_layers;
+		flow_fields.push_back(flow_field);
+	}
+	flow_field->last_used = ++flow_field_use_count;
+
+	if (flow_field->iteration_id != iteration_id) {
+		_update_flow_field(*flow_field);
+	}
+
+	const gd::Polygon *polygon = _get_grid_polygon(p_position, p_navigation_layers);
+	if (!polygon) {
+		return Vector3();
+	}
+
+	const FlowFieldNode *node = flow_field->nodes.getptr(polygon);
+	if (!node) {
+		// The target can not be reached from this polygon.
+		return Vector3();
+	}
+
+	Vector3 direction = node->waypoint - p_position;
+	if (direction.is_zero_approx() && node->next_polygon) {
+		// Standing right on the pathway, head for the one after it.
+		const FlowFieldNode *next_node = flow_field->nodes.getptr(node->next_polygon);
+		if (next_node) {
+			direction = next_node->waypoint - p_position;
+		}
+	}
+	return direction.normalized();
+}
+
 Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const {
 	RWLockRead read_lock(map_rwlock);
 	if (iteration_id == 0) {
@@ -611,40 +724,47 @@ Vector3 NavMap::get_closest_point_to_segment(const Vector3 &p_from, const Vector
 	Vector3 closest_point;
 	real_t closest_point_d = FLT_MAX;
 
-	for (const gd::Polygon &p : polygons) {
-		// For each face check the distance to the segment
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			Vector3 inters;
-			if (f.intersects_segment(p_from, p_to, &inters)) {
-				const real_t d = closest_point_d = p_from.distance_to(inters);
-				if (use_collision == false) {
-					closest_point = inters;
-					use_collision = true;
-					closest_point_d = d;
-				} else if (closest_point_d > d) {
-					closest_point = inters;
-					closest_point_d = d;
-				}
-			}
+	for (NavRegion *region : regions) {
+		const RegionCache *cache = region_caches.getptr(region);
+		if (!cache || !cache->indexed) {
+			continue;
 		}
 
-		if (use_collision == false) {
-			for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
-				Vector3 a, b;
-
-				Geometry3D::get_closest_points_between_segments(
-						p_from,
-						p_to,
-						p.points[point_id].pos,
-						p.points[(point_id + 1) % p.points.size()].pos,
-						a,
-						b);
+		for (const gd::Polygon &p : region->get_polygons()) {
+			// For each face check the distance to the segment
+			for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
+				const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				Vector3 inters;
+				if (f.intersects_segment(p_from, p_to, &inters)) {
+					const real_t d = closest_point_d = p_from.distance_to(inters);
+					if (use_collision == false) {
+						closest_point = inters;
+						use_collision = true;
+						closest_point_d = d;
+					} else if (closest_point_d > d) {
+						closest_point = inters;
+						closest_point_d = d;
+					}
+				}
+			}
 
-				const real_t d = a.distance_to(b);
-				if (d < closest_point_d) {
-					closest_point_d = d;
-					closest_point = b;
+			if (use_collision == false) {
+				for (size_t point_id = 0; point_id < p.points.size(); point_id += 1) {
+					Vector3 a, b;
+
+					Geometry3D::get_closest_points_between_segments(
+							p_from,
+							p_to,
+							p.points[point_id].pos,
+							p.points[(point_id + 1) % p.points.size()].pos,
+							a,
+							b);
+
+					const real_t d = a.distance_to(b);
+					if (d < closest_point_d) {
+						closest_point_d = d;
+						closest_point = b;
+					}
 				}
 			}
 		}
@@ -687,21 +807,10 @@ gd::ClosestPointQueryResult NavMap::get_closest_point_info(const Vector3 &p_poin
 	RWLockRead read_lock(map_rwlock);
 
 	gd::ClosestPointQueryResult result;
-	real_t closest_point_ds = FLT_MAX;
 
-	for (const gd::Polygon &p : polygons) {
-		// For each face check the distance to the point
-		for (size_t point_id = 2; point_id < p.points.size(); point_id += 1) {
-			const Face3 f(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
-			const Vector3 inters = f.get_closest_point_to(p_point);
-			const real_t ds = inters.distance_squared_to(p_point);
-			if (ds < closest_point_ds) {
-				result.point = inters;
-				result.normal = f.get_plane().normal;
-				result.owner = p.owner->get_self();
-				closest_point_ds = ds;
-			}
-		}
+	const gd::Polygon *closest_poly = _get_closest_polygon(p_point, false, 0, FLT_MAX, result.point, &result.normal);
+	if (closest_poly) {
+		result.owner = closest_poly->owner->get_self();
 	}
 
 	return result;
@@ -715,6 +824,15 @@ void NavMap::add_region(NavRegion *p_region) {
 void NavMap::remove_region(NavRegion *p_region) {
 	int64_t region_index = regions.find(p_region);
 	if (region_index >= 0) {
+		// The region polygons may be gone by the next sync, so they are disconnected from the map right away.
+		RWLockWrite write_lock(map_rwlock);
+		_disconnect_region(p_region);
+		region_caches.erase(p_region);
+		_clear_hierarchy();
+		// The grid would still point to the polygons of the removed region until the next sync.
+		polygon_grid.clear();
+		polygon_grid_iteration_id = 0;
+
 		regions.remove_at_unordered(region_index);
 		regenerate_links = true;
 	}
@@ -891,6 +1009,8 @@ void NavMap::sync() {
 	int _new_pm_edge_merge_count = pm_edge_merge_count;
 	int _new_pm_edge_connection_count = pm_edge_connection_count;
 	int _new_pm_edge_free_count = pm_edge_free_count;
+	int _new_pm_abstract_node_count = pm_abstract_node_count;
+	int _new_pm_abstract_edge_count = pm_abstract_edge_count;
 
 	// Check if we need to update the links.
 	if (regenerate_polygons) {
@@ -900,6 +1020,18 @@ void NavMap::sync() {
 		regenerate_links = true;
 	}
 
+	if (regenerate_polygons || regenerate_region_connections) {
+		_clear_region_connections();
+		regenerate_links = true;
+	} else {
+		// Disconnect the regions about to rebuild their polygons while the old ones are still valid.
+		for (NavRegion *region : regions) {
+			if (region->is_dirty()) {
+				_disconnect_region(region);
+			}
+		}
+	}
+
 	for (NavRegion *region : regions) {
 		if (region->sync()) {
 			regenerate_links = true;
@@ -913,151 +1045,26 @@ void NavMap::sync() {
 	}
 
 	if (regenerate_links) {
+		// Links are cheap to connect, they are always rebuilt from scratch.
+		_clear_link_connections();
+
+		// Only reconnect the regions that changed and their neighbors.
+		_update_region_connections();
+
 		_new_pm_polygon_count = 0;
-		_new_pm_edge_count = 0;
-		_new_pm_edge_merge_count = 0;
+		_new_pm_edge_count = edge_key_index.size();
+		_new_pm_edge_merge_count = edge_key_merge_count;
 		_new_pm_edge_connection_count = 0;
 		_new_pm_edge_free_count = 0;
 
-		// Remove regions connections.
 		for (NavRegion *region : regions) {
-			region->get_connections().clear();
-		}
-
-		// Resize the polygon count.
-		int count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
-				continue;
-			}
-			count += region->get_polygons().size();
-		}
-		polygons.resize(count);
-
-		// Copy all region polygons in the map.
-		count = 0;
-		for (const NavRegion *region : regions) {
-			if (!region->get_enabled()) {
+			const RegionCache *cache = region_caches.getptr(region);
+			if (!cache || !cache->indexed) {
 				continue;
 			}
-			const LocalVector<gd::Polygon> &polygons_source = region->get_polygons();
-			for (uint32_t n = 0; n < polygons_source.size(); n++) {
-				polygons[count + n] = polygons_source[n];
-			}
-			count += region->get_polygons().size();
-		}
-
-		_new_pm_polygon_count = polygons.size();
-
-		// Group all edges per key.
-		HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey> connections;
-		for (gd::Polygon &poly : polygons) {
-			for (uint32_t p = 0; p < poly.points.size(); p++) {
-				int next_point = (p + 1) % poly.points.size();
-				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
-
-				HashMap<gd::EdgeKey, Vector<gd::Edge::Connection>, gd::EdgeKey>::Iterator connection = connections.find(ek);
-				if (!connection) {
-					connections[ek] = Vector<gd::Edge::Connection>();
-					_new_pm_edge_count += 1;
-				}
-				if (connections[ek].size() <= 1) {
-					// Add the polygon/edge tuple to this key.
-					gd::Edge::Connection new_connection;
-					new_connection.polygon = &poly;
-					new_connection.edge = p;
-					new_connection.pathway_start = poly.points[p].pos;
-					new_connection.pathway_end = poly.points[next_point].pos;
-					connections[ek].push_back(new_connection);
-				} else {
-					// The edge is already connected with another edge, skip.
-					ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
-				}
-			}
-		}
-
-		Vector<gd::Edge::Connection> free_edges;
-		for (KeyValue<gd::EdgeKey, Vector<gd::Edge::Connection>> &E : connections) {
-			if (E.value.size() == 2) {
-				// Connect edge that are shared in different polygons.
-				gd::Edge::Connection &c1 = E.value.write[0];
-				gd::Edge::Connection &c2 = E.value.write[1];
-				c1.polygon->edges[c1.edge].connections.push_back(c2);
-				c2.polygon->edges[c2.edge].connections.push_back(c1);
-				// Note: The pathway_start/end are full for those connection and do not need to be modified.
-				_new_pm_edge_merge_count += 1;
-			} else {
-				CRASH_COND_MSG(E.value.size() != 1, vformat("Number of connection != 1. Found: %d", E.value.size()));
-				if (use_edge_connections && E.value[0].polygon->owner->get_use_edge_connections()) {
-					free_edges.push_back(E.value[0]);
-				}
-			}
-		}
-
-		// Find the compatible near edges.
-		//
-		// Note:
-		// Considering that the edges must be compatible (for obvious reasons)
-		// to be connected, create new polygons to remove that small gap is
-		// not really useful and would result in wasteful computation during
-		// connection, integration and path finding.
-		_new_pm_edge_free_count = free_edges.size();
-
-		for (int i = 0; i < free_edges.size(); i++) {
-			const gd::Edge::Connection &free_edge = free_edges[i];
-			Vector3 edge_p1 = free_edge.polygon->points[free_edge.edge].pos;
-			Vector3 edge_p2 = free_edge.polygon->points[(free_edge.edge + 1) % free_edge.polygon->points.size()].pos;
-
-			for (int j = 0; j < free_edges.size(); j++) {
-				const gd::Edge::Connection &other_edge = free_edges[j];
-				if (i == j || free_edge.polygon->owner == other_edge.polygon->owner) {
-					continue;
-				}
-
-				Vector3 other_edge_p1 = other_edge.polygon->points[other_edge.edge].pos;
-				Vector3 other_edge_p2 = other_edge.polygon->points[(other_edge.edge + 1) % other_edge.polygon->points.size()].pos;
-
-				// Compute the projection of the opposite edge on the current one
-				Vector3 edge_vector = edge_p2 - edge_p1;
-				real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
-				real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
-				if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
-					continue;
-				}
-
-				// Check if the two edges are close to each other enough and compute a pathway between the two regions.
-				Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other1;
-				if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
-					other1 = other_edge_p1;
-				} else {
-					other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other1.distance_to(self1) > edge_connection_margin) {
-					continue;
-				}
-
-				Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
-				Vector3 other2;
-				if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
-					other2 = other_edge_p2;
-				} else {
-					other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
-				}
-				if (other2.distance_to(self2) > edge_connection_margin) {
-					continue;
-				}
-
-				// The edges can now be connected.
-				gd::Edge::Connection new_connection = other_edge;
-				new_connection.pathway_start = (self1 + other1) / 2.0;
-				new_connection.pathway_end = (self2 + other2) / 2.0;
-				free_edge.polygon->edges[free_edge.edge].connections.push_back(new_connection);
-
-				// Add the connection to the region_connection map.
-				((NavRegion *)free_edge.polygon->owner)->get_connections().push_back(new_connection);
-				_new_pm_edge_connection_count += 1;
-			}
+			_new_pm_polygon_count += region->get_polygons().size();
+			_new_pm_edge_connection_count += region->get_connections().size();
+			_new_pm_edge_free_count += cache->free_edge_count;
 		}
 
 		uint32_t link_poly_idx = 0;
@@ -1071,49 +1078,12 @@ void NavMap::sync() {
 			const Vector3 start = link->get_start_position();
 			const Vector3 end = link->get_end_position();
 
-			gd::Polygon *closest_start_polygon = nullptr;
-			real_t closest_start_distance = link_connection_radius;
+			// Pick the polygons that are within our radius and closest to the link start and end.
 			Vector3 closest_start_point;
+			gd::Polygon *closest_start_polygon = _get_closest_polygon(start, false, 0, link_connection_radius, closest_start_point);
 
-			gd::Polygon *closest_end_polygon = nullptr;
-			real_t closest_end_distance = link_connection_radius;
 			Vector3 closest_end_point;
-
-			// Create link to any polygons within the search radius of the start point.
-			for (uint32_t start_index = 0; start_index < polygons.size(); start_index++) {
-				gd::Polygon &start_poly = polygons[start_index];
-
-				// For each face check the distance to the start
-				for (uint32_t start_point_id = 2; start_point_id < start_poly.points.size(); start_point_id += 1) {
-					const Face3 start_face(start_poly.points[0].pos, start_poly.points[start_point_id - 1].pos, start_poly.points[start_point_id].pos);
-					const Vector3 start_point = start_face.get_closest_point_to(start);
-					const real_t start_distance = start_point.distance_to(start);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (start_distance <= link_connection_radius && start_distance < closest_start_distance) {
-						closest_start_distance = start_distance;
-						closest_start_point = start_point;
-						closest_start_polygon = &start_poly;
-					}
-				}
-			}
-
-			// Find any polygons within the search radius of the end point.
-			for (gd::Polygon &end_poly : polygons) {
-				// For each face check the distance to the end
-				for (uint32_t end_point_id = 2; end_point_id < end_poly.points.size(); end_point_id += 1) {
-					const Face3 end_face(end_poly.points[0].pos, end_poly.points[end_point_id - 1].pos, end_poly.points[end_point_id].pos);
-					const Vector3 end_point = end_face.get_closest_point_to(end);
-					const real_t end_distance = end_point.distance_to(end);
-
-					// Pick the polygon that is within our radius and is closer than anything we've seen yet.
-					if (end_distance <= link_connection_radius && end_distance < closest_end_distance) {
-						closest_end_distance = end_distance;
-						closest_end_point = end_point;
-						closest_end_polygon = &end_poly;
-					}
-				}
-			}
+			gd::Polygon *closest_end_polygon = _get_closest_polygon(end, false, 0, link_connection_radius, closest_end_point);
 
 			// If we have both a start and end point, then create a synthetic polygon to route through.
 			if (closest_start_polygon && closest_end_polygon) {
@@ -1146,6 +1116,7 @@ void NavMap::sync() {
 					entry_connection.pathway_start = new_polygon.points[0].pos;
 					entry_connection.pathway_end = new_polygon.points[1].pos;
 					closest_start_polygon->edges[0].connections.push_back(entry_connection);
+					link_connected_polygons.push_back(closest_start_polygon);
 
 					gd::Edge::Connection exit_connection;
 					exit_connection.polygon = closest_end_polygon;
@@ -1163,6 +1134,7 @@ void NavMap::sync() {
 					entry_connection.pathway_start = new_polygon.points[2].pos;
 					entry_connection.pathway_end = new_polygon.points[3].pos;
 					closest_end_polygon->edges[0].connections.push_back(entry_connection);
+					link_connected_polygons.push_back(closest_end_polygon);
 
 					gd::Edge::Connection exit_connection;
 					exit_connection.polygon = closest_start_polygon;
@@ -1174,6 +1146,15 @@ void NavMap::sync() {
 			}
 		}
 
+		_build_hierarchy(link_poly_idx);
+
+		// The cached routes point to polygons that may have changed, flow fields are repaired on their next use instead.
+		path_cache_mutex.lock();
+		path_cache.clear();
+		path_cache_mutex.unlock();
+		_new_pm_abstract_node_count = hierarchy_portals.size();
+		_new_pm_abstract_edge_count = hierarchy_edge_count;
+
 		// Some code treats 0 as a failure case, so we avoid returning 0 and modulo wrap UINT32_MAX manually.
 		iteration_id = iteration_id % UINT32_MAX + 1;
 	}
@@ -1198,6 +1179,7 @@ void NavMap::sync() {
 
 	regenerate_polygons = false;
 	regenerate_links = false;
+	regenerate_region_connections = false;
 	obstacles_dirty = false;
 	agents_dirty = false;
 
@@ -1210,6 +1192,8 @@ void NavMap::sync() {
 	pm_edge_merge_count = _new_pm_edge_merge_count;
 	pm_edge_connection_count = _new_pm_edge_connection_count;
 	pm_edge_free_count = _new_pm_edge_free_count;
+	pm_abstract_node_count = _new_pm_abstract_node_count;
+	pm_abstract_edge_count = _new_pm_abstract_edge_count;
 }
 
 void NavMap::_update_rvo_obstacles_tree_2d() {
@@ -1323,50 +1307,65 @@ void NavMap::_update_rvo_simulation() {
 void NavMap::compute_single_avoidance_step_2d(uint32_t index, NavAgent **agent) {
 	(*(agent + index))->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
 	(*(agent + index))->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-	(*(agent + index))->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-	(*(agent + index))->update();
 }
 
 void NavMap::compute_single_avoidance_step_3d(uint32_t index, NavAgent **agent) {
 	(*(agent + index))->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
 	(*(agent + index))->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-	(*(agent + index))->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-	(*(agent + index))->update();
 }
 
 void NavMap::step(real_t p_deltatime) {
 	deltatime = p_deltatime;
 
-	rvo_simulation_2d.setTimeStep(float(deltatime));
-	rvo_simulation_3d.setTimeStep(float(deltatime));
+	// Avoidance can run at a lower rate than physics, it then steps over all the time since its previous step.
+	avoidance_accumulated_time += p_deltatime;
+	if (++avoidance_ticks_since_step < avoidance_physics_ticks_per_step) {
+		return;
+	}
+	const real_t avoidance_deltatime = avoidance_accumulated_time;
+	avoidance_accumulated_time = 0.0;
+	avoidance_ticks_since_step = 0;
+
+	const uint64_t avoidance_begin = OS::get_singleton()->get_ticks_usec();
+
+	rvo_simulation_2d.setTimeStep(float(avoidance_deltatime));
+	rvo_simulation_3d.setTimeStep(float(avoidance_deltatime));
 
+	// All the new velocities are computed before any agent is updated, so every agent sees its neighbors in the same state
+	// no matter how the agents are split between the threads.
 	if (active_2d_avoidance_agents.size() > 0) {
 		if (use_threads && avoidance_use_multiple_threads) {
-			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_2d, active_2d_avoidance_agents.ptr(), active_2d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents2D"));
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_2d, active_2d_avoidance_agents.ptr(), active_2d_avoidance_agents.size(), -1, avoidance_use_high_priority_threads, SNAME("RVOAvoidanceAgents2D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
-			for (NavAgent *agent : active_2d_avoidance_agents) {
-				agent->get_rvo_agent_2d()->computeNeighbors(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->computeNewVelocity(&rvo_simulation_2d);
-				agent->get_rvo_agent_2d()->update(&rvo_simulation_2d);
-				agent->update();
+			for (uint32_t i = 0; i < active_2d_avoidance_agents.size(); i++) {
+				compute_single_avoidance_step_2d(i, active_2d_avoidance_agents.ptr());
 			}
 		}
+
+		for (NavAgent *agent : active_2d_avoidance_agents) {
+			agent->get_rvo_agent_2d()->update(&rvo_simulation_2d);
+			agent->update();
+		}
 	}
 
 	if (active_3d_avoidance_agents.size() > 0) {
 		if (use_threads && avoidance_use_multiple_threads) {
-			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_3d, active_3d_avoidance_agents.ptr(), active_3d_avoidance_agents.size(), -1, true, SNAME("RVOAvoidanceAgents3D"));
+			WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &NavMap::compute_single_avoidance_step_3d, active_3d_avoidance_agents.ptr(), active_3d_avoidance_agents.size(), -1, avoidance_use_high_priority_threads, SNAME("RVOAvoidanceAgents3D"));
 			WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
 		} else {
-			for (NavAgent *agent : active_3d_avoidance_agents) {
-				agent->get_rvo_agent_3d()->computeNeighbors(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->computeNewVelocity(&rvo_simulation_3d);
-				agent->get_rvo_agent_3d()->update(&rvo_simulation_3d);
-				agent->update();
+			for (uint32_t i = 0; i < active_3d_avoidance_agents.size(); i++) {
+				compute_single_avoidance_step_3d(i, active_3d_avoidance_agents.ptr());
 			}
 		}
+
+		for (NavAgent *agent : active_3d_avoidance_agents) {
+			agent->get_rvo_agent_3d()->update(&rvo_simulation_3d);
+			agent->update();
+		}
 	}
+
+	pm_avoidance_time = OS::get_singleton()->get_ticks_usec() - avoidance_begin;
 }
 
 void NavMap::dispatch_callbacks() {
@@ -1417,10 +1416,1176 @@ void NavMap::_update_merge_rasterizer_cell_dimensions() {
 	merge_rasterizer_cell_height = cell_height * merge_rasterizer_cell_scale;
 }
 
-NavMap::NavMap() {
-	avoidance_use_multiple_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_multiple_threads");
-	avoidance_use_high_priority_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_high_priority_threads");
+static void _erase_connections_to(gd::Polygon &r_polygon, const gd::Polygon *p_begin, const gd::Polygon *p_end) {
+	for (gd::Edge &edge : r_polygon.edges) {
+		for (int i = edge.connections.size() - 1; i >= 0; i--) {
+			const gd::Polygon *target = edge.connections[i].polygon;
+			if (target >= p_begin && target < p_end) {
+				edge.connections.remove_at(i);
+			}
+		}
+	}
 }
 
-NavMap::~NavMap() {
+void NavMap::_clear_region_connections() {
+	for (NavRegion *region : regions) {
+		for (gd::Polygon &polygon : region->get_polygons()) {
+			for (gd::Edge &edge : polygon.edges) {
+				edge.connections.clear();
+			}
+		}
+		region->get_connections().clear();
+	}
+
+	for (gd::Polygon &link_polygon : link_polygons) {
+		for (gd::Edge &edge : link_polygon.edges) {
+			edge.connections.clear();
+		}
+	}
+
+	region_caches.clear();
+	edge_key_index.clear();
+	edge_key_merge_count = 0;
+	link_connected_polygons.clear();
+}
+
+void NavMap::_disconnect_region(NavRegion *p_region) {
+	RegionCache *cache = region_caches.getptr(p_region);
+	if (!cache) {
+		return;
+	}
+
+	if (cache->indexed) {
+		LocalVector<gd::Polygon> &region_polygons = p_region->get_polygons();
+		const gd::Polygon *begin = region_polygons.ptr();
+		const gd::Polygon *end = begin + region_polygons.size();
+
+		// Remove the region edges from the edge key index.
+		for (gd::Polygon &poly : region_polygons) {
+			for (uint32_t p = 0; p < poly.points.size(); p++) {
+				int next_point = (p + 1) % poly.points.size();
+				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+				HashMap<gd::EdgeKey, EdgeKeyConnections, gd::EdgeKey>::Iterator E = edge_key_index.find(ek);
+				if (!E) {
+					continue;
+				}
+				EdgeKeyConnections &entry = E->value;
+				for (uint32_t i = 0; i < entry.count; i++) {
+					if (entry.connections[i].polygon != &poly || entry.connections[i].edge != int(p)) {
+						continue;
+					}
+					if (entry.count == 2) {
+						edge_key_merge_count -= 1;
+						if (i == 0) {
+							entry.connections[0] = entry.connections[1];
+						}
+					}
+					entry.count -= 1;
+					break;
+				}
+				if (entry.count == 0) {
+					edge_key_index.remove(E);
+				}
+			}
+
+			for (gd::Edge &edge : poly.edges) {
+				edge.connections.clear();
+			}
+		}
+		p_region->get_connections().clear();
+
+		// Neighbors lose their connections to the region, and possibly had edges merged with it that are free now.
+		for (KeyValue<NavRegion *, RegionCache> &N : region_caches) {
+			if (N.key == p_region || !N.value.indexed || !N.value.bounds.intersects(cache->bounds)) {
+				continue;
+			}
+			for (gd::Polygon &poly : N.key->get_polygons()) {
+				_erase_connections_to(poly, begin, end);
+			}
+			Vector<gd::Edge::Connection> &region_connections = N.key->get_connections();
+			for (int i = region_connections.size() - 1; i >= 0; i--) {
+				if (region_connections[i].polygon >= begin && region_connections[i].polygon < end) {
+					region_connections.remove_at(i);
+				}
+			}
+			N.value.connections_dirty = true;
+		}
+
+		for (gd::Polygon &link_polygon : link_polygons) {
+			_erase_connections_to(link_polygon, begin, end);
+		}
+		for (int64_t i = int64_t(link_connected_polygons.size()) - 1; i >= 0; i--) {
+			if (link_connected_polygons[i] >= begin && link_connected_polygons[i] < end) {
+				link_connected_polygons.remove_at_unordered(i);
+			}
+		}
+	}
+
+	cache->indexed = false;
+	cache->dirty = true;
+	cache->free_edge_count = 0;
+	cache->polygon_bvh.clear();
+	cache->polygon_bvh_root = -1;
+}
+
+void NavMap::_index_region(NavRegion *p_region, RegionCache &r_cache) {
+	LocalVector<gd::Polygon> &region_polygons = p_region->get_polygons();
+
+	// Build the closest polygon BVH, one leaf per valid polygon followed by the internal nodes.
+	LocalVector<PolygonBVH *> bb;
+	r_cache.polygon_bvh.clear();
+	r_cache.polygon_bvh.reserve(region_polygons.size() * 2);
+	r_cache.bounds = AABB();
+
+	bool bounds_empty = true;
+	for (uint32_t i = 0; i < region_polygons.size(); i++) {
+		const gd::Polygon &p = region_polygons[i];
+		if (p.points.size() < 3) {
+			continue;
+		}
+
+		PolygonBVH leaf;
+		leaf.aabb.position = p.points[0].pos;
+		for (uint32_t point_id = 1; point_id < p.points.size(); point_id++) {
+			leaf.aabb.expand_to(p.points[point_id].pos);
+		}
+		leaf.center = leaf.aabb.get_center();
+		leaf.polygon_index = i;
+		r_cache.polygon_bvh.push_back(leaf);
+
+		if (bounds_empty) {
+			r_cache.bounds = leaf.aabb;
+			bounds_empty = false;
+		} else {
+			r_cache.bounds.merge_with(leaf.aabb);
+		}
+	}
+
+	const int leaf_count = r_cache.polygon_bvh.size();
+	r_cache.polygon_bvh_root = -1;
+	if (leaf_count > 0) {
+		r_cache.polygon_bvh.resize(leaf_count * 2 - 1);
+		bb.resize(leaf_count);
+		for (int i = 0; i < leaf_count; i++) {
+			bb[i] = &r_cache.polygon_bvh[i];
+		}
+		int max_alloc = leaf_count;
+		r_cache.polygon_bvh_root = _create_polygon_bvh(r_cache.polygon_bvh, bb.ptr(), 0, leaf_count, max_alloc);
+	}
+
+	// Edges sharing a key can be a cell apart, gap connections up to the edge connection margin.
+	r_cache.bounds = r_cache.bounds.grow(MAX(edge_connection_margin, MAX(cell_size, cell_height)));
+
+	// Add the region edges to the edge key index.
+	for (gd::Polygon &poly : region_polygons) {
+		for (uint32_t p = 0; p < poly.points.size(); p++) {
+			int next_point = (p + 1) % poly.points.size();
+			gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+			EdgeKeyConnections &entry = edge_key_index[ek];
+			if (entry.count < 2) {
+				// Add the polygon/edge tuple to this key.
+				gd::Edge::Connection &new_connection = entry.connections[entry.count];
+				new_connection.polygon = &poly;
+				new_connection.edge = p;
+				new_connection.pathway_start = poly.points[p].pos;
+				new_connection.pathway_end = poly.points[next_point].pos;
+				entry.count += 1;
+				if (entry.count == 2) {
+					edge_key_merge_count += 1;
+				}
+			} else {
+				// The edge is already connected with another edge, skip.
+				ERR_PRINT_ONCE("Navigation map synchronization error. Attempted to merge a navigation mesh polygon edge with another already-merged edge. This is usually caused by crossing edges, overlapping polygons, or a mismatch of the NavigationMesh / NavigationPolygon baked 'cell_size' and navigation map 'cell_size'. If you're certain none of above is the case, change 'navigation/3d/merge_rasterizer_cell_scale' to 0.001.");
+			}
+		}
+	}
+
+	r_cache.indexed = true;
+}
+
+void NavMap::_update_region_connections() {
+	LocalVector<NavRegion *> touched_regions;
+
+	// Index the regions that were added or rebuilt since the last sync.
+	for (NavRegion *region : regions) {
+		RegionCache &cache = region_caches[region];
+		cache.pass = RegionCache::PASS_NONE;
+		if (!cache.dirty) {
+			continue;
+		}
+		cache.dirty = false;
+		cache.connections_dirty = false;
+		if (!region->get_enabled()) {
+			continue;
+		}
+		_index_region(region, cache);
+		cache.pass = RegionCache::PASS_TOUCHED;
+		cache.connection_version = ++region_connection_version;
+		touched_regions.push_back(region);
+	}
+
+	// Their neighbors may have edges merging with the new polygons, or edges freed by the old ones.
+	const uint32_t rebuilt_region_count = touched_regions.size();
+	for (NavRegion *region : regions) {
+		RegionCache &cache = region_caches[region];
+		if (!cache.indexed || cache.pass == RegionCache::PASS_TOUCHED) {
+			continue;
+		}
+		bool touched = cache.connections_dirty;
+		for (uint32_t i = 0; i < rebuilt_region_count && !touched; i++) {
+			touched = cache.bounds.intersects(region_caches[touched_regions[i]].bounds);
+		}
+		cache.connections_dirty = false;
+		if (touched) {
+			cache.pass = RegionCache::PASS_TOUCHED;
+			cache.connection_version = ++region_connection_version;
+			touched_regions.push_back(region);
+		}
+	}
+
+	if (touched_regions.is_empty()) {
+		return;
+	}
+
+	// The regions around the touched ones keep their own connections, but not the ones leading to touched regions.
+	LocalVector<NavRegion *> border_regions;
+	for (NavRegion *region : regions) {
+		RegionCache &cache = region_caches[region];
+		if (!cache.indexed || cache.pass != RegionCache::PASS_NONE) {
+			continue;
+		}
+		for (const NavRegion *touched_region : touched_regions) {
+			if (cache.bounds.intersects(region_caches[const_cast<NavRegion *>(touched_region)].bounds)) {
+				cache.pass = RegionCache::PASS_BORDER;
+				cache.connection_version = ++region_connection_version;
+				border_regions.push_back(region);
+				break;
+			}
+		}
+	}
+
+	for (NavRegion *region : border_regions) {
+		for (gd::Polygon &poly : region->get_polygons()) {
+			for (gd::Edge &edge : poly.edges) {
+				for (int i = edge.connections.size() - 1; i >= 0; i--) {
+					const RegionCache *target_cache = region_caches.getptr((NavRegion *)edge.connections[i].polygon->owner);
+					if (target_cache && target_cache->pass == RegionCache::PASS_TOUCHED) {
+						edge.connections.remove_at(i);
+					}
+				}
+			}
+		}
+		Vector<gd::Edge::Connection> &region_connections = region->get_connections();
+		for (int i = region_connections.size() - 1; i >= 0; i--) {
+			const RegionCache *target_cache = region_caches.getptr((NavRegion *)region_connections[i].polygon->owner);
+			if (target_cache && target_cache->pass == RegionCache::PASS_TOUCHED) {
+				region_connections.remove_at(i);
+			}
+		}
+	}
+
+	for (NavRegion *region : touched_regions) {
+		for (gd::Polygon &poly : region->get_polygons()) {
+			for (gd::Edge &edge : poly.edges) {
+				edge.connections.clear();
+			}
+		}
+		region->get_connections().clear();
+	}
+
+	// Connect the edges that are shared in different polygons, collect the free ones.
+	Vector<gd::Edge::Connection> free_edges;
+	for (NavRegion *region : touched_regions) {
+		RegionCache &cache = region_caches[region];
+		const bool region_uses_edge_connections = use_edge_connections && region->get_use_edge_connections();
+		cache.free_edge_count = 0;
+
+		for (gd::Polygon &poly : region->get_polygons()) {
+			for (uint32_t p = 0; p < poly.points.size(); p++) {
+				int next_point = (p + 1) % poly.points.size();
+				gd::EdgeKey ek(poly.points[p].key, poly.points[next_point].key);
+
+				HashMap<gd::EdgeKey, EdgeKeyConnections, gd::EdgeKey>::Iterator E = edge_key_index.find(ek);
+				if (!E) {
+					continue;
+				}
+				EdgeKeyConnections &entry = E->value;
+
+				int self_index = -1;
+				for (uint32_t i = 0; i < entry.count; i++) {
+					if (entry.connections[i].polygon == &poly && entry.connections[i].edge == int(p)) {
+						self_index = i;
+					}
+				}
+				if (self_index == -1) {
+					// This edge was dropped from the index as a third edge on an already-merged key.
+					continue;
+				}
+
+				if (entry.count == 2) {
+					const gd::Edge::Connection &self = entry.connections[self_index];
+					const gd::Edge::Connection &other = entry.connections[1 - self_index];
+					poly.edges[p].connections.push_back(other);
+					// Touched regions add their own side of the connection.
+					const RegionCache *other_cache = region_caches.getptr((NavRegion *)other.polygon->owner);
+					if (!other_cache || other_cache->pass != RegionCache::PASS_TOUCHED) {
+						other.polygon->edges[other.edge].connections.push_back(self);
+					}
+					// Note: The pathway_start/end are full for those connection and do not need to be modified.
+				} else if (region_uses_edge_connections) {
+					free_edges.push_back(entry.connections[0]);
+					cache.free_edge_count += 1;
+				}
+			}
+		}
+	}
+
+	// The free edges of the border regions, which can still connect to touched regions.
+	const int touched_free_edge_count = free_edges.size();
+	if (use_edge_connections) {
+		for (NavRegion *region : border_regions) {
+			if (!region->get_use_edge_connections()) {
+				continue;
+			}
+			for (gd::Polygon &poly : region->get_polygons()) {
+				for (uint32_t p = 0; p < poly.points.size(); p++) {
+					int next_point = (p + 1) % poly.points.size();
+					HashMap<gd::EdgeKey, EdgeKeyConnections, gd::EdgeKey>::ConstIterator E = edge_key_index.find(gd::EdgeKey(poly.points[p].key, poly.points[next_point].key));
+					if (E && E->value.count == 1 && E->value.connections[0].polygon == &poly && E->value.connections[0].edge == int(p)) {
+						free_edges.push_back(E->value.connections[0]);
+					}
+				}
+			}
+		}
+	}
+
+	// Find the compatible near edges, for every pair involving at least one touched region.
+	//
+	// Note:
+	// Considering that the edges must be compatible (for obvious reasons)
+	// to be connected, create new polygons to remove that small gap is
+	// not really useful and would result in wasteful computation during
+	// connection, integration and path finding.
+	for (int i = 0; i < free_edges.size(); i++) {
+		const int other_count = i < touched_free_edge_count ? free_edges.size() : touched_free_edge_count;
+		for (int j = 0; j < other_count; j++) {
+			if (i == j) {
+				continue;
+			}
+			_connect_free_edges(free_edges[i], free_edges[j]);
+		}
+	}
+}
+
+void NavMap::_connect_free_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge) {
+	if (p_free_edge.polygon->owner == p_other_edge.polygon->owner) {
+		return;
+	}
+
+	Vector3 edge_p1 = p_free_edge.polygon->points[p_free_edge.edge].pos;
+	Vector3 edge_p2 = p_free_edge.polygon->points[(p_free_edge.edge + 1) % p_free_edge.polygon->points.size()].pos;
+
+	Vector3 other_edge_p1 = p_other_edge.polygon->points[p_other_edge.edge].pos;
+	Vector3 other_edge_p2 = p_other_edge.polygon->points[(p_other_edge.edge + 1) % p_other_edge.polygon->points.size()].pos;
+
+	// Compute the projection of the opposite edge on the current one
+	Vector3 edge_vector = edge_p2 - edge_p1;
+	real_t projected_p1_ratio = edge_vector.dot(other_edge_p1 - edge_p1) / (edge_vector.length_squared());
+	real_t projected_p2_ratio = edge_vector.dot(other_edge_p2 - edge_p1) / (edge_vector.length_squared());
+	if ((projected_p1_ratio < 0.0 && projected_p2_ratio < 0.0) || (projected_p1_ratio > 1.0 && projected_p2_ratio > 1.0)) {
+		return;
+	}
+
+	// Check if the two edges are close to each other enough and compute a pathway between the two regions.
+	Vector3 self1 = edge_vector * CLAMP(projected_p1_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other1;
+	if (projected_p1_ratio >= 0.0 && projected_p1_ratio <= 1.0) {
+		other1 = other_edge_p1;
+	} else {
+		other1 = other_edge_p1.lerp(other_edge_p2, (1.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other1.distance_to(self1) > edge_connection_margin) {
+		return;
+	}
+
+	Vector3 self2 = edge_vector * CLAMP(projected_p2_ratio, 0.0, 1.0) + edge_p1;
+	Vector3 other2;
+	if (projected_p2_ratio >= 0.0 && projected_p2_ratio <= 1.0) {
+		other2 = other_edge_p2;
+	} else {
+		other2 = other_edge_p1.lerp(other_edge_p2, (0.0 - projected_p1_ratio) / (projected_p2_ratio - projected_p1_ratio));
+	}
+	if (other2.distance_to(self2) > edge_connection_margin) {
+		return;
+	}
+
+	// The edges can now be connected.
+	gd::Edge::Connection new_connection = p_other_edge;
+	new_connection.pathway_start = (self1 + other1) / 2.0;
+	new_connection.pathway_end = (self2 + other2) / 2.0;
+	p_free_edge.polygon->edges[p_free_edge.edge].connections.push_back(new_connection);
+
+	// Add the connection to the region_connection map.
+	((NavRegion *)p_free_edge.polygon->owner)->get_connections().push_back(new_connection);
+}
+
+void NavMap::_clear_link_connections() {
+	const gd::Polygon *begin = link_polygons.ptr();
+	const gd::Polygon *end = begin + link_polygons.size();
+	for (gd::Polygon *polygon : link_connected_polygons) {
+		_erase_connections_to(*polygon, begin, end);
+	}
+	link_connected_polygons.clear();
+}
+
+int NavMap::_create_polygon_bvh(LocalVector<PolygonBVH> &r_bvh, PolygonBVH **p_bb, int p_from, int p_size, int &r_max_alloc) {
+	if (p_size == 1) {
+		return p_bb[p_from] - r_bvh.ptr();
+	} else if (p_size == 0) {
+		return -1;
+	}
+
+	AABB aabb = p_bb[p_from]->aabb;
+	for (int i = 1; i < p_size; i++) {
+		aabb.merge_with(p_bb[p_from + i]->aabb);
+	}
+
+	switch (aabb.get_longest_axis_index()) {
+		case Vector3::AXIS_X: {
+			SortArray<PolygonBVH *, PolygonBVHCmpX> sort_x;
+			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+		case Vector3::AXIS_Y: {
+			SortArray<PolygonBVH *, PolygonBVHCmpY> sort_y;
+			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+		case Vector3::AXIS_Z: {
+			SortArray<PolygonBVH *, PolygonBVHCmpZ> sort_z;
+			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
+		} break;
+	}
+
+	int left = _create_polygon_bvh(r_bvh, p_bb, p_from, p_size / 2, r_max_alloc);
+	int right = _create_polygon_bvh(r_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, r_max_alloc);
+
+	int index = r_max_alloc++;
+	PolygonBVH &node = r_bvh[index];
+	node.aabb = aabb;
+	node.center = aabb.get_center();
+	node.polygon_index = -1;
+	node.left = left;
+	node.right = right;
+
+	return index;
+}
+
+static _FORCE_INLINE_ real_t _aabb_distance_squared_to(const AABB &p_aabb, const Vector3 &p_point) {
+	const Vector3 end = p_aabb.position + p_aabb.size;
+	const Vector3 closest(
+			CLAMP(p_point.x, p_aabb.position.x, end.x),
+			CLAMP(p_point.y, p_aabb.position.y, end.y),
+			CLAMP(p_point.z, p_aabb.position.z, end.z));
+	return closest.distance_squared_to(p_point);
+}
+
+gd::Polygon *NavMap::_get_closest_polygon(const Vector3 &p_point, bool p_use_layers, uint32_t p_navigation_layers, real_t p_max_distance, Vector3 &r_point, Vector3 *r_normal) const {
+	gd::Polygon *closest_polygon = nullptr;
+	real_t closest_ds = p_max_distance < FLT_MAX ? p_max_distance * p_max_distance : FLT_MAX;
+
+	for (NavRegion *region : regions) {
+		const RegionCache *cache = region_caches.getptr(region);
+		if (!cache || cache->polygon_bvh_root < 0) {
+			continue;
+		}
+		// Only consider the polygons if they are in a region with compatible layers.
+		if (p_use_layers && (p_navigation_layers & region->get_navigation_layers()) == 0) {
+			continue;
+		}
+
+		const PolygonBVH *bvhptr = cache->polygon_bvh.ptr();
+		if (_aabb_distance_squared_to(bvhptr[cache->polygon_bvh_root].aabb, p_point) >= closest_ds) {
+			continue;
+		}
+
+		LocalVector<gd::Polygon> &region_polygons = region->get_polygons();
+		int region_closest_index = -1;
+
+		// Nodes are visited nearest first so the closest distance shrinks quickly and prunes the rest of the tree.
+		// The tree is split at the median, so its depth and the stack stay well below the 32 bits of a polygon count.
+		int stack[64];
+		int level = 0;
+		stack[level++] = cache->polygon_bvh_root;
+
+		while (level > 0) {
+			const PolygonBVH &node = bvhptr[stack[--level]];
+
+			if (node.polygon_index < 0) {
+				const real_t left_ds = _aabb_distance_squared_to(bvhptr[node.left].aabb, p_point);
+				const real_t right_ds = _aabb_distance_squared_to(bvhptr[node.right].aabb, p_point);
+				const bool left_first = left_ds <= right_ds;
+
+				// Equal distances must still be visited so ties resolve to the lowest polygon index, like a linear scan would.
+				const int far = left_first ? node.right : node.left;
+				const int near = left_first ? node.left : node.right;
+				if ((left_first ? right_ds : left_ds) <= closest_ds) {
+					stack[level++] = far;
+				}
+				if ((left_first ? left_ds : right_ds) <= closest_ds) {
+					stack[level++] = near;
+				}
+				continue;
+			}
+
+			gd::Polygon &p = region_polygons[node.polygon_index];
+
+			// For each face check the distance to the point.
+			for (uint32_t point_id = 2; point_id < p.points.size(); point_id++) {
+				const Face3 face(p.points[0].pos, p.points[point_id - 1].pos, p.points[point_id].pos);
+				const Vector3 point = face.get_closest_point_to(p_point);
+				const real_t ds = point.distance_squared_to(p_point);
+				// Ties within a region go to the lowest polygon index, ties across regions to the earliest region.
+				if (ds < closest_ds || (ds == closest_ds && region_closest_index > node.polygon_index)) {
+					closest_ds = ds;
+					closest_polygon = &p;
+					region_closest_index = node.polygon_index;
+					r_point = point;
+					if (r_normal) {
+						*r_normal = face.get_plane().normal;
+					}
+				}
+			}
+		}
+	}
+
+	return closest_polygon;
+}
+
+bool NavMap::_get_cached_route(const PathCacheKey &p_key, const Vector3 &p_begin_point, LocalVector<gd::NavigationPoly> &r_navigation_polys) const {
+	{
+		MutexLock lock(path_cache_mutex);
+		const LocalVector<gd::NavigationPoly> *route = path_cache.getptr(p_key);
+		if (!route) {
+			return false;
+		}
+		r_navigation_polys = *route;
+	}
+
+	// Only the entry points depend on where the query starts, the post-processing needs them.
+	gd::NavigationPoly &begin_navigation_poly = r_navigation_polys[0];
+	begin_navigation_poly.entry = p_begin_point;
+	begin_navigation_poly.back_navigation_edge_pathway_start = p_begin_point;
+	begin_navigation_poly.back_navigation_edge_pathway_end = p_begin_point;
+	for (uint32_t i = 1; i < r_navigation_polys.size(); i++) {
+		gd::NavigationPoly &navigation_poly = r_navigation_polys[i];
+		Vector3 pathway[2] = { navigation_poly.back_navigation_edge_pathway_start, navigation_poly.back_navigation_edge_pathway_end };
+		navigation_poly.entry = Geometry3D::get_closest_point_to_segment(r_navigation_polys[i - 1].entry, pathway);
+	}
+	return true;
+}
+
+void NavMap::_cache_route(const PathCacheKey &p_key, const LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id) const {
+	// Keep only the polygons along the route, ordered from the start to the end.
+	LocalVector<gd::NavigationPoly> route;
+	for (int id = p_end_id; id != -1; id = p_navigation_polys[id].back_navigation_poly_id) {
+		route.push_back(p_navigation_polys[id]);
+	}
+	route.invert();
+	for (uint32_t i = 0; i < route.size(); i++) {
+		route[i].self_id = i;
+		route[i].back_navigation_poly_id = int(i) - 1;
+	}
+
+	MutexLock lock(path_cache_mutex);
+	if (path_cache_size > 0) { // Might have been disabled while the route was searched.
+		path_cache.insert(p_key, route);
+	}
+}
+
+struct FlowFieldQueueItem {
+	real_t distance = 0.0;
+	uint32_t index = 0;
+};
+
+struct FlowFieldQueueItemCmp {
+	_FORCE_INLINE_ bool operator()(const FlowFieldQueueItem &p_left, const FlowFieldQueueItem &p_right) const {
+		// Returns true when the left item is worse, so the heap keeps the closest item on top.
+		return p_left.distance > p_right.distance;
+	}
+};
+
+void NavMap::_update_flow_field(FlowField &r_flow_field) const {
+	HashMap<const NavBase *, uint32_t> region_versions;
+	for (NavRegion *region : regions) {
+		const RegionCache *cache = region_caches.getptr(region);
+		if (cache && cache->indexed && region->get_enabled()) {
+			region_versions.insert(region, cache->connection_version);
+		}
+	}
+
+	Vector3 target_point;
+	const gd::Polygon *target_polygon = _get_closest_polygon(r_flow_field.target_position, true, r_flow_field.navigation_layers, FLT_MAX, target_point);
+
+	// A new target polygon changes every distance, otherwise only the routes through changed regions and links are dropped.
+	bool rebuild = !target_polygon || target_polygon != r_flow_field.target_polygon || r_flow_field.iteration_id == 0;
+	if (!rebuild) {
+		const uint32_t *old_version = r_flow_field.region_versions.getptr(target_polygon->owner);
+		const uint32_t *new_version = region_versions.getptr(target_polygon->owner);
+		rebuild = !old_version || !new_version || *old_version != *new_version;
+	}
+
+	if (rebuild) {
+		r_flow_field.nodes.clear();
+	} else {
+		for (KeyValue<const gd::Polygon *, FlowFieldNode> &E : r_flow_field.nodes) {
+			const uint32_t *old_version = r_flow_field.region_versions.getptr(E.value.owner);
+			const uint32_t *new_version = region_versions.getptr(E.value.owner);
+			// Link polygons are rebuilt on every map change, they never keep their node.
+			E.value.state = (old_version && new_version && *old_version == *new_version) ? FLOW_FIELD_NODE_UNKNOWN : FLOW_FIELD_NODE_DROPPED;
+		}
+
+		// A node is only kept when its whole route to the target is kept.
+		LocalVector<FlowFieldNode *> route;
+		LocalVector<const gd::Polygon *> dropped_polygons;
+		for (KeyValue<const gd::Polygon *, FlowFieldNode> &E : r_flow_field.nodes) {
+			FlowFieldNodeState state = FLOW_FIELD_NODE_DROPPED;
+			FlowFieldNode *node = &E.value;
+			route.clear();
+			while (node) {
+				if (node->state != FLOW_FIELD_NODE_UNKNOWN) {
+					state = node->state == FLOW_FIELD_NODE_KEPT ? FLOW_FIELD_NODE_KEPT : FLOW_FIELD_NODE_DROPPED;
+					break;
+				}
+				node->state = FLOW_FIELD_NODE_VISITING;
+				route.push_back(node);
+				if (!node->next_polygon) {
+					state = FLOW_FIELD_NODE_KEPT;
+					break;
+				}
+				node = r_flow_field.nodes.getptr(node->next_polygon);
+			}
+			for (FlowFieldNode *route_node : route) {
+				route_node->state = state;
+			}
+			if (E.value.state == FLOW_FIELD_NODE_DROPPED) {
+				dropped_polygons.push_back(E.key);
+			}
+		}
+
+		for (const gd::Polygon *dropped_polygon : dropped_polygons) {
+			r_flow_field.nodes.erase(dropped_polygon);
+		}
+	}
+
+	r_flow_field.target_polygon = target_polygon;
+	r_flow_field.region_versions = region_versions;
+	r_flow_field.iteration_id = iteration_id;
+
+
+	// Gather the polygons with compatible layers and the connections leading into each of them.
+	struct IncomingConnection {
+		uint32_t from_index = 0;
+		const gd::Edge::Connection *connection = nullptr;
+	};
+
+	LocalVector<const gd::Polygon *> polygons;
+	HashMap<const gd::Polygon *, uint32_t> polygon_indices;
+	for (NavRegion *region : regions) {
+		if (!region_versions.has(region) || (r_flow_field.navigation_layers & region->get_navigation_layers()) == 0) {
+			continue;
+		}
+		for (const gd::Polygon &polygon : region->get_polygons()) {
+			polygon_indices.insert(&polygon, polygons.size());
+			polygons.push_back(&polygon);
+		}
+	}
+	for (const gd::Polygon &polygon : link_polygons) {
+		if (polygon.owner && (r_flow_field.navigation_layers & polygon.owner->get_navigation_layers()) != 0) {
+			polygon_indices.insert(&polygon, polygons.size());
+			polygons.push_back(&polygon);
+		}
+	}
+
+	const uint32_t *target_index = target_polygon ? polygon_indices.getptr(target_polygon) : nullptr;
+	if (!target_index) {
+		r_flow_field.nodes.clear();
+		return;
+	}
+
+	LocalVector<LocalVector<IncomingConnection>> incoming_connections;
+	incoming_connections.resize(polygons.size());
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		for (const gd::Edge &edge : polygons[i]->edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				const uint32_t *to_index = polygon_indices.getptr(connection.polygon);
+				if (to_index) {
+					incoming_connections[*to_index].push_back({ i, &connection });
+				}
+			}
+		}
+	}
+
+	SortArray<FlowFieldQueueItem, FlowFieldQueueItemCmp> sorter;
+	LocalVector<FlowFieldQueueItem> open_list;
+
+	LocalVector<real_t> distances;
+	distances.resize(polygons.size());
+	for (uint32_t i = 0; i < polygons.size(); i++) {
+		const FlowFieldNode *node = r_flow_field.nodes.getptr(polygons[i]);
+		distances[i] = node ? node->distance : FLT_MAX;
+	}
+
+	if (r_flow_field.nodes.is_empty()) {
+		FlowFieldNode target_node;
+		target_node.owner = target_polygon->owner;
+		target_node.waypoint = target_point;
+		r_flow_field.nodes.insert(target_polygon, target_node);
+		distances[*target_index] = 0.0;
+		open_list.push_back({ 0.0, *target_index });
+	} else {
+		// Continue the search from the kept nodes bordering the dropped ones, and from every kept node
+		// with a connection from a new polygon, the search also lowers kept distances where a change opened a shortcut.
+		for (uint32_t i = 0; i < polygons.size(); i++) {
+			if (distances[i] == FLT_MAX) {
+				continue;
+			}
+			for (const IncomingConnection &incoming : incoming_connections[i]) {
+				if (distances[incoming.from_index] == FLT_MAX) {
+					open_list.push_back({ distances[i], i });
+					sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+					break;
+				}
+			}
+		}
+	}
+
+	// Dijkstra from the target over the reversed connections.
+	while (!open_list.is_empty()) {
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		const FlowFieldQueueItem item = open_list[open_list.size() - 1];
+		open_list.remove_at(open_list.size() - 1);
+
+		if (item.distance > distances[item.index]) {
+			continue; // Stale entry, the polygon was reached through a shorter route.
+		}
+
+		const gd::Polygon *polygon = polygons[item.index];
+		for (const IncomingConnection &incoming : incoming_connections[item.index]) {
+			const gd::Polygon *from_polygon = polygons[incoming.from_index];
+			real_t distance = item.distance + from_polygon->center.distance_to(polygon->center) * from_polygon->owner->get_travel_cost();
+			if (from_polygon->owner != polygon->owner) {
+				distance += polygon->owner->get_enter_cost();
+			}
+			if (distance >= distances[incoming.from_index]) {
+				continue;
+			}
+			distances[incoming.from_index] = distance;
+
+			FlowFieldNode &node = r_flow_field.nodes[from_polygon];
+			node.owner = from_polygon->owner;
+			node.next_polygon = polygon;
+			node.waypoint = (incoming.connection->pathway_start + incoming.connection->pathway_end) * 0.5;
+			node.distance = distance;
+
+			open_list.push_back({ distance, incoming.from_index });
+			sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+		}
+	}
+}
+
+void NavMap::_update_polygon_grid() const {
+	polygon_grid.clear();
+	polygon_grid_iteration_id = iteration_id;
+
+	// Cells about the size of an average polygon keep the candidates per cell low.
+	real_t polygon_extents = 0.0;
+	uint32_t polygon_count = 0;
+	for (NavRegion *region : regions) {
+		const RegionCache *cache = region_caches.getptr(region);
+		if (!cache || !cache->indexed || !region->get_enabled()) {
+			continue;
+		}
+		for (const gd::Polygon &polygon : region->get_polygons()) {
+			AABB polygon_aabb(polygon.points[0].pos, Vector3());
+			for (const gd::Point &point : polygon.points) {
+				polygon_aabb.expand_to(point.pos);
+			}
+			polygon_extents += MAX(polygon_aabb.size.x, polygon_aabb.size.z);
+			polygon_count++;
+		}
+	}
+	if (polygon_count == 0) {
+		return;
+	}
+	polygon_grid_cell_size = MAX(polygon_extents / polygon_count, cell_size);
+
+	for (NavRegion *region : regions) {
+		const RegionCache *cache = region_caches.getptr(region);
+		if (!cache || !cache->indexed || !region->get_enabled()) {
+			continue;
+		}
+		for (const gd::Polygon &polygon : region->get_polygons()) {
+			AABB polygon_aabb(polygon.points[0].pos, Vector3());
+			for (const gd::Point &point : polygon.points) {
+				polygon_aabb.expand_to(point.pos);
+			}
+			const Vector3 from = polygon_aabb.position / polygon_grid_cell_size;
+			const Vector3 to = polygon_aabb.get_end() / polygon_grid_cell_size;
+			for (int z = Math::floor(from.z); z <= Math::floor(to.z); z++) {
+				for (int x = Math::floor(from.x); x <= Math::floor(to.x); x++) {
+					polygon_grid[Vector2i(x, z)].push_back(&polygon);
+				}
+			}
+		}
+	}
+}
+
+const gd::Polygon *NavMap::_get_grid_polygon(const Vector3 &p_point, uint32_t p_navigation_layers) const {
+	const Vector2i cell(Math::floor(p_point.x / polygon_grid_cell_size), Math::floor(p_point.z / polygon_grid_cell_size));
+	HashMap<Vector2i, LocalVector<const gd::Polygon *>>::ConstIterator E = polygon_grid.find(cell);
+	if (!E) {
+		return nullptr;
+	}
+
+	const gd::Polygon *closest_polygon = nullptr;
+	real_t closest_ds = FLT_MAX;
+	for (const gd::Polygon *polygon : E->value) {
+		if ((p_navigation_layers & polygon->owner->get_navigation_layers()) == 0) {
+			continue;
+		}
+		for (uint32_t point_id = 2; point_id < polygon->points.size(); point_id++) {
+			const Face3 face(polygon->points[0].pos, polygon->points[point_id - 1].pos, polygon->points[point_id].pos);
+			const real_t ds = face.get_closest_point_to(p_point).distance_squared_to(p_point);
+			if (ds < closest_ds) {
+				closest_ds = ds;
+				closest_polygon = polygon;
+			}
+		}
+	}
+	return closest_polygon;
+}
+
+void NavMap::_clear_hierarchy() {
+	hierarchy_clusters.clear();
+	hierarchy_portals.clear();
+	hierarchy_cluster_indices.clear();
+	hierarchy_edge_count = 0;
+}
+
+void NavMap::_build_hierarchy(uint32_t p_link_polygon_count) {
+	_clear_hierarchy();
+
+	if (!use_hierarchical_pathfinding) {
+		return;
+	}
+
+	// Every region with polygons and every connected link is a cluster.
+	for (NavRegion *region : regions) {
+		const RegionCache *cache = region_caches.getptr(region);
+		if (!cache || !cache->indexed || region->get_polygons().is_empty()) {
+			continue;
+		}
+		HierarchyCluster cluster;
+		cluster.owner = region;
+		cluster.polygons = region->get_polygons().ptr();
+		cluster.polygon_count = region->get_polygons().size();
+		hierarchy_cluster_indices.insert(region, hierarchy_clusters.size());
+		hierarchy_clusters.push_back(cluster);
+	}
+
+	for (uint32_t i = 0; i < p_link_polygon_count; i++) {
+		HierarchyCluster cluster;
+		cluster.owner = link_polygons[i].owner;
+		cluster.polygons = &link_polygons[i];
+		cluster.polygon_count = 1;
+		hierarchy_cluster_indices.insert(cluster.owner, hierarchy_clusters.size());
+		hierarchy_clusters.push_back(cluster);
+	}
+
+	// Group the connections leaving each cluster by the cluster they lead to.
+	HashMap<uint32_t, uint32_t> portal_indices;
+	for (uint32_t cluster_index = 0; cluster_index < hierarchy_clusters.size(); cluster_index++) {
+		HierarchyCluster &cluster = hierarchy_clusters[cluster_index];
+		portal_indices.clear();
+
+		for (uint32_t polygon_index = 0; polygon_index < cluster.polygon_count; polygon_index++) {
+			for (const gd::Edge &edge : cluster.polygons[polygon_index].edges) {
+				for (const gd::Edge::Connection &connection : edge.connections) {
+					if (connection.polygon->owner == cluster.owner) {
+						continue;
+					}
+					const uint32_t *target_index = hierarchy_cluster_indices.getptr(connection.polygon->owner);
+					ERR_CONTINUE(!target_index);
+					const HierarchyCluster &target = hierarchy_clusters[*target_index];
+
+					uint32_t portal_index;
+					HashMap<uint32_t, uint32_t>::Iterator E = portal_indices.find(*target_index);
+					if (E) {
+						portal_index = E->value;
+					} else {
+						portal_index = hierarchy_portals.size();
+						portal_indices.insert(*target_index, portal_index);
+						hierarchy_portals.push_back(HierarchyPortal());
+						hierarchy_portals[portal_index].from_cluster = cluster_index;
+						hierarchy_portals[portal_index].to_cluster = *target_index;
+						cluster.out_portals.push_back(portal_index);
+						hierarchy_clusters[*target_index].in_portals.push_back(portal_index);
+					}
+
+					HierarchyCrossing crossing;
+					crossing.from_polygon = polygon_index;
+					crossing.to_polygon = connection.polygon - target.polygons;
+					crossing.position = (connection.pathway_start + connection.pathway_end) * 0.5;
+					hierarchy_portals[portal_index].crossings.push_back(crossing);
+				}
+			}
+		}
+	}
+
+	for (HierarchyPortal &portal : hierarchy_portals) {
+		Vector3 position;
+		for (const HierarchyCrossing &crossing : portal.crossings) {
+			position += crossing.position;
+		}
+		portal.position = position / real_t(portal.crossings.size());
+	}
+
+	// Precompute the distances through each cluster from every portal entering it to every portal leaving it.
+	LocalVector<real_t> distances;
+	for (const HierarchyCluster &cluster : hierarchy_clusters) {
+		if (cluster.out_portals.is_empty()) {
+			continue;
+		}
+		for (uint32_t in_portal_index : cluster.in_portals) {
+			HierarchyPortal &in_portal = hierarchy_portals[in_portal_index];
+			_compute_cluster_distances(cluster, in_portal.crossings, true, distances);
+
+			for (uint32_t out_portal_index : cluster.out_portals) {
+				const HierarchyPortal &out_portal = hierarchy_portals[out_portal_index];
+				// Going straight back where we came from is never shorter.
+				if (out_portal.to_cluster == in_portal.from_cluster) {
+					continue;
+				}
+
+				real_t distance = FLT_MAX;
+				for (const HierarchyCrossing &crossing : out_portal.crossings) {
+					const real_t d = distances[crossing.from_polygon];
+					if (d < FLT_MAX) {
+						distance = MIN(distance, d + cluster.polygons[crossing.from_polygon].center.distance_to(crossing.position));
+					}
+				}
+				if (distance < FLT_MAX) {
+					HierarchyEdge hierarchy_edge;
+					hierarchy_edge.portal = out_portal_index;
+					hierarchy_edge.distance = distance;
+					in_portal.edges.push_back(hierarchy_edge);
+					hierarchy_edge_count++;
+				}
+			}
+		}
+	}
+}
+
+struct HierarchyQueueItem {
+	real_t cost = 0.0;
+	uint32_t index = 0;
+};
+
+struct HierarchyQueueItemCmp {
+	_FORCE_INLINE_ bool operator()(const HierarchyQueueItem &p_left, const HierarchyQueueItem &p_right) const {
+		// Returns true when the left item is worse, so the heap keeps the cheapest item on top.
+		return p_left.cost > p_right.cost;
+	}
+};
+
+void NavMap::_compute_cluster_distances(const HierarchyCluster &p_cluster, const LocalVector<HierarchyCrossing> &p_seeds, bool p_seed_to_polygon, LocalVector<real_t> &r_distances) const {
+	r_distances.resize(p_cluster.polygon_count);
+	for (real_t &distance : r_distances) {
+		distance = FLT_MAX;
+	}
+
+	SortArray<HierarchyQueueItem, HierarchyQueueItemCmp> sorter;
+	LocalVector<HierarchyQueueItem> open_list;
+
+	for (const HierarchyCrossing &seed : p_seeds) {
+		const uint32_t polygon_index = p_seed_to_polygon ? seed.to_polygon : seed.from_polygon;
+		const real_t distance = p_cluster.polygons[polygon_index].center.distance_to(seed.position);
+		if (distance < r_distances[polygon_index]) {
+			r_distances[polygon_index] = distance;
+			open_list.push_back({ distance, polygon_index });
+			sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+		}
+	}
+
+	// Dijkstra over the polygon centers, only following the connections that stay inside the cluster.
+	while (!open_list.is_empty()) {
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		const HierarchyQueueItem item = open_list[open_list.size() - 1];
+		open_list.remove_at(open_list.size() - 1);
+
+		if (item.cost > r_distances[item.index]) {
+			continue; // Stale entry, the polygon was reached through a shorter route.
+		}
+
+		const gd::Polygon &polygon = p_cluster.polygons[item.index];
+		for (const gd::Edge &edge : polygon.edges) {
+			for (const gd::Edge::Connection &connection : edge.connections) {
+				if (connection.polygon->owner != p_cluster.owner) {
+					continue;
+				}
+				const uint32_t next_index = connection.polygon - p_cluster.polygons;
+				const real_t distance = item.cost + polygon.center.distance_to(connection.polygon->center);
+				if (distance < r_distances[next_index]) {
+					r_distances[next_index] = distance;
+					open_list.push_back({ distance, next_index });
+					sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+				}
+			}
+		}
+	}
+}
+
+bool NavMap::_get_hierarchy_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers, HashSet<const NavBase *> &r_corridor) const {
+	const uint32_t *begin_cluster_index = hierarchy_cluster_indices.getptr(p_begin_poly->owner);
+	const uint32_t *end_cluster_index = hierarchy_cluster_indices.getptr(p_end_poly->owner);
+	if (!begin_cluster_index || !end_cluster_index || *begin_cluster_index == *end_cluster_index) {
+		return false;
+	}
+
+	const HierarchyCluster &begin_cluster = hierarchy_clusters[*begin_cluster_index];
+	const HierarchyCluster &end_cluster = hierarchy_clusters[*end_cluster_index];
+
+	// Only the start and goal clusters are searched on the polygon level, everything else uses the precomputed distances.
+	LocalVector<HierarchyCrossing> seeds;
+	seeds.resize(1);
+	seeds[0].from_polygon = p_begin_poly - begin_cluster.polygons;
+	seeds[0].to_polygon = seeds[0].from_polygon;
+	seeds[0].position = p_begin_point;
+	LocalVector<real_t> begin_distances;
+	_compute_cluster_distances(begin_cluster, seeds, true, begin_distances);
+
+	seeds[0].from_polygon = p_end_poly - end_cluster.polygons;
+	seeds[0].to_polygon = seeds[0].from_polygon;
+	seeds[0].position = p_end_point;
+	LocalVector<real_t> end_distances;
+	_compute_cluster_distances(end_cluster, seeds, true, end_distances);
+
+	// The cheapest travel cost keeps the straight line heuristic from overestimating.
+	real_t min_travel_cost = FLT_MAX;
+	for (const HierarchyCluster &cluster : hierarchy_clusters) {
+		min_travel_cost = MIN(min_travel_cost, cluster.owner->get_travel_cost());
+	}
+
+	LocalVector<real_t> g_scores;
+	LocalVector<int> prev_portals;
+	g_scores.resize(hierarchy_portals.size());
+	prev_portals.resize(hierarchy_portals.size());
+	for (uint32_t i = 0; i < hierarchy_portals.size(); i++) {
+		g_scores[i] = FLT_MAX;
+		prev_portals[i] = -1;
+	}
+
+	SortArray<HierarchyQueueItem, HierarchyQueueItemCmp> sorter;
+	LocalVector<HierarchyQueueItem> open_list;
+
+	const real_t begin_travel_cost = begin_cluster.owner->get_travel_cost();
+	for (uint32_t portal_index : begin_cluster.out_portals) {
+		const HierarchyPortal &portal = hierarchy_portals[portal_index];
+		const NavBase *target_owner = hierarchy_clusters[portal.to_cluster].owner;
+		if ((p_navigation_layers & target_owner->get_navigation_layers()) == 0) {
+			continue;
+		}
+
+		real_t distance = FLT_MAX;
+		for (const HierarchyCrossing &crossing : portal.crossings) {
+			const real_t d = begin_distances[crossing.from_polygon];
+			if (d < FLT_MAX) {
+				distance = MIN(distance, d + begin_cluster.polygons[crossing.from_polygon].center.distance_to(crossing.position));
+			}
+		}
+		if (distance == FLT_MAX) {
+			continue;
+		}
+
+		g_scores[portal_index] = distance * begin_travel_cost + target_owner->get_enter_cost();
+		open_list.push_back({ g_scores[portal_index] + portal.position.distance_to(p_end_point) * min_travel_cost, portal_index });
+		sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+	}
+
+	// A* over the portals, the goal is reached through any portal entering the end cluster.
+	const real_t end_travel_cost = end_cluster.owner->get_travel_cost();
+	real_t best_cost = FLT_MAX;
+	int best_portal = -1;
+
+	while (!open_list.is_empty()) {
+		sorter.pop_heap(0, open_list.size(), open_list.ptr());
+		const HierarchyQueueItem item = open_list[open_list.size() - 1];
+		open_list.remove_at(open_list.size() - 1);
+
+		if (item.cost >= best_cost) {
+			break;
+		}
+
+		const HierarchyPortal &portal = hierarchy_portals[item.index];
+		const real_t g_score = g_scores[item.index];
+		if (item.cost > g_score + portal.position.distance_to(p_end_point) * min_travel_cost) {
+			continue; // Stale entry.
+		}
+
+		if (portal.to_cluster == *end_cluster_index) {
+			real_t distance = FLT_MAX;
+			for (const HierarchyCrossing &crossing : portal.crossings) {
+				const real_t d = end_distances[crossing.to_polygon];
+				if (d < FLT_MAX) {
+					distance = MIN(distance, d + end_cluster.polygons[crossing.to_polygon].center.distance_to(crossing.position));
+				}
+			}
+			if (distance < FLT_MAX && g_score + distance * end_travel_cost < best_cost) {
+				best_cost = g_score + distance * end_travel_cost;
+				best_portal = item.index;
+			}
+			continue;
+		}
+
+		const real_t travel_cost = hierarchy_clusters[portal.to_cluster].owner->get_travel_cost();
+		for (const HierarchyEdge &hierarchy_edge : portal.edges) {
+			const HierarchyPortal &next_portal = hierarchy_portals[hierarchy_edge.portal];
+			const NavBase *target_owner = hierarchy_clusters[next_portal.to_cluster].owner;
+			if ((p_navigation_layers & target_owner->get_navigation_layers()) == 0) {
+				continue;
+			}
+
+			const real_t new_g_score = g_score + hierarchy_edge.distance * travel_cost + target_owner->get_enter_cost();
+			if (new_g_score < g_scores[hierarchy_edge.portal]) {
+				g_scores[hierarchy_edge.portal] = new_g_score;
+				prev_portals[hierarchy_edge.portal] = item.index;
+				open_list.push_back({ new_g_score + next_portal.position.distance_to(p_end_point) * min_travel_cost, hierarchy_edge.portal });
+				sorter.push_heap(0, open_list.size() - 1, 0, open_list[open_list.size() - 1], open_list.ptr());
+			}
+		}
+	}
+
+	if (best_portal == -1) {
+		return false;
+	}
+
+	r_corridor.clear();
+	r_corridor.insert(begin_cluster.owner);
+	for (int portal_index = best_portal; portal_index != -1; portal_index = prev_portals[portal_index]) {
+		r_corridor.insert(hierarchy_clusters[hierarchy_portals[portal_index].to_cluster].owner);
+	}
+	return true;
+}
+
+NavMap::NavMap() {
+	avoidance_use_multiple_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_multiple_threads");
+	avoidance_use_high_priority_threads = GLOBAL_GET("navigation/avoidance/thread_model/avoidance_use_high_priority_threads");
+	avoidance_physics_ticks_per_step = MAX(int(GLOBAL_GET("navigation/avoidance/physics_ticks_per_avoidance_step")), 1);
+}
+
+NavMap::~NavMap() {
+	for (FlowField *flow_field : flow_fields) {
+		memdelete(flow_field);
+	}
 }
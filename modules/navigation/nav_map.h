@@ -36,6 +36,9 @@
 
 #include "core/math/math_defs.h"
 #include "core/object/worker_thread_pool.h"
+#include "core/os/mutex.h"
+#include "core/templates/hash_set.h"
+#include "core/templates/lru.h"
 
 #include <KdTree2d.h>
 #include <KdTree3d.h>
@@ -73,6 +76,8 @@ class NavMap : public NavRid {
 
 	bool regenerate_polygons = true;
 	bool regenerate_links = true;
+	/// Set when a map setting invalidates the connections of every region.
+	bool regenerate_region_connections = true;
 
 	/// Map regions
 	LocalVector<NavRegion *> regions;
@@ -81,8 +86,185 @@ class NavMap : public NavRid {
 	LocalVector<NavLink *> links;
 	LocalVector<gd::Polygon> link_polygons;
 
-	/// Map polygons
-	LocalVector<gd::Polygon> polygons;
+	/// Bounding volume hierarchy over the polygons of a region.
+	/// Used by every query looking for the polygon closest to a point.
+	struct PolygonBVH {
+		AABB aabb;
+		Vector3 center; // Used for sorting.
+		int left = -1;
+		int right = -1;
+
+		int polygon_index = -1;
+	};
+
+	struct PolygonBVHCmpX {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.x < p_right->center.x;
+		}
+	};
+
+	struct PolygonBVHCmpY {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.y < p_right->center.y;
+		}
+	};
+
+	struct PolygonBVHCmpZ {
+		bool operator()(const PolygonBVH *p_left, const PolygonBVH *p_right) const {
+			return p_left->center.z < p_right->center.z;
+		}
+	};
+
+	/// Map side data of a region, kept across syncs until the region polygons change.
+	/// The map polygons are the region polygons, connections are written directly into them.
+	struct RegionCache {
+		enum Pass {
+			PASS_NONE,
+			PASS_TOUCHED, // Connections are rebuilt in this sync.
+			PASS_BORDER, // Only the connections leading to touched regions are rebuilt.
+		};
+
+		/// Bounds of the region polygons, grown so that regions which can share or connect edges overlap.
+		AABB bounds;
+
+		LocalVector<PolygonBVH> polygon_bvh;
+		int polygon_bvh_root = -1;
+
+		uint32_t free_edge_count = 0;
+
+		/// Changes whenever the connections of the region polygons are rebuilt.
+		uint32_t connection_version = 0;
+
+		bool indexed = false;
+		bool dirty = true;
+		bool connections_dirty = false;
+		Pass pass = PASS_NONE;
+	};
+
+	HashMap<NavRegion *, RegionCache> region_caches;
+	uint32_t region_connection_version = 0;
+
+	/// Persistent edge key index of all the indexed regions, at most two polygon edges can share a key.
+	struct EdgeKeyConnections {
+		gd::Edge::Connection connections[2];
+		uint32_t count = 0;
+	};
+
+	HashMap<gd::EdgeKey, EdgeKeyConnections, gd::EdgeKey> edge_key_index;
+	int edge_key_merge_count = 0;
+
+	/// Region polygons holding a connection to one of the link polygons.
+	LocalVector<gd::Polygon *> link_connected_polygons;
+
+	/// Hierarchical pathfinding plans long paths over an abstract graph first.
+	/// Every region and link is a cluster, a portal is the crossing from one cluster into another.
+	/// The portal-to-portal distances inside a cluster are precomputed on sync, the polygon search
+	/// is then limited to the clusters along the abstract path.
+	bool use_hierarchical_pathfinding = false;
+
+	struct HierarchyCrossing {
+		uint32_t from_polygon = 0; // Index in the source cluster.
+		uint32_t to_polygon = 0; // Index in the target cluster.
+		Vector3 position; // Middle of the connection pathway.
+	};
+
+	struct HierarchyEdge {
+		uint32_t portal = 0;
+		/// Distance through the target cluster of the source portal, not scaled by its travel cost.
+		real_t distance = 0.0;
+	};
+
+	struct HierarchyPortal {
+		uint32_t from_cluster = 0;
+		uint32_t to_cluster = 0;
+		Vector3 position;
+		LocalVector<HierarchyCrossing> crossings;
+		LocalVector<HierarchyEdge> edges;
+	};
+
+	struct HierarchyCluster {
+		const NavBase *owner = nullptr;
+		const gd::Polygon *polygons = nullptr;
+		uint32_t polygon_count = 0;
+		LocalVector<uint32_t> in_portals;
+		LocalVector<uint32_t> out_portals;
+	};
+
+	LocalVector<HierarchyCluster> hierarchy_clusters;
+	LocalVector<HierarchyPortal> hierarchy_portals;
+	HashMap<const NavBase *, uint32_t> hierarchy_cluster_indices;
+	int hierarchy_edge_count = 0;
+
+	/// Polygon routes of the latest path queries, 0 disables the cache.
+	/// Cleared on every map change, a cached route is only valid for the map iteration it was found in.
+	struct PathCacheKey {
+		const gd::Polygon *begin_poly = nullptr;
+		const gd::Polygon *end_poly = nullptr;
+		uint32_t navigation_layers = 0;
+		uint32_t iteration_id = 0;
+
+		static uint32_t hash(const PathCacheKey &p_key) {
+			uint32_t h = hash_murmur3_one_64((uint64_t)p_key.begin_poly);
+			h = hash_murmur3_one_64((uint64_t)p_key.end_poly, h);
+			h = hash_murmur3_one_32(p_key.navigation_layers, h);
+			h = hash_murmur3_one_32(p_key.iteration_id, h);
+			return hash_fmix32(h);
+		}
+
+		bool operator==(const PathCacheKey &p_key) const {
+			return begin_poly == p_key.begin_poly && end_poly == p_key.end_poly && navigation_layers == p_key.navigation_layers && iteration_id == p_key.iteration_id;
+		}
+
+		PathCacheKey() {}
+		PathCacheKey(const gd::Polygon *p_begin_poly, const gd::Polygon *p_end_poly, uint32_t p_navigation_layers, uint32_t p_iteration_id) :
+				begin_poly(p_begin_poly),
+				end_poly(p_end_poly),
+				navigation_layers(p_navigation_layers),
+				iteration_id(p_iteration_id) {}
+	};
+
+	int path_cache_size = 0;
+	mutable Mutex path_cache_mutex;
+	mutable LRUCache<PathCacheKey, LocalVector<gd::NavigationPoly>, PathCacheKey> path_cache;
+
+	/// A flow field holds the next hop towards a shared target for every polygon that can reach it,
+	/// so any number of agents can follow it without running a path query of their own.
+	/// On map changes only the polygons whose route crossed a changed region or link are searched again.
+	enum FlowFieldNodeState {
+		FLOW_FIELD_NODE_UNKNOWN,
+		FLOW_FIELD_NODE_VISITING,
+		FLOW_FIELD_NODE_KEPT,
+		FLOW_FIELD_NODE_DROPPED,
+	};
+
+	struct FlowFieldNode {
+		/// The owner is kept to recognize nodes of changed regions, their polygons may be gone already.
+		const NavBase *owner = nullptr;
+		const gd::Polygon *next_polygon = nullptr; // Null for the target polygon.
+		Vector3 waypoint; // Middle of the pathway into the next polygon.
+		real_t distance = 0.0;
+		FlowFieldNodeState state = FLOW_FIELD_NODE_UNKNOWN;
+	};
+
+	struct FlowField {
+		Vector3 target_position;
+		uint32_t navigation_layers = 0;
+		const gd::Polygon *target_polygon = nullptr;
+		uint32_t iteration_id = 0;
+		uint64_t last_used = 0;
+		HashMap<const gd::Polygon *, FlowFieldNode> nodes;
+		HashMap<const NavBase *, uint32_t> region_versions;
+	};
+
+	static const uint32_t FLOW_FIELD_MAX_COUNT = 16;
+	mutable Mutex flow_field_mutex;
+	mutable LocalVector<FlowField *> flow_fields;
+	mutable uint64_t flow_field_use_count = 0;
+
+	/// Region polygons bucketed on a horizontal grid, sampling a flow field does not depend on the map size.
+	mutable HashMap<Vector2i, LocalVector<const gd::Polygon *>> polygon_grid;
+	mutable real_t polygon_grid_cell_size = 1.0;
+	mutable uint32_t polygon_grid_iteration_id = 0;
 
 	/// RVO avoidance worlds
 	RVO2D::RVOSimulator2D rvo_simulation_2d;
@@ -114,6 +296,11 @@ class NavMap : public NavRid {
 	bool avoidance_use_multiple_threads = true;
 	bool avoidance_use_high_priority_threads = true;
 
+	/// Avoidance is stepped once every this many physics ticks.
+	int avoidance_physics_ticks_per_step = 1;
+	int avoidance_ticks_since_step = 0;
+	real_t avoidance_accumulated_time = 0.0;
+
 	// Performance Monitor
 	int pm_region_count = 0;
 	int pm_agent_count = 0;
@@ -123,6 +310,9 @@ class NavMap : public NavRid {
 	int pm_edge_merge_count = 0;
 	int pm_edge_connection_count = 0;
 	int pm_edge_free_count = 0;
+	int pm_abstract_node_count = 0;
+	int pm_abstract_edge_count = 0;
+	int pm_avoidance_time = 0; // Duration of the latest avoidance step in microseconds.
 
 public:
 	NavMap();
@@ -163,9 +353,24 @@ public:
 		return link_connection_radius;
 	}
 
+	void set_path_cache_size(int p_size);
+	int get_path_cache_size() const {
+		MutexLock lock(path_cache_mutex);
+		return path_cache_size;
+	}
+	/// Drops the cached path routes and flow fields.
+	/// Must be called when the costs or layers of a region or link change, they do not change the map iteration.
+	void clear_query_caches();
+
+	void set_use_hierarchical_pathfinding(bool p_enabled);
+	bool get_use_hierarchical_pathfinding() const {
+		return use_hierarchical_pathfinding;
+	}
+
 	gd::PointKey get_point_key(const Vector3 &p_pos) const;
 
 	Vector<Vector3> get_path(Vector3 p_origin, Vector3 p_destination, bool p_optimize, uint32_t p_navigation_layers, Vector<int32_t> *r_path_types, TypedArray<RID> *r_path_rids, Vector<int64_t> *r_path_owners) const;
+	Vector3 get_flow_field_direction(const Vector3 &p_target_position, const Vector3 &p_position, uint32_t p_navigation_layers) const;
 	Vector3 get_closest_point_to_segment(const Vector3 &p_from, const Vector3 &p_to, const bool p_use_collision) const;
 	Vector3 get_closest_point(const Vector3 &p_point) const;
 	Vector3 get_closest_point_normal(const Vector3 &p_point) const;
@@ -216,6 +421,9 @@ public:
 	int get_pm_edge_merge_count() const { return pm_edge_merge_count; }
 	int get_pm_edge_connection_count() const { return pm_edge_connection_count; }
 	int get_pm_edge_free_count() const { return pm_edge_free_count; }
+	int get_pm_abstract_node_count() const { return pm_abstract_node_count; }
+	int get_pm_abstract_edge_count() const { return pm_abstract_edge_count; }
+	int get_pm_avoidance_time() const { return pm_avoidance_time; }
 
 private:
 	void compute_single_step(uint32_t index, NavAgent **agent);
@@ -230,6 +438,28 @@ private:
 	void _update_rvo_agents_tree_3d();
 
 	void _update_merge_rasterizer_cell_dimensions();
+
+	void _clear_region_connections();
+	void _disconnect_region(NavRegion *p_region);
+	void _index_region(NavRegion *p_region, RegionCache &r_cache);
+	void _update_region_connections();
+	void _connect_free_edges(const gd::Edge::Connection &p_free_edge, const gd::Edge::Connection &p_other_edge);
+	void _clear_link_connections();
+
+	int _create_polygon_bvh(LocalVector<PolygonBVH> &r_bvh, PolygonBVH **p_bb, int p_from, int p_size, int &r_max_alloc);
+	gd::Polygon *_get_closest_polygon(const Vector3 &p_point, bool p_use_layers, uint32_t p_navigation_layers, real_t p_max_distance, Vector3 &r_point, Vector3 *r_normal = nullptr) const;
+
+	bool _get_cached_route(const PathCacheKey &p_key, const Vector3 &p_begin_point, LocalVector<gd::NavigationPoly> &r_navigation_polys) const;
+	void _cache_route(const PathCacheKey &p_key, const LocalVector<gd::NavigationPoly> &p_navigation_polys, int p_end_id) const;
+
+	void _update_flow_field(FlowField &r_flow_field) const;
+	void _update_polygon_grid() const;
+	const gd::Polygon *_get_grid_polygon(const Vector3 &p_point, uint32_t p_navigation_layers) const;
+
+	void _clear_hierarchy();
+	void _build_hierarchy(uint32_t p_link_polygon_count);
+	void _compute_cluster_distances(const HierarchyCluster &p_cluster, const LocalVector<HierarchyCrossing> &p_seeds, bool p_seed_to_polygon, LocalVector<real_t> &r_distances) const;
+	bool _get_hierarchy_corridor(const gd::Polygon *p_begin_poly, const Vector3 &p_begin_point, const gd::Polygon *p_end_poly, const Vector3 &p_end_point, uint32_t p_navigation_layers, HashSet<const NavBase *> &r_corridor) const;
 };
 
 #endif // NAV_MAP_H
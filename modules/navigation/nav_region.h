@@ -60,6 +60,7 @@ public:
 	void scratch_polygons() {
 		polygons_dirty = true;
 	}
+	bool is_dirty() const { return polygons_dirty; }
 
 	void set_enabled(bool p_enabled);
 	bool get_enabled() const { return enabled; }
@@ -94,6 +95,10 @@ public:
 	LocalVector<gd::Polygon> const &get_polygons() const {
 		return polygons;
 	}
+	/// Used by the map to write the polygon connections.
+	LocalVector<gd::Polygon> &get_polygons() {
+		return polygons;
+	}
 
 	Vector3 get_random_point(uint32_t p_navigation_layers, bool p_uniformly) const;
 
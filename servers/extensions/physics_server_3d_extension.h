@@ -243,6 +243,9 @@ public:
 	EXBIND1RC(Vector<Vector3>, space_get_contacts, RID)
 	EXBIND1RC(int, space_get_contact_count, RID)
 
+	EXBIND1RC(PackedByteArray, space_save_state, RID)
+	EXBIND2R(bool, space_restore_state, RID, const PackedByteArray &)
+
 	/* AREA API */
 
 	//EXBIND0RID(area);
@@ -90,9 +90,24 @@ public:
 	/// Returns the link connection radius of this map.
 	virtual real_t map_get_link_connection_radius(RID p_map) const = 0;
 
+	/// Set if path queries on the map plan over the abstract graph of its regions and links first.
+	virtual void map_set_use_hierarchical_pathfinding(RID p_map, bool p_enabled) = 0;
+
+	/// Returns true if path queries on the map use hierarchical pathfinding.
+	virtual bool map_get_use_hierarchical_pathfinding(RID p_map) const = 0;
+
+	/// Set how many polygon routes of recent path queries the map keeps for reuse, 0 disables the cache.
+	virtual void map_set_path_cache_size(RID p_map, int p_size) = 0;
+
+	/// Returns the path cache size of this map.
+	virtual int map_get_path_cache_size(RID p_map) const = 0;
+
 	/// Returns the navigation path to reach the destination from the origin.
 	virtual Vector<Vector2> map_get_path(RID p_map, Vector2 p_origin, Vector2 p_destination, bool p_optimize, uint32_t p_navigation_layers = 1) const = 0;
 
+	/// Returns the direction to move in from the position to follow the shortest route to the target position, shared by all agents with the same target.
+	virtual Vector2 map_get_flow_field_direction(RID p_map, const Vector2 &p_target_position, const Vector2 &p_position, uint32_t p_navigation_layers = 1) const = 0;
+
 	virtual Vector2 map_get_closest_point(RID p_map, const Vector2 &p_point) const = 0;
 	virtual RID map_get_closest_point_owner(RID p_map, const Vector2 &p_point) const = 0;
 
@@ -59,19 +59,44 @@ void GodotBodyPair2D::_contact_added_callback(const Vector2 &p_point_A, const Ve
 	contact.used = true;
 
 	// Attempt to determine if the contact will be reused.
+	// The closest contact from the previous step within the recycle radius is picked,
+	// and each one can only be claimed once, so two new contacts never share an impulse.
 	real_t recycle_radius_2 = space->get_contact_recycle_radius() * space->get_contact_recycle_radius();
 
+	int recycled_index = -1;
+	real_t recycled_distance = 0.0;
+
 	for (int i = 0; i < contact_count; i++) {
-		Contact &c = contacts[i];
-		if (c.local_A.distance_squared_to(local_A) < (recycle_radius_2) &&
-				c.local_B.distance_squared_to(local_B) < (recycle_radius_2)) {
-			contact.acc_normal_impulse = c.acc_normal_impulse;
-			contact.acc_tangent_impulse = c.acc_tangent_impulse;
-			contact.acc_bias_impulse = c.acc_bias_impulse;
-			contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
-			c = contact;
-			return;
+		const Contact &c = contacts[i];
+		if (c.used) {
+			// Already added or recycled during this step.
+			continue;
+		}
+
+		real_t distance_A = c.local_A.distance_squared_to(local_A);
+		real_t distance_B = c.local_B.distance_squared_to(local_B);
+		if (distance_A >= recycle_radius_2 || distance_B >= recycle_radius_2) {
+			continue;
 		}
+
+		if (recycled_index == -1 || distance_A + distance_B < recycled_distance) {
+			recycled_index = i;
+			recycled_distance = distance_A + distance_B;
+		}
+	}
+
+	if (recycled_index != -1) {
+		Contact &c = contacts[recycled_index];
+
+		// Carry the accumulated impulse over in the frame of the new normal,
+		// so friction isn't warm-started along a stale tangent.
+		Vector2 impulse = c.normal * c.acc_normal_impulse + c.normal.orthogonal() * c.acc_tangent_impulse;
+		contact.acc_normal_impulse = MAX(impulse.dot(contact.normal), (real_t)0.0);
+		contact.acc_tangent_impulse = impulse.dot(contact.normal.orthogonal());
+		contact.acc_bias_impulse = c.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+		c = contact;
+		return;
 	}
 
 	// Figure out if the contact amount must be reduced to fit the new contact.
@@ -101,26 +101,33 @@ void GodotStep2D::_solve_island(uint32_t p_island_index, void *p_userdata) const
 	}
 }
 
-void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island) const {
+void GodotStep2D::_sleep_test_island(uint32_t p_island_index, void *p_userdata) {
+	const LocalVector<GodotBody2D *> &body_island = body_islands[p_island_index];
 	bool can_sleep = true;
 
-	uint32_t body_count = p_body_island.size();
+	// Islands don't share bodies, so this only touches this island's own data.
+	uint32_t body_count = body_island.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
-		GodotBody2D *body = p_body_island[body_index];
+		GodotBody2D *body = body_island[body_index];
 
 		if (!body->sleep_test(delta)) {
 			can_sleep = false;
 		}
 	}
 
+	body_island_can_sleep[p_island_index] = can_sleep;
+}
+
+void GodotStep2D::_check_suspend(LocalVector<GodotBody2D *> &p_body_island, bool p_can_sleep) const {
 	// Put all to sleep or wake up everyone.
+	uint32_t body_count = p_body_island.size();
 	for (uint32_t body_index = 0; body_index < body_count; ++body_index) {
 		GodotBody2D *body = p_body_island[body_index];
 
 		bool active = body->is_active();
 
-		if (active == can_sleep) {
-			body->set_active(!can_sleep);
+		if (active == p_can_sleep) {
+			body->set_active(!p_can_sleep);
 		}
 	}
 }
@@ -280,8 +287,15 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 	/* SLEEP / WAKE UP ISLANDS */
 
+	if (body_island_can_sleep.size() < body_island_count) {
+		body_island_can_sleep.resize(body_island_count);
+	}
+	group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotStep2D::_sleep_test_island, nullptr, body_island_count, -1, true, SNAME("Physics2DSleepTestIslands"));
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+
+	// Warning: This doesn't run on threads, because changing the active state updates the space's lists.
 	for (uint32_t island_index = 0; island_index < body_island_count; ++island_index) {
-		_check_suspend(body_islands[island_index]);
+		_check_suspend(body_islands[island_index], body_island_can_sleep[island_index]);
 	}
 
 	{ //profile
@@ -298,6 +312,7 @@ void GodotStep2D::step(GodotSpace2D *p_space, real_t p_delta) {
 
 GodotStep2D::GodotStep2D() {
 	body_islands.reserve(BODY_ISLAND_COUNT_RESERVE);
+	body_island_can_sleep.reserve(BODY_ISLAND_COUNT_RESERVE);
 	constraint_islands.reserve(ISLAND_COUNT_RESERVE);
 	all_constraints.reserve(CONSTRAINT_COUNT_RESERVE);
 }
@@ -187,6 +187,8 @@ void GodotBody3D::set_active(bool p_active) {
 	} else if (get_space()) {
 		get_space()->body_remove_from_active_list(&active_list);
 	}
+
+	_set_sleeping(!active && mode != PhysicsServer3D::BODY_MODE_STATIC);
 }
 
 void GodotBody3D::set_param(PhysicsServer3D::BodyParameter p_param, const Variant &p_value) {
@@ -336,6 +338,9 @@ void GodotBody3D::set_mode(PhysicsServer3D::BodyMode p_mode) {
 			set_active(true);
 		}
 	}
+
+	// Mode changes can leave the activity unchanged, but static bodies are never sleeping.
+	_set_sleeping(!active && mode != PhysicsServer3D::BODY_MODE_STATIC);
 }
 
 PhysicsServer3D::BodyMode GodotBody3D::get_mode() const {
@@ -461,6 +466,37 @@ void GodotBody3D::set_space(GodotSpace3D *p_space) {
 	}
 }
 
+void GodotBody3D::get_simulation_state(SimulationState &r_state) const {
+	r_state.transform = get_transform();
+	r_state.new_transform = new_transform;
+	r_state.linear_velocity = linear_velocity;
+	r_state.angular_velocity = angular_velocity;
+	r_state.prev_linear_velocity = prev_linear_velocity;
+	r_state.prev_angular_velocity = prev_angular_velocity;
+	r_state.still_time = still_time;
+	r_state.active = active;
+}
+
+void GodotBody3D::set_simulation_state(const SimulationState &p_state) {
+	if (get_transform() != p_state.transform) {
+		_set_transform(p_state.transform);
+		if (mode >= PhysicsServer3D::BODY_MODE_RIGID) {
+			_set_inv_transform(get_transform().inverse());
+		} else {
+			_set_inv_transform(get_transform().affine_inverse());
+		}
+		_update_transform_dependent();
+	}
+
+	new_transform = p_state.new_transform;
+	linear_velocity = p_state.linear_velocity;
+	angular_velocity = p_state.angular_velocity;
+	prev_linear_velocity = p_state.prev_linear_velocity;
+	prev_angular_velocity = p_state.prev_angular_velocity;
+	still_time = p_state.still_time;
+	set_active(p_state.active);
+}
+
 void GodotBody3D::set_axis_lock(PhysicsServer3D::BodyAxis p_axis, bool lock) {
 	if (lock) {
 		locked_axis |= p_axis;
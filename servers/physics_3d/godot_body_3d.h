@@ -316,6 +316,22 @@ public:
 	void set_axis_lock(PhysicsServer3D::BodyAxis p_axis, bool lock);
 	bool is_axis_locked(PhysicsServer3D::BodyAxis p_axis) const;
 
+	// State that changes during simulation, saved and restored along with the space state.
+	struct SimulationState {
+		Transform3D transform;
+		Transform3D new_transform;
+		Vector3 linear_velocity;
+		Vector3 angular_velocity;
+		Vector3 prev_linear_velocity;
+		Vector3 prev_angular_velocity;
+		real_t still_time = 0.0;
+		bool active = false;
+	};
+
+	void get_simulation_state(SimulationState &r_state) const;
+	void set_simulation_state(const SimulationState &p_state);
+	_FORCE_INLINE_ SelfList<GodotBody3D> *get_active_list_element() { return &active_list; }
+
 	void integrate_forces(real_t p_step);
 	void integrate_velocities(real_t p_step);
 
@@ -595,18 +595,62 @@ void GodotBodyPair3D::solve(real_t p_step) {
 	}
 }
 
+int GodotBodyPair3D::get_contact_cache(ContactCache *r_contacts) const {
+	for (int i = 0; i < contact_count; i++) {
+		const Contact &c = contacts[i];
+		ContactCache &cache = r_contacts[i];
+		cache.local_A = c.local_A;
+		cache.local_B = c.local_B;
+		cache.normal = c.normal;
+		cache.index_A = c.index_A;
+		cache.index_B = c.index_B;
+		cache.acc_normal_impulse = c.acc_normal_impulse;
+		cache.acc_tangent_impulse = c.acc_tangent_impulse;
+		cache.acc_bias_impulse = c.acc_bias_impulse;
+		cache.acc_bias_impulse_center_of_mass = c.acc_bias_impulse_center_of_mass;
+	}
+
+	return contact_count;
+}
+
+void GodotBodyPair3D::set_contact_cache(const ContactCache *p_contacts, int p_count) {
+	ERR_FAIL_COND(p_count < 0 || p_count > MAX_CONTACTS);
+
+	for (int i = 0; i < p_count; i++) {
+		const ContactCache &cache = p_contacts[i];
+		Contact contact;
+		contact.local_A = cache.local_A;
+		contact.local_B = cache.local_B;
+		contact.normal = cache.normal;
+		contact.index_A = cache.index_A;
+		contact.index_B = cache.index_B;
+		contact.acc_normal_impulse = cache.acc_normal_impulse;
+		contact.acc_tangent_impulse = cache.acc_tangent_impulse;
+		contact.acc_bias_impulse = cache.acc_bias_impulse;
+		contact.acc_bias_impulse_center_of_mass = cache.acc_bias_impulse_center_of_mass;
+		// Keep the contact through the next validation, as if it was found during the last step.
+		contact.used = true;
+		contacts[i] = contact;
+	}
+
+	contact_count = p_count;
+}
+
 GodotBodyPair3D::GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B) :
-		GodotBodyContact3D(_arr, 2) {
+		GodotBodyContact3D(_arr, 2),
+		body_pair_list(this) {
 	A = p_A;
 	B = p_B;
 	shape_A = p_shape_A;
 	shape_B = p_shape_B;
 	space = A->get_space();
+	space->add_body_pair(&body_pair_list);
 	A->add_constraint(this, 0);
 	B->add_constraint(this, 1);
 }
 
 GodotBodyPair3D::~GodotBodyPair3D() {
+	space->remove_body_pair(&body_pair_list);
 	A->remove_constraint(this);
 	B->remove_constraint(this);
 }
@@ -71,10 +71,23 @@ protected:
 };
 
 class GodotBodyPair3D : public GodotBodyContact3D {
+public:
 	enum {
 		MAX_CONTACTS = 4
 	};
 
+	// Warm-start data of a contact, saved and restored along with the space state.
+	struct ContactCache {
+		Vector3 local_A, local_B;
+		Vector3 normal;
+		int index_A = 0, index_B = 0;
+		real_t acc_normal_impulse = 0.0;
+		Vector3 acc_tangent_impulse;
+		real_t acc_bias_impulse = 0.0;
+		real_t acc_bias_impulse_center_of_mass = 0.0;
+	};
+
+private:
 	union {
 		struct {
 			GodotBody3D *A;
@@ -97,6 +110,8 @@ class GodotBodyPair3D : public GodotBodyContact3D {
 	Contact contacts[MAX_CONTACTS];
 	int contact_count = 0;
 
+	SelfList<GodotBodyPair3D> body_pair_list;
+
 	static void _contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal, void *p_userdata);
 
 	void contact_added_callback(const Vector3 &p_point_A, int p_index_A, const Vector3 &p_point_B, int p_index_B, const Vector3 &normal);
@@ -109,6 +124,16 @@ public:
 	virtual bool pre_solve(real_t p_step) override;
 	virtual void solve(real_t p_step) override;
 
+	_FORCE_INLINE_ GodotBody3D *get_body_A() const { return A; }
+	_FORCE_INLINE_ GodotBody3D *get_body_B() const { return B; }
+	_FORCE_INLINE_ int get_shape_A() const { return shape_A; }
+	_FORCE_INLINE_ int get_shape_B() const { return shape_B; }
+	_FORCE_INLINE_ int get_contact_count() const { return contact_count; }
+
+	// r_contacts must have room for MAX_CONTACTS elements. Returns the number of contacts.
+	int get_contact_cache(ContactCache *r_contacts) const;
+	void set_contact_cache(const ContactCache *p_contacts, int p_count);
+
 	GodotBodyPair3D(GodotBody3D *p_A, int p_shape_A, GodotBody3D *p_B, int p_shape_B);
 	~GodotBodyPair3D();
 };
@@ -32,9 +32,23 @@
 
 #include "godot_collision_object_3d.h"
 
-GodotBroadPhase3DBVH::ID GodotBroadPhase3DBVH::create(GodotCollisionObject3D *p_object, int p_subindex, const AABB &p_aabb, bool p_static) {
-	uint32_t tree_id = p_static ? TREE_STATIC : TREE_DYNAMIC;
-	uint32_t tree_collision_mask = p_static ? TREE_FLAG_DYNAMIC : (TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC);
+void GodotBroadPhase3DBVH::_get_tree(bool p_static, bool p_sleeping, uint32_t &r_tree_id, uint32_t &r_tree_collision_mask) {
+	if (p_static) {
+		// Static items never move, they don't need to be tracked as sleeping.
+		r_tree_id = TREE_STATIC;
+		r_tree_collision_mask = TREE_FLAG_DYNAMIC | TREE_FLAG_SLEEPING;
+	} else {
+		// The collision mask is the same whether sleeping or not, so waking up or
+		// falling asleep never creates or removes pairs.
+		r_tree_id = p_sleeping ? TREE_SLEEPING : TREE_DYNAMIC;
+		r_tree_collision_mask = TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC | TREE_FLAG_SLEEPING;
+	}
+}
+
+GodotBroadPhase3DBVH::ID GodotBroadPhase3DBVH::create(GodotCollisionObject3D *p_object, int p_subindex, const AABB &p_aabb, bool p_static, bool p_sleeping) {
+	uint32_t tree_id;
+	uint32_t tree_collision_mask;
+	_get_tree(p_static, p_sleeping, tree_id, tree_collision_mask);
 	ID oid = bvh.create(p_object, true, tree_id, tree_collision_mask, p_aabb, p_subindex); // Pair everything, don't care?
 	return oid + 1;
 }
@@ -44,10 +58,11 @@ void GodotBroadPhase3DBVH::move(ID p_id, const AABB &p_aabb) {
 	bvh.move(p_id - 1, p_aabb);
 }
 
-void GodotBroadPhase3DBVH::set_static(ID p_id, bool p_static) {
+void GodotBroadPhase3DBVH::set_static(ID p_id, bool p_static, bool p_sleeping) {
 	ERR_FAIL_COND(!p_id);
-	uint32_t tree_id = p_static ? TREE_STATIC : TREE_DYNAMIC;
-	uint32_t tree_collision_mask = p_static ? TREE_FLAG_DYNAMIC : (TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC);
+	uint32_t tree_id;
+	uint32_t tree_collision_mask;
+	_get_tree(p_static, p_sleeping, tree_id, tree_collision_mask);
 	bvh.set_tree(p_id - 1, tree_id, tree_collision_mask, false);
 }
 
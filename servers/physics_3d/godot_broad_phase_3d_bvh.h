@@ -53,17 +53,24 @@ class GodotBroadPhase3DBVH : public GodotBroadPhase3D {
 		}
 	};
 
+	// Sleeping bodies live in their own tree, so the dynamic tree only holds moving
+	// items and stays small. Sleeping items still pair with everything else, so
+	// moving bodies can wake them up.
 	enum Tree {
 		TREE_STATIC = 0,
 		TREE_DYNAMIC = 1,
+		TREE_SLEEPING = 2,
 	};
 
 	enum TreeFlag {
 		TREE_FLAG_STATIC = 1 << TREE_STATIC,
 		TREE_FLAG_DYNAMIC = 1 << TREE_DYNAMIC,
+		TREE_FLAG_SLEEPING = 1 << TREE_SLEEPING,
 	};
 
-	BVH_Manager<GodotCollisionObject3D, 2, true, 128, UserPairTestFunction<GodotCollisionObject3D>, UserCullTestFunction<GodotCollisionObject3D>> bvh;
+	BVH_Manager<GodotCollisionObject3D, 3, true, 128, UserPairTestFunction<GodotCollisionObject3D>, UserCullTestFunction<GodotCollisionObject3D>> bvh;
+
+	static void _get_tree(bool p_static, bool p_sleeping, uint32_t &r_tree_id, uint32_t &r_tree_collision_mask);
 
 	static void *_pair_callback(void *, uint32_t, GodotCollisionObject3D *, int, uint32_t, GodotCollisionObject3D *, int);
 	static void _unpair_callback(void *, uint32_t, GodotCollisionObject3D *, int, uint32_t, GodotCollisionObject3D *, int, void *);
@@ -75,9 +82,9 @@ class GodotBroadPhase3DBVH : public GodotBroadPhase3D {
 
 public:
 	// 0 is an invalid ID
-	virtual ID create(GodotCollisionObject3D *p_object, int p_subindex = 0, const AABB &p_aabb = AABB(), bool p_static = false) override;
+	virtual ID create(GodotCollisionObject3D *p_object, int p_subindex = 0, const AABB &p_aabb = AABB(), bool p_static = false, bool p_sleeping = false) override;
 	virtual void move(ID p_id, const AABB &p_aabb) override;
-	virtual void set_static(ID p_id, bool p_static) override;
+	virtual void set_static(ID p_id, bool p_static, bool p_sleeping) override;
 	virtual void remove(ID p_id) override;
 
 	virtual GodotCollisionObject3D *get_object(ID p_id) const override;
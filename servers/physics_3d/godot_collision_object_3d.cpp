@@ -137,7 +137,29 @@ void GodotCollisionObject3D::_set_static(bool p_static) {
 	for (int i = 0; i < get_shape_count(); i++) {
 		const Shape &s = shapes[i];
 		if (s.bpid > 0) {
-			space->get_broadphase()->set_static(s.bpid, _static);
+			space->get_broadphase()->set_static(s.bpid, _static, _sleeping);
+		}
+	}
+}
+
+void GodotCollisionObject3D::_set_sleeping(bool p_sleeping) {
+	if (_sleeping == p_sleeping) {
+		return;
+	}
+	_sleeping = p_sleeping;
+
+	if (!space) {
+		return;
+	}
+	if (_sleeping) {
+		space->add_sleeping_object();
+	} else {
+		space->remove_sleeping_object();
+	}
+	for (int i = 0; i < get_shape_count(); i++) {
+		const Shape &s = shapes[i];
+		if (s.bpid > 0) {
+			space->get_broadphase()->set_static(s.bpid, _static, _sleeping);
 		}
 	}
 }
@@ -174,8 +196,7 @@ void GodotCollisionObject3D::_update_shapes() {
 		s.area_cache = s.shape->get_volume() * scale.x * scale.y * scale.z;
 
 		if (s.bpid == 0) {
-			s.bpid = space->get_broadphase()->create(this, i, shape_aabb, _static);
-			space->get_broadphase()->set_static(s.bpid, _static);
+			s.bpid = space->get_broadphase()->create(this, i, shape_aabb, _static, _sleeping);
 		}
 
 		space->get_broadphase()->move(s.bpid, shape_aabb);
@@ -201,8 +222,7 @@ void GodotCollisionObject3D::_update_shapes_with_motion(const Vector3 &p_motion)
 		s.aabb_cache = shape_aabb;
 
 		if (s.bpid == 0) {
-			s.bpid = space->get_broadphase()->create(this, i, shape_aabb, _static);
-			space->get_broadphase()->set_static(s.bpid, _static);
+			s.bpid = space->get_broadphase()->create(this, i, shape_aabb, _static, _sleeping);
 		}
 
 		space->get_broadphase()->move(s.bpid, shape_aabb);
@@ -215,6 +235,9 @@ void GodotCollisionObject3D::_set_space(GodotSpace3D *p_space) {
 
 	if (old_space) {
 		old_space->remove_object(this);
+		if (_sleeping) {
+			old_space->remove_sleeping_object();
+		}
 
 		for (int i = 0; i < shapes.size(); i++) {
 			Shape &s = shapes.write[i];
@@ -227,6 +250,9 @@ void GodotCollisionObject3D::_set_space(GodotSpace3D *p_space) {
 
 	if (space) {
 		space->add_object(this);
+		if (_sleeping) {
+			space->add_sleeping_object();
+		}
 		_update_shapes();
 	}
 }
@@ -612,12 +612,35 @@ static void _generate_contacts_from_supports(const Vector3 *p_points_A, int p_po
 	contacts_func(points_A, pointcount_A, points_B, pointcount_B, p_callback);
 }
 
+// Convex polygons are projected on many axes per pair. Transforming their vertices once
+// for all the axes gives the same projections as project_range() without the per-axis work.
+#define SAT_MAX_TRANSFORMED_VERTICES 256
+
+template <class Shape>
+static _FORCE_INLINE_ void _project_range(const Shape *p_shape, const Vector3 *p_transformed_vertices, const Vector3 &p_axis, const Transform3D &p_transform, real_t &r_min, real_t &r_max) {
+	p_shape->project_range(p_axis, p_transform, r_min, r_max);
+}
+
+static _FORCE_INLINE_ void _project_range(const GodotConvexPolygonShape3D *p_shape, const Vector3 *p_transformed_vertices, const Vector3 &p_axis, const Transform3D &p_transform, real_t &r_min, real_t &r_max) {
+	if (p_transformed_vertices) {
+		p_shape->project_range_transformed(p_transformed_vertices, p_axis, r_min, r_max);
+	} else {
+		p_shape->project_range(p_axis, p_transform, r_min, r_max);
+	}
+}
+
+static _FORCE_INLINE_ bool _can_transform_vertices(const GodotConvexPolygonShape3D *p_shape) {
+	return p_shape->projects_all_vertices() && p_shape->get_mesh().vertices.size() <= SAT_MAX_TRANSFORMED_VERTICES;
+}
+
 template <class ShapeA, class ShapeB, bool withMargin = false>
 class SeparatorAxisTest {
 	const ShapeA *shape_A = nullptr;
 	const ShapeB *shape_B = nullptr;
 	const Transform3D *transform_A = nullptr;
 	const Transform3D *transform_B = nullptr;
+	const Vector3 *transformed_vertices_A = nullptr;
+	const Vector3 *transformed_vertices_B = nullptr;
 	real_t best_depth = 1e15;
 	_CollectorCallback *callback = nullptr;
 	real_t margin_A = 0.0;
@@ -645,8 +668,8 @@ public:
 
 		real_t min_A = 0.0, max_A = 0.0, min_B = 0.0, max_B = 0.0;
 
-		shape_A->project_range(axis, *transform_A, min_A, max_A);
-		shape_B->project_range(axis, *transform_B, min_B, max_B);
+		_project_range(shape_A, transformed_vertices_A, axis, *transform_A, min_A, max_A);
+		_project_range(shape_B, transformed_vertices_B, axis, *transform_B, min_B, max_B);
 
 		if (withMargin) {
 			min_A -= margin_A;
@@ -752,6 +775,12 @@ public:
 		callback->collided = true;
 	}
 
+	// Only for convex polygons, see _can_transform_vertices().
+	_FORCE_INLINE_ void set_transformed_vertices(const Vector3 *p_vertices_A, const Vector3 *p_vertices_B) {
+		transformed_vertices_A = p_vertices_A;
+		transformed_vertices_B = p_vertices_B;
+	}
+
 	_FORCE_INLINE_ SeparatorAxisTest(const ShapeA *p_shape_A, const Transform3D &p_transform_A, const ShapeB *p_shape_B, const Transform3D &p_transform_B, _CollectorCallback *p_callback, real_t p_margin_A = 0, real_t p_margin_B = 0) {
 		shape_A = p_shape_A;
 		shape_B = p_shape_B;
@@ -1397,6 +1426,14 @@ static void _collision_box_convex_polygon(const GodotShape3D *p_a, const Transfo
 	const Vector3 *vertices = mesh.vertices.ptr();
 	int vertex_count = mesh.vertices.size();
 
+	if (_can_transform_vertices(convex_polygon_B)) {
+		Vector3 *transformed_vertices = (Vector3 *)alloca(sizeof(Vector3) * vertex_count);
+		for (int i = 0; i < vertex_count; i++) {
+			transformed_vertices[i] = p_transform_b.xform(vertices[i]);
+		}
+		separator.set_transformed_vertices(nullptr, transformed_vertices);
+	}
+
 	// faces of A
 	for (int i = 0; i < 3; i++) {
 		Vector3 axis = p_transform_a.basis.get_column(i).normalized();
@@ -1704,6 +1741,15 @@ static void _collision_capsule_convex_polygon(const GodotShape3D *p_a, const Tra
 	const Geometry3D::MeshData::Edge *edges = mesh.edges.ptr();
 	int edge_count = mesh.edges.size();
 	const Vector3 *vertices = mesh.vertices.ptr();
+	int vertex_count = mesh.vertices.size();
+
+	if (_can_transform_vertices(convex_polygon_B)) {
+		Vector3 *transformed_vertices = (Vector3 *)alloca(sizeof(Vector3) * vertex_count);
+		for (int i = 0; i < vertex_count; i++) {
+			transformed_vertices[i] = p_transform_b.xform(vertices[i]);
+		}
+		separator.set_transformed_vertices(nullptr, transformed_vertices);
+	}
 
 	// Precalculating this makes the transforms faster.
 	Basis b_xform_normal = p_transform_b.basis.inverse().transposed();
@@ -2064,6 +2110,22 @@ static void _collision_convex_polygon_convex_polygon(const GodotShape3D *p_a, co
 	const Vector3 *vertices_B = mesh_B.vertices.ptr();
 	int vertex_count_B = mesh_B.vertices.size();
 
+	Vector3 *transformed_vertices_A = nullptr;
+	if (_can_transform_vertices(convex_polygon_A)) {
+		transformed_vertices_A = (Vector3 *)alloca(sizeof(Vector3) * vertex_count_A);
+		for (int i = 0; i < vertex_count_A; i++) {
+			transformed_vertices_A[i] = p_transform_a.xform(vertices_A[i]);
+		}
+	}
+	Vector3 *transformed_vertices_B = nullptr;
+	if (_can_transform_vertices(convex_polygon_B)) {
+		transformed_vertices_B = (Vector3 *)alloca(sizeof(Vector3) * vertex_count_B);
+		for (int i = 0; i < vertex_count_B; i++) {
+			transformed_vertices_B[i] = p_transform_b.xform(vertices_B[i]);
+		}
+	}
+	separator.set_transformed_vertices(transformed_vertices_A, transformed_vertices_B);
+
 	// Precalculating this makes the transforms faster.
 	Basis a_xform_normal = p_transform_a.basis.inverse().transposed();
 
@@ -2175,6 +2237,14 @@ static void _collision_convex_polygon_face(const GodotShape3D *p_a, const Transf
 	const Vector3 *vertices = mesh.vertices.ptr();
 	int vertex_count = mesh.vertices.size();
 
+	if (_can_transform_vertices(convex_polygon_A)) {
+		Vector3 *transformed_vertices = (Vector3 *)alloca(sizeof(Vector3) * vertex_count);
+		for (int i = 0; i < vertex_count; i++) {
+			transformed_vertices[i] = p_transform_a.xform(vertices[i]);
+		}
+		separator.set_transformed_vertices(transformed_vertices, nullptr);
+	}
+
 	Vector3 vertex[3] = {
 		p_transform_b.xform(face_B->vertex[0]),
 		p_transform_b.xform(face_B->vertex[1]),
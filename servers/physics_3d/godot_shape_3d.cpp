@@ -850,6 +850,20 @@ void GodotConvexPolygonShape3D::project_range(const Vector3 &p_normal, const Tra
 	}
 }
 
+void GodotConvexPolygonShape3D::project_range_transformed(const Vector3 *p_transformed_vertices, const Vector3 &p_normal, real_t &r_min, real_t &r_max) const {
+	uint32_t vertex_count = mesh.vertices.size();
+	for (uint32_t i = 0; i < vertex_count; i++) {
+		real_t d = p_normal.dot(p_transformed_vertices[i]);
+
+		if (i == 0 || d > r_max) {
+			r_max = d;
+		}
+		if (i == 0 || d < r_min) {
+			r_min = d;
+		}
+	}
+}
+
 Vector3 GodotConvexPolygonShape3D::get_support(const Vector3 &p_normal) const {
 	// Skip if there are no vertices in the mesh
 	if (mesh.vertices.size() == 0) {
@@ -288,6 +288,10 @@ public:
 	virtual PhysicsServer3D::ShapeType get_type() const override { return PhysicsServer3D::SHAPE_CONVEX_POLYGON; }
 
 	virtual void project_range(const Vector3 &p_normal, const Transform3D &p_transform, real_t &r_min, real_t &r_max) const override;
+	// True if project_range() scans every vertex, so vertices transformed once can be reused across projections.
+	_FORCE_INLINE_ bool projects_all_vertices() const { return mesh.vertices.size() <= 3 * extreme_vertices.size(); }
+	// Same result as project_range(), given the vertices already transformed.
+	void project_range_transformed(const Vector3 *p_transformed_vertices, const Vector3 &p_normal, real_t &r_min, real_t &r_max) const;
 	virtual Vector3 get_support(const Vector3 &p_normal) const override;
 	virtual void get_supports(const Vector3 &p_normal, int p_max, Vector3 *r_supports, int &r_amount, FeatureType &r_type) const override;
 	virtual bool intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal, int &r_face_index, bool p_hit_back_faces) const override;
@@ -34,8 +34,11 @@
 #include "godot_physics_server_3d.h"
 
 #include "core/config/project_settings.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/templates/flat_hash_map.h"
 
 #define TEST_MOTION_MARGIN_MIN_VALUE 0.0001
+#define RAY_BATCH_SIZE 32
 #define TEST_MOTION_MIN_CONTACT_DEPTH_FACTOR 0.05
 
 _FORCE_INLINE_ static bool _can_collide_with(GodotCollisionObject3D *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
@@ -108,14 +111,110 @@ int GodotPhysicsDirectSpaceState3D::intersect_point(const PointParameters &p_par
 bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parameters, RayResult &r_result) {
 	ERR_FAIL_COND_V(space->locked, false);
 
+	return _intersect_ray(p_parameters, p_parameters.from, p_parameters.to, space->intersection_query_results, space->intersection_query_subindex_results, r_result);
+}
+
+int GodotPhysicsDirectSpaceState3D::intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits) {
+	ERR_FAIL_COND_V(space->locked, 0);
+	if (p_ray_count <= 0) {
+		return 0;
+	}
+
+	RayBatch batch;
+	batch.parameters = &p_parameters;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.ray_count = p_ray_count;
+	batch.results = r_results;
+	batch.hits = r_hits;
+
+	uint32_t batch_count = (p_ray_count + RAY_BATCH_SIZE - 1) / RAY_BATCH_SIZE;
+	if (batch_count > 1) {
+		WorkerThreadPool::GroupID group_task = WorkerThreadPool::get_singleton()->add_template_group_task(this, &GodotPhysicsDirectSpaceState3D::_intersect_ray_batch, &batch, batch_count, -1, true, SNAME("Physics3DIntersectRays"));
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group_task);
+	} else {
+		_intersect_ray_batch(0, &batch);
+	}
+
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		if (r_hits[i]) {
+			hit_count++;
+		}
+	}
+	return hit_count;
+}
+
+void GodotPhysicsDirectSpaceState3D::_intersect_ray_batch(uint32_t p_batch_index, RayBatch *p_batch) {
+	// Each batch uses its own cull buffers, as the ones in the space are shared.
+	GodotCollisionObject3D *cull_results[GodotSpace3D::INTERSECTION_QUERY_MAX];
+	int cull_subindices[GodotSpace3D::INTERSECTION_QUERY_MAX];
+
+	int from = p_batch_index * RAY_BATCH_SIZE;
+	int to = MIN(from + RAY_BATCH_SIZE, p_batch->ray_count);
+
+	// Cull the broadphase once for the whole batch, then test each ray against the
+	// shape AABBs of the candidates before running the narrow phase.
+	AABB batch_aabb(p_batch->from[from], Vector3());
+	for (int i = from; i < to; i++) {
+		batch_aabb.expand_to(p_batch->from[i]);
+		batch_aabb.expand_to(p_batch->to[i]);
+	}
+	// Rays lying on a face of the batch AABB must still find what they touch.
+	batch_aabb.grow_by(CMP_EPSILON);
+
+	int amount = space->broadphase->cull_aabb(batch_aabb, cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, cull_subindices);
+	if (amount >= GodotSpace3D::INTERSECTION_QUERY_MAX) {
+		// Too many candidates, some may have been dropped. Cull each ray on its own instead.
+		for (int i = from; i < to; i++) {
+			p_batch->hits[i] = _intersect_ray(*p_batch->parameters, p_batch->from[i], p_batch->to[i], cull_results, cull_subindices, p_batch->results[i]);
+		}
+		return;
+	}
+
+	amount = _filter_ray_candidates(*p_batch->parameters, cull_results, cull_subindices, amount);
+
+	for (int i = from; i < to; i++) {
+		p_batch->hits[i] = _intersect_ray_candidates(*p_batch->parameters, p_batch->from[i], p_batch->to[i], cull_results, cull_subindices, amount, true, p_batch->results[i]);
+	}
+}
+
+int GodotPhysicsDirectSpaceState3D::_filter_ray_candidates(const RayParameters &p_parameters, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, int p_amount) {
+	int count = 0;
+	for (int i = 0; i < p_amount; i++) {
+		if (!_can_collide_with(r_cull_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
+			continue;
+		}
+
+		if (p_parameters.pick_ray && !(r_cull_results[i]->is_ray_pickable())) {
+			continue;
+		}
+
+		if (p_parameters.exclude.has(r_cull_results[i]->get_self())) {
+			continue;
+		}
+
+		r_cull_results[count] = r_cull_results[i];
+		r_cull_subindices[count] = r_cull_subindices[i];
+		count++;
+	}
+	return count;
+}
+
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, RayResult &r_result) {
+	int amount = space->broadphase->cull_segment(p_from, p_to, r_cull_results, GodotSpace3D::INTERSECTION_QUERY_MAX, r_cull_subindices);
+	amount = _filter_ray_candidates(p_parameters, r_cull_results, r_cull_subindices, amount);
+
+	return _intersect_ray_candidates(p_parameters, p_from, p_to, r_cull_results, r_cull_subindices, amount, false, r_result);
+}
+
+bool GodotPhysicsDirectSpaceState3D::_intersect_ray_candidates(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_amount, bool p_check_aabb, RayResult &r_result) {
 	Vector3 begin, end;
 	Vector3 normal;
-	begin = p_parameters.from;
-	end = p_parameters.to;
+	begin = p_from;
+	end = p_to;
 	normal = (end - begin).normalized();
 
-	int amount = space->broadphase->cull_segment(begin, end, space->intersection_query_results, GodotSpace3D::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
-
 	//todo, create another array that references results, compute AABBs and check closest point to ray origin, sort, and stop evaluating results when beyond first collision
 
 	bool collided = false;
@@ -125,22 +224,15 @@ bool GodotPhysicsDirectSpaceState3D::intersect_ray(const RayParameters &p_parame
 	const GodotCollisionObject3D *res_obj = nullptr;
 	real_t min_d = 1e10;
 
-	for (int i = 0; i < amount; i++) {
-		if (!_can_collide_with(space->intersection_query_results[i], p_parameters.collision_mask, p_parameters.collide_with_bodies, p_parameters.collide_with_areas)) {
-			continue;
-		}
+	for (int i = 0; i < p_amount; i++) {
+		const GodotCollisionObject3D *col_obj = p_cull_results[i];
 
-		if (p_parameters.pick_ray && !(space->intersection_query_results[i]->is_ray_pickable())) {
-			continue;
-		}
+		int shape_idx = p_cull_subindices[i];
 
-		if (p_parameters.exclude.has(space->intersection_query_results[i]->get_self())) {
+		if (p_check_aabb && !col_obj->get_shape_aabb(shape_idx).intersects_segment(begin, end)) {
 			continue;
 		}
 
-		const GodotCollisionObject3D *col_obj = space->intersection_query_results[i];
-
-		int shape_idx = space->intersection_query_subindex_results[i];
 		Transform3D inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
 
 		Vector3 local_from = inv_xform.xform(begin);
@@ -1174,6 +1266,280 @@ void GodotSpace3D::call_queries() {
 	}
 }
 
+// Space states are only meant to be restored by the same build, so values are stored with their native layout.
+#define SPACE_STATE_MAGIC 0x33535047 // "GPS3"
+#define SPACE_STATE_VERSION 2
+#define SPACE_STATE_HEADER_SIZE (sizeof(uint32_t) * 6)
+#define SPACE_STATE_BODY_SIZE (sizeof(uint64_t) + sizeof(Transform3D) * 2 + sizeof(Vector3) * 4 + sizeof(real_t) + sizeof(uint8_t))
+#define SPACE_STATE_ACTIVE_BODY_SIZE sizeof(uint64_t)
+#define SPACE_STATE_PAIR_SIZE (sizeof(uint64_t) * 2 + sizeof(int32_t) * 2 + sizeof(uint32_t))
+#define SPACE_STATE_CONTACT_SIZE (sizeof(Vector3) * 4 + sizeof(int32_t) * 2 + sizeof(real_t) * 3)
+
+struct _SpaceStateWriter3D {
+	uint8_t *ptr = nullptr;
+
+	template <class T>
+	_FORCE_INLINE_ void write(const T &p_value) {
+		memcpy(ptr, &p_value, sizeof(T));
+		ptr += sizeof(T);
+	}
+};
+
+struct _SpaceStateReader3D {
+	const uint8_t *ptr = nullptr;
+	const uint8_t *end = nullptr;
+
+	template <class T>
+	_FORCE_INLINE_ bool read(T &r_value) {
+		if (ptr + sizeof(T) > end) {
+			return false;
+		}
+		memcpy(&r_value, ptr, sizeof(T));
+		ptr += sizeof(T);
+		return true;
+	}
+
+	_FORCE_INLINE_ bool skip(uint64_t p_size) {
+		if ((uint64_t)(end - ptr) < p_size) {
+			return false;
+		}
+		ptr += p_size;
+		return true;
+	}
+};
+
+struct _SpaceStatePairKey3D {
+	uint64_t body_A = 0;
+	uint64_t body_B = 0;
+	int32_t shape_A = 0;
+	int32_t shape_B = 0;
+
+	bool operator==(const _SpaceStatePairKey3D &p_key) const {
+		return body_A == p_key.body_A && body_B == p_key.body_B && shape_A == p_key.shape_A && shape_B == p_key.shape_B;
+	}
+
+	static uint32_t hash(const _SpaceStatePairKey3D &p_key) {
+		uint32_t h = hash_murmur3_one_64(p_key.body_A);
+		h = hash_murmur3_one_64(p_key.body_B, h);
+		h = hash_murmur3_one_32(p_key.shape_A, h);
+		h = hash_murmur3_one_32(p_key.shape_B, h);
+		return hash_fmix32(h);
+	}
+};
+
+PackedByteArray GodotSpace3D::save_state() const {
+	uint32_t body_count = 0;
+	for (const GodotCollisionObject3D *E : objects) {
+		if (E->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			body_count++;
+		}
+	}
+
+	uint32_t active_body_count = 0;
+	for (const SelfList<GodotBody3D> *E = active_list.first(); E; E = E->next()) {
+		active_body_count++;
+	}
+
+	uint32_t pair_count = 0;
+	uint32_t contact_count = 0;
+	for (const SelfList<GodotBodyPair3D> *E = body_pair_list.first(); E; E = E->next()) {
+		pair_count++;
+		contact_count += E->self()->get_contact_count();
+	}
+
+	PackedByteArray state;
+	state.resize(SPACE_STATE_HEADER_SIZE + body_count * SPACE_STATE_BODY_SIZE + active_body_count * SPACE_STATE_ACTIVE_BODY_SIZE + pair_count * SPACE_STATE_PAIR_SIZE + contact_count * SPACE_STATE_CONTACT_SIZE);
+
+	_SpaceStateWriter3D w;
+	w.ptr = state.ptrw();
+
+	w.write<uint32_t>(SPACE_STATE_MAGIC);
+	w.write<uint32_t>(SPACE_STATE_VERSION);
+	w.write<uint32_t>(sizeof(real_t));
+	w.write<uint32_t>(body_count);
+	w.write<uint32_t>(active_body_count);
+	w.write<uint32_t>(pair_count);
+
+	GodotBody3D::SimulationState body_state;
+	for (const GodotCollisionObject3D *E : objects) {
+		if (E->get_type() != GodotCollisionObject3D::TYPE_BODY) {
+			continue;
+		}
+		const GodotBody3D *body = static_cast<const GodotBody3D *>(E);
+		body->get_simulation_state(body_state);
+
+		w.write<uint64_t>(body->get_self().get_id());
+		w.write(body_state.transform);
+		w.write(body_state.new_transform);
+		w.write(body_state.linear_velocity);
+		w.write(body_state.angular_velocity);
+		w.write(body_state.prev_linear_velocity);
+		w.write(body_state.prev_angular_velocity);
+		w.write(body_state.still_time);
+		w.write<uint8_t>(body_state.active ? 1 : 0);
+	}
+
+	// The order of the active list decides the order bodies are solved in, so it's needed to replay steps exactly.
+	for (const SelfList<GodotBody3D> *E = active_list.first(); E; E = E->next()) {
+		w.write<uint64_t>(E->self()->get_self().get_id());
+	}
+
+	GodotBodyPair3D::ContactCache contacts[GodotBodyPair3D::MAX_CONTACTS];
+	for (const SelfList<GodotBodyPair3D> *E = body_pair_list.first(); E; E = E->next()) {
+		const GodotBodyPair3D *pair = E->self();
+		int pair_contact_count = pair->get_contact_cache(contacts);
+
+		w.write<uint64_t>(pair->get_body_A()->get_self().get_id());
+		w.write<uint64_t>(pair->get_body_B()->get_self().get_id());
+		w.write<int32_t>(pair->get_shape_A());
+		w.write<int32_t>(pair->get_shape_B());
+		w.write<uint32_t>(pair_contact_count);
+
+		for (int i = 0; i < pair_contact_count; i++) {
+			const GodotBodyPair3D::ContactCache &c = contacts[i];
+			w.write(c.local_A);
+			w.write(c.local_B);
+			w.write(c.normal);
+			w.write<int32_t>(c.index_A);
+			w.write<int32_t>(c.index_B);
+			w.write(c.acc_normal_impulse);
+			w.write(c.acc_tangent_impulse);
+			w.write(c.acc_bias_impulse);
+			w.write(c.acc_bias_impulse_center_of_mass);
+		}
+	}
+
+	DEV_ASSERT(w.ptr == state.ptr() + state.size());
+
+	return state;
+}
+
+bool GodotSpace3D::restore_state(const PackedByteArray &p_state) {
+	ERR_FAIL_COND_V_MSG(locked, false, "Space state can't be restored while the space is being stepped.");
+
+	_SpaceStateReader3D r;
+	r.ptr = p_state.ptr();
+	r.end = r.ptr + p_state.size();
+
+	uint32_t magic = 0;
+	uint32_t version = 0;
+	uint32_t real_size = 0;
+	uint32_t body_count = 0;
+	uint32_t active_body_count = 0;
+	uint32_t pair_count = 0;
+	ERR_FAIL_COND_V_MSG(!r.read(magic) || magic != SPACE_STATE_MAGIC, false, "Invalid space state.");
+	ERR_FAIL_COND_V_MSG(!r.read(version) || version != SPACE_STATE_VERSION, false, "Unsupported space state version.");
+	ERR_FAIL_COND_V_MSG(!r.read(real_size) || real_size != sizeof(real_t), false, "Space state was saved with a different floating-point precision.");
+	ERR_FAIL_COND_V_MSG(!r.read(body_count) || !r.read(active_body_count) || !r.read(pair_count), false, "Space state is truncated.");
+
+	// Check the whole state before applying anything, so a rejected state leaves the space untouched.
+	{
+		_SpaceStateReader3D v = r;
+		ERR_FAIL_COND_V_MSG(!v.skip((uint64_t)body_count * SPACE_STATE_BODY_SIZE + (uint64_t)active_body_count * SPACE_STATE_ACTIVE_BODY_SIZE), false, "Space state is truncated.");
+		for (uint32_t i = 0; i < pair_count; i++) {
+			uint32_t pair_contact_count = 0;
+			ERR_FAIL_COND_V_MSG(!v.skip(SPACE_STATE_PAIR_SIZE - sizeof(uint32_t)) || !v.read(pair_contact_count), false, "Space state is truncated.");
+			ERR_FAIL_COND_V_MSG(pair_contact_count > GodotBodyPair3D::MAX_CONTACTS, false, "Invalid space state.");
+			ERR_FAIL_COND_V_MSG(!v.skip((uint64_t)pair_contact_count * SPACE_STATE_CONTACT_SIZE), false, "Space state is truncated.");
+		}
+		ERR_FAIL_COND_V_MSG(v.ptr != v.end, false, "Invalid space state.");
+	}
+
+	FlatHashMap<uint64_t, GodotBody3D *> bodies;
+	for (GodotCollisionObject3D *E : objects) {
+		if (E->get_type() == GodotCollisionObject3D::TYPE_BODY) {
+			bodies.insert(E->get_self().get_id(), static_cast<GodotBody3D *>(E));
+		}
+	}
+
+	// Bodies that were freed or moved to another space since the state was saved are skipped.
+	GodotBody3D::SimulationState body_state;
+	for (uint32_t i = 0; i < body_count; i++) {
+		uint64_t id = 0;
+		uint8_t active = 0;
+		r.read(id);
+		r.read(body_state.transform);
+		r.read(body_state.new_transform);
+		r.read(body_state.linear_velocity);
+		r.read(body_state.angular_velocity);
+		r.read(body_state.prev_linear_velocity);
+		r.read(body_state.prev_angular_velocity);
+		r.read(body_state.still_time);
+		r.read(active);
+		body_state.active = active != 0;
+
+		GodotBody3D **body = bodies.getptr(id);
+		if (body) {
+			(*body)->set_simulation_state(body_state);
+		}
+	}
+
+	// Waking bodies up and putting them to sleep reorders the active list, so put it back in the saved order.
+	// Bodies added since the state was saved stay at the front.
+	for (uint32_t i = 0; i < active_body_count; i++) {
+		uint64_t id = 0;
+		r.read(id);
+
+		GodotBody3D **body = bodies.getptr(id);
+		if (body && (*body)->get_active_list_element()->in_list()) {
+			active_list.remove((*body)->get_active_list_element());
+			active_list.add_last((*body)->get_active_list_element());
+		}
+	}
+
+	// Update the pairs to match the restored transforms before restoring their contacts.
+	broadphase->update();
+
+	FlatHashMap<_SpaceStatePairKey3D, GodotBodyPair3D *, _SpaceStatePairKey3D> pairs;
+	for (SelfList<GodotBodyPair3D> *E = body_pair_list.first(); E; E = E->next()) {
+		GodotBodyPair3D *pair = E->self();
+		pair->set_contact_cache(nullptr, 0);
+
+		_SpaceStatePairKey3D key;
+		key.body_A = pair->get_body_A()->get_self().get_id();
+		key.body_B = pair->get_body_B()->get_self().get_id();
+		key.shape_A = pair->get_shape_A();
+		key.shape_B = pair->get_shape_B();
+		pairs.insert(key, pair);
+	}
+
+	GodotBodyPair3D::ContactCache contacts[GodotBodyPair3D::MAX_CONTACTS];
+	for (uint32_t i = 0; i < pair_count; i++) {
+		_SpaceStatePairKey3D key;
+		uint32_t pair_contact_count = 0;
+		r.read(key.body_A);
+		r.read(key.body_B);
+		r.read(key.shape_A);
+		r.read(key.shape_B);
+		r.read(pair_contact_count);
+
+		for (uint32_t j = 0; j < pair_contact_count; j++) {
+			GodotBodyPair3D::ContactCache &c = contacts[j];
+			int32_t index_A = 0;
+			int32_t index_B = 0;
+			r.read(c.local_A);
+			r.read(c.local_B);
+			r.read(c.normal);
+			r.read(index_A);
+			r.read(index_B);
+			r.read(c.acc_normal_impulse);
+			r.read(c.acc_tangent_impulse);
+			r.read(c.acc_bias_impulse);
+			r.read(c.acc_bias_impulse_center_of_mass);
+			c.index_A = index_A;
+			c.index_B = index_B;
+		}
+
+		// Pairs that don't exist anymore lose their warm-start data.
+		GodotBodyPair3D **pair = pairs.getptr(key);
+		if (pair) {
+			(*pair)->set_contact_cache(contacts, pair_contact_count);
+		}
+	}
+
+	return true;
+}
+
 void GodotSpace3D::setup() {
 	contact_debug_count = 0;
 	while (mass_properties_update_list.first()) {
@@ -46,11 +46,26 @@
 class GodotPhysicsDirectSpaceState3D : public PhysicsDirectSpaceState3D {
 	GDCLASS(GodotPhysicsDirectSpaceState3D, PhysicsDirectSpaceState3D);
 
+	struct RayBatch {
+		const RayParameters *parameters = nullptr;
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		int ray_count = 0;
+		RayResult *results = nullptr;
+		bool *hits = nullptr;
+	};
+
+	int _filter_ray_candidates(const RayParameters &p_parameters, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, int p_amount);
+	bool _intersect_ray(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D **r_cull_results, int *r_cull_subindices, RayResult &r_result);
+	bool _intersect_ray_candidates(const RayParameters &p_parameters, const Vector3 &p_from, const Vector3 &p_to, GodotCollisionObject3D *const *p_cull_results, const int *p_cull_subindices, int p_amount, bool p_check_aabb, RayResult &r_result);
+	void _intersect_ray_batch(uint32_t p_batch_index, RayBatch *p_batch);
+
 public:
 	GodotSpace3D *space = nullptr;
 
 	virtual int intersect_point(const PointParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool intersect_ray(const RayParameters &p_parameters, RayResult &r_result) override;
+	virtual int intersect_rays(const RayParameters &p_parameters, const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits) override;
 	virtual int intersect_shape(const ShapeParameters &p_parameters, ShapeResult *r_results, int p_result_max) override;
 	virtual bool cast_motion(const ShapeParameters &p_parameters, real_t &p_closest_safe, real_t &p_closest_unsafe, ShapeRestInfo *r_info = nullptr) override;
 	virtual bool collide_shape(const ShapeParameters &p_parameters, Vector3 *r_results, int p_result_max, int &r_result_count) override;
@@ -85,6 +100,7 @@ private:
 	SelfList<GodotArea3D>::List monitor_query_list;
 	SelfList<GodotArea3D>::List area_moved_list;
 	SelfList<GodotSoftBody3D>::List active_soft_body_list;
+	SelfList<GodotBodyPair3D>::List body_pair_list;
 
 	static void *_broadphase_pair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_self);
 	static void _broadphase_unpair(GodotCollisionObject3D *A, int p_subindex_A, GodotCollisionObject3D *B, int p_subindex_B, void *p_data, void *p_self);
@@ -117,6 +133,7 @@ private:
 
 	int island_count = 0;
 	int active_objects = 0;
+	int sleeping_objects = 0;
 	int collision_pairs = 0;
 
 	RID static_global_body;
@@ -189,6 +206,16 @@ public:
 	void set_active_objects(int p_active_objects) { active_objects = p_active_objects; }
 	int get_active_objects() const { return active_objects; }
 
+	void add_body_pair(SelfList<GodotBodyPair3D> *p_pair) { body_pair_list.add(p_pair); }
+	void remove_body_pair(SelfList<GodotBodyPair3D> *p_pair) { body_pair_list.remove(p_pair); }
+
+	PackedByteArray save_state() const;
+	bool restore_state(const PackedByteArray &p_state);
+
+	void add_sleeping_object() { sleeping_objects++; }
+	void remove_sleeping_object() { sleeping_objects--; }
+	int get_sleeping_objects() const { return sleeping_objects; }
+
 	int get_collision_pairs() const { return collision_pairs; }
 
 	GodotPhysicsDirectSpaceState3D *get_direct_state();
@@ -128,6 +128,9 @@ public:
 		return physics_server_3d->space_get_contact_count(p_space);
 	}
 
+	FUNC1RC(PackedByteArray, space_save_state, RID);
+	FUNC2R(bool, space_restore_state, RID, const PackedByteArray &);
+
 	/* AREA API */
 
 	//FUNC0RID(area);
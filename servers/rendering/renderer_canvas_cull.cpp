@@ -32,6 +32,7 @@
 
 #include "core/config/project_settings.h"
 #include "core/math/geometry_2d.h"
+#include "core/templates/frame_arena.h"
 #include "renderer_viewport.h"
 #include "rendering_server_default.h"
 #include "rendering_server_globals.h"
@@ -321,8 +322,11 @@ void RendererCanvasCull::_cull_canvas_item(Item *p_canvas_item, const Transform2
 				_collect_ysort_children(ci, Transform2D(), p_material_owner, Color(1, 1, 1, 1), nullptr, ci->ysort_children_count, p_z);
 			}
 
+			// Y-sorted subtrees can be arbitrarily large, so use the frame arena rather than the stack.
+			FrameLocalVector<Item *> ysort_items;
 			child_item_count = ci->ysort_children_count + 1;
-			child_items = (Item **)alloca(child_item_count * sizeof(Item *));
+			ysort_items.resize(child_item_count);
+			child_items = ysort_items.ptr();
 
 			ci->ysort_xform = ci->xform.affine_inverse();
 			ci->ysort_pos = Vector2();
@@ -33,6 +33,7 @@
 #include "core/config/project_settings.h"
 #include "core/object/worker_thread_pool.h"
 #include "core/os/os.h"
+#include "core/templates/frame_arena.h"
 #include "rendering_light_culler.h"
 #include "rendering_server_default.h"
 
@@ -3083,7 +3084,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 	{
 		cull.shadow_count = 0;
 
-		Vector<Instance *> lights_with_shadow;
+		FrameLocalVector<Instance *> lights_with_shadow;
 
 		for (Instance *E : scenario->directional_lights) {
 			if (!E->visible) {
@@ -3109,7 +3110,7 @@ void RendererSceneCull::_render_scene(const RendererSceneRender::CameraData *p_c
 
 		RSG::light_storage->set_directional_shadow_count(lights_with_shadow.size());
 
-		for (int i = 0; i < lights_with_shadow.size(); i++) {
+		for (uint32_t i = 0; i < lights_with_shadow.size(); i++) {
 			_light_instance_setup_directional_shadow(i, lights_with_shadow[i], p_camera_data->main_transform, p_camera_data->main_projection, p_camera_data->is_orthogonal, p_camera_data->vaspect);
 		}
 	}
@@ -4121,8 +4122,9 @@ void RendererSceneCull::update() {
 	//optimize bvhs
 
 	uint32_t rid_count = scenario_owner.get_rid_count();
-	RID *rids = (RID *)alloca(sizeof(RID) * rid_count);
-	scenario_owner.fill_owned_buffer(rids);
+	FrameLocalVector<RID> rids;
+	rids.resize(rid_count);
+	scenario_owner.fill_owned_buffer(rids.ptr());
 	for (uint32_t i = 0; i < rid_count; i++) {
 		Scenario *s = scenario_owner.get_or_null(rids[i]);
 		s->indexers[Scenario::INDEXER_GEOMETRY].optimize_incremental(indexer_update_iterations);
@@ -153,11 +153,13 @@ void RenderingDevice::_add_dependency(RID p_id, RID p_depends_on) {
 void RenderingDevice::_free_dependencies(RID p_id) {
 	// Direct dependencies must be freed.
 
-	HashMap<RID, HashSet<RID>>::Iterator E = dependency_map.find(p_id);
+	FlatHashMap<RID, HashSet<RID>>::Iterator E = dependency_map.find(p_id);
+	while (E && E->value.size()) {
+		free(*E->value.begin());
+		// Freeing can add or remove entries, which may move this one in the table.
+		E = dependency_map.find(p_id);
+	}
 	if (E) {
-		while (E->value.size()) {
-			free(*E->value.begin());
-		}
 		dependency_map.remove(E);
 	}
 
@@ -166,7 +168,7 @@ void RenderingDevice::_free_dependencies(RID p_id) {
 
 	if (E) {
 		for (const RID &F : E->value) {
-			HashMap<RID, HashSet<RID>>::Iterator G = dependency_map.find(F);
+			FlatHashMap<RID, HashSet<RID>>::Iterator G = dependency_map.find(F);
 			ERR_CONTINUE(!G);
 			ERR_CONTINUE(!G->value.has(p_id));
 			G->value.erase(p_id);
@@ -4487,7 +4489,7 @@ bool RenderingDevice::_dependency_make_mutable(RID p_id, RID p_resource_id, RDG:
 
 bool RenderingDevice::_dependencies_make_mutable(RID p_id, RDG::ResourceTracker *p_resource_tracker) {
 	bool made_mutable = false;
-	HashMap<RID, HashSet<RID>>::Iterator E = dependency_map.find(p_id);
+	FlatHashMap<RID, HashSet<RID>>::Iterator E = dependency_map.find(p_id);
 	if (E) {
 		for (RID rid : E->value) {
 			made_mutable = _dependency_make_mutable(rid, p_id, p_resource_tracker) || made_mutable;
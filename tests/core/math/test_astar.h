@@ -32,6 +32,9 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
+#include "core/object/worker_thread_pool.h"
+#include "core/variant/typed_array.h"
 
 #include "tests/test_macros.h"
 
@@ -213,6 +216,43 @@ TEST_CASE("[AStar3D] Add/Remove") {
 	// It's been great work, cheers. \(^ ^)/
 }
 
+struct ConcurrentQueries {
+	AStar3D *astar = nullptr;
+	SafeNumeric<uint32_t> valid_paths;
+
+	void query(uint32_t p_index, void *p_userdata) {
+		// Walk the ring clockwise or counterclockwise depending on the query.
+		const int64_t to_id = p_index % 2 == 0 ? 10 : 30;
+		const Vector<int64_t> path = astar->get_id_path(0, to_id);
+		if (path.size() == 11 && path[0] == 0 && path[10] == to_id) {
+			valid_paths.increment();
+		}
+	}
+};
+
+TEST_CASE("[AStar3D] Concurrent queries") {
+	AStar3D a;
+	for (int i = 0; i < 40; i++) {
+		a.add_point(i, Vector3(Math::cos(i * Math_TAU / 40), Math::sin(i * Math_TAU / 40), 0));
+	}
+	for (int i = 0; i < 40; i++) {
+		a.connect_points(i, (i + 1) % 40);
+	}
+
+	ConcurrentQueries queries;
+	queries.astar = &a;
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&queries, &ConcurrentQueries::query, nullptr, 256, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_EQ(queries.valid_paths.get(), 256u);
+
+	// Point slots freed by removals are reused by new points.
+	a.remove_point(20);
+	a.add_point(20, Vector3(-1, 0, 0));
+	a.connect_points(19, 20);
+	a.connect_points(20, 21);
+	CHECK_EQ(a.get_id_path(15, 25).size(), 11);
+}
+
 TEST_CASE("[Stress][AStar3D] Find paths") {
 	// Random stress tests with Floyd-Warshall.
 	const int N = 30;
@@ -357,6 +397,83 @@ TEST_CASE("[Stress][AStar3D] Find paths") {
 		CHECK_MESSAGE(match, "Found all paths.");
 	}
 }
+
+TEST_CASE("[AStarGrid2D] Solid regions and jumping") {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 100, 5));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->update();
+
+	// A wall across the row words, with a single gap at the bottom.
+	grid->fill_solid_region(Rect2i(60, 0, 10, 4));
+	CHECK_FALSE(grid->is_point_solid(Vector2i(59, 0)));
+	CHECK(grid->is_point_solid(Vector2i(63, 3)));
+	CHECK(grid->is_point_solid(Vector2i(64, 0)));
+	CHECK(grid->is_point_solid(Vector2i(69, 2)));
+	CHECK_FALSE(grid->is_point_solid(Vector2i(70, 0)));
+	CHECK_FALSE(grid->is_point_solid(Vector2i(64, 4)));
+
+	for (bool jumping_enabled : { false, true }) {
+		grid->set_jumping_enabled(jumping_enabled);
+		TypedArray<Vector2i> path = grid->get_id_path(Vector2i(0, 0), Vector2i(99, 0));
+		REQUIRE_FALSE(path.is_empty());
+		CHECK_EQ(Vector2i(path.front()), Vector2i(0, 0));
+		CHECK_EQ(Vector2i(path.back()), Vector2i(99, 0));
+		bool passes_gap = false;
+		for (int i = 0; i < path.size(); i++) {
+			const Vector2i id = path[i];
+			CHECK_FALSE(grid->is_point_solid(id));
+			passes_gap = passes_gap || id.y == 4;
+		}
+		CHECK(passes_gap);
+	}
+
+	grid->set_point_solid(Vector2i(65, 4));
+	CHECK(grid->get_id_path(Vector2i(0, 0), Vector2i(99, 0)).is_empty());
+
+	grid->fill_solid_region(Rect2i(60, 0, 10, 5), false);
+	CHECK_FALSE(grid->is_point_solid(Vector2i(65, 4)));
+	CHECK_FALSE(grid->get_id_path(Vector2i(0, 0), Vector2i(99, 0)).is_empty());
+}
+
+struct ConcurrentGridQueries {
+	AStarGrid2D *grid = nullptr;
+	TypedArray<Vector2i> expected_paths[2];
+	SafeNumeric<uint32_t> valid_paths;
+
+	void query(uint32_t p_index, void *p_userdata) {
+		// Cross the grid forward or backward depending on the query.
+		const TypedArray<Vector2i> path = p_index % 2 == 0 ? grid->get_id_path(Vector2i(0, 0), Vector2i(99, 0)) : grid->get_id_path(Vector2i(99, 0), Vector2i(0, 0));
+		if (path == expected_paths[p_index % 2]) {
+			valid_paths.increment();
+		}
+	}
+};
+
+TEST_CASE("[AStarGrid2D] Concurrent queries") {
+	Ref<AStarGrid2D> grid;
+	grid.instantiate();
+	grid->set_region(Rect2i(0, 0, 100, 5));
+	grid->set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid->update();
+	grid->fill_solid_region(Rect2i(60, 0, 10, 4));
+
+	for (bool jumping_enabled : { false, true }) {
+		grid->set_jumping_enabled(jumping_enabled);
+
+		ConcurrentGridQueries queries;
+		queries.grid = grid.ptr();
+		queries.expected_paths[0] = grid->get_id_path(Vector2i(0, 0), Vector2i(99, 0));
+		queries.expected_paths[1] = grid->get_id_path(Vector2i(99, 0), Vector2i(0, 0));
+		REQUIRE_FALSE(queries.expected_paths[0].is_empty());
+		REQUIRE_FALSE(queries.expected_paths[1].is_empty());
+
+		WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&queries, &ConcurrentGridQueries::query, nullptr, 256, -1, true);
+		WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+		CHECK_EQ(queries.valid_paths.get(), 256u);
+	}
+}
 } // namespace TestAStar
 
 #endif // TEST_ASTAR_H
@@ -0,0 +1,166 @@
+/**************************************************************************/
+/*  test_bvh.h                                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#ifndef TEST_BVH_H
+#define TEST_BVH_H
+
+#include "core/math/bvh.h"
+#include "core/math/random_pcg.h"
+#include "core/math/rect2.h"
+#include "core/object/worker_thread_pool.h"
+
+#include "tests/test_macros.h"
+
+namespace TestBVH {
+
+struct PairObject {
+	uint32_t index = 0;
+	uint32_t layer = 1;
+	uint32_t mask = 1;
+};
+
+template <class T>
+class PairObjectTestFunction {
+public:
+	static bool user_pair_check(const T *p_a, const T *p_b) {
+		return (p_a->layer & p_b->mask) || (p_b->layer & p_a->mask);
+	}
+};
+
+template <class T>
+class PairObjectCullTestFunction {
+public:
+	static bool user_cull_check(const T *p_a, const T *p_b) {
+		return true;
+	}
+};
+
+// Set up like the 2D physics broadphase: static items only pair with dynamic ones.
+typedef BVH_Manager<PairObject, 2, true, 128, PairObjectTestFunction<PairObject>, PairObjectCullTestFunction<PairObject>, Rect2, Vector2> PairBVH;
+
+enum {
+	TREE_STATIC = 0,
+	TREE_DYNAMIC = 1,
+	TREE_FLAG_STATIC = 1 << TREE_STATIC,
+	TREE_FLAG_DYNAMIC = 1 << TREE_DYNAMIC,
+};
+
+// Each callback is recorded as its kind followed by the indices of both objects.
+static void *pair_callback(void *p_self, uint32_t, PairObject *p_object_a, int, uint32_t, PairObject *p_object_b, int) {
+	Vector<int64_t> *events = static_cast<Vector<int64_t> *>(p_self);
+	events->push_back(1);
+	events->push_back(p_object_a->index);
+	events->push_back(p_object_b->index);
+	return nullptr;
+}
+
+static void unpair_callback(void *p_self, uint32_t, PairObject *p_object_a, int, uint32_t, PairObject *p_object_b, int, void *) {
+	Vector<int64_t> *events = static_cast<Vector<int64_t> *>(p_self);
+	events->push_back(0);
+	events->push_back(p_object_a->index);
+	events->push_back(p_object_b->index);
+}
+
+// Moves a few hundred boxes around for a number of steps and returns every pair and unpair callback, in order.
+static Vector<int64_t> run_pair_check(bool p_parallel_pair_check) {
+	const uint32_t object_count = 600;
+	const int steps = 20;
+
+	Vector<int64_t> events;
+	LocalVector<PairObject> objects;
+	objects.resize(object_count);
+	LocalVector<BVHHandle> handles;
+	LocalVector<Rect2> rects;
+
+	PairBVH bvh;
+	bvh.params_set_parallel_pair_check(p_parallel_pair_check);
+	bvh.set_pair_callback(pair_callback, &events);
+	bvh.set_unpair_callback(unpair_callback, &events);
+
+	RandomPCG rng(1234);
+	for (uint32_t i = 0; i < object_count; i++) {
+		PairObject &object = objects[i];
+		object.index = i;
+		object.layer = 1 << rng.random(0, 2);
+		object.mask = 1 << rng.random(0, 2);
+
+		const bool is_static = i % 4 == 0;
+		const Rect2 rect(rng.random(0.0f, 100.0f), rng.random(0.0f, 100.0f), rng.random(1.0f, 4.0f), rng.random(1.0f, 4.0f));
+		const uint32_t tree_id = is_static ? TREE_STATIC : TREE_DYNAMIC;
+		const uint32_t tree_collision_mask = is_static ? TREE_FLAG_DYNAMIC : (TREE_FLAG_STATIC | TREE_FLAG_DYNAMIC);
+		handles.push_back(bvh.create(&object, true, tree_id, tree_collision_mask, rect));
+		rects.push_back(rect);
+	}
+	bvh.update();
+
+	for (int step = 0; step < steps; step++) {
+		for (uint32_t i = 0; i < object_count; i++) {
+			if (i % 4 == 0) {
+				continue;
+			}
+			rects[i].position += Vector2(rng.random(-2.0f, 2.0f), rng.random(-2.0f, 2.0f));
+			bvh.move(handles[i], rects[i]);
+		}
+		bvh.update();
+	}
+
+	for (const BVHHandle &handle : handles) {
+		bvh.erase(handle);
+	}
+
+	return events;
+}
+
+TEST_CASE("[BVH] Parallel pair checks send the same callbacks as serial ones") {
+	const Vector<int64_t> expected_events = run_pair_check(false);
+	// Enough pairs are made and broken for the comparison to mean something.
+	REQUIRE(expected_events.size() > 3000);
+
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const int thread_count = pool->get_thread_count();
+	const float low_priority_task_ratio = pool->get_low_priority_task_ratio();
+	const bool work_stealing = pool->is_work_stealing();
+
+	for (const int test_thread_count : { 1, 2, 4, 8 }) {
+		pool->finish();
+		pool->init(test_thread_count, low_priority_task_ratio, work_stealing);
+
+		CHECK_MESSAGE(run_pair_check(true) == expected_events, vformat("Parallel pair check with %d threads.", test_thread_count));
+		CHECK_MESSAGE(run_pair_check(false) == expected_events, vformat("Serial pair check with %d threads.", test_thread_count));
+	}
+
+	pool->finish();
+	pool->init(thread_count, low_priority_task_ratio, work_stealing);
+}
+
+} // namespace TestBVH
+
+#endif // TEST_BVH_H
@@ -35,6 +35,8 @@
 #include "core/object/class_db.h"
 #include "core/object/object.h"
 #include "core/object/script_language.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
 
 #include "tests/test_macros.h"
 
@@ -58,6 +60,38 @@ public:
 	int get_property() const { return property_value; }
 };
 
+class _TestSignalReceiver : public Object {
+	GDCLASS(_TestSignalReceiver, Object);
+
+protected:
+	static void _bind_methods() {
+		ClassDB::bind_method(D_METHOD("receive"), &_TestSignalReceiver::receive);
+		ClassDB::bind_method(D_METHOD("receive_value", "value"), &_TestSignalReceiver::receive_value);
+		ClassDB::bind_method(D_METHOD("receive_and_free"), &_TestSignalReceiver::receive_and_free);
+		ClassDB::bind_method(D_METHOD("receive_concurrently"), &_TestSignalReceiver::receive_concurrently);
+	}
+
+public:
+	int received = 0;
+	int value_sum = 0;
+	Object *to_free = nullptr;
+	SafeNumeric<uint32_t> received_concurrently;
+
+	void receive() { received++; }
+	void receive_concurrently() { received_concurrently.increment(); }
+	void receive_value(int p_value) {
+		received++;
+		value_sum += p_value;
+	}
+	void receive_and_free() {
+		received++;
+		if (to_free) {
+			memdelete(to_free);
+			to_free = nullptr;
+		}
+	}
+};
+
 namespace TestObject {
 
 class _MockScriptInstance : public ScriptInstance {
@@ -432,6 +466,170 @@ TEST_CASE("[Object] Signals") {
 	}
 }
 
+TEST_CASE("[Object] Signal emission") {
+	GDREGISTER_CLASS(_TestSignalReceiver);
+
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("my_signal"));
+	emitter.add_user_signal(MethodInfo("value_signal", PropertyInfo(Variant::INT, "value")));
+
+	SUBCASE("Native targets receive every emission, including after reconnecting") {
+		_TestSignalReceiver receiver;
+		emitter.connect("value_signal", Callable(&receiver, "receive_value"));
+		for (int i = 0; i < 10; i++) {
+			CHECK_EQ(emitter.emit_signal("value_signal", i), OK);
+		}
+		CHECK_EQ(receiver.received, 10);
+		CHECK_EQ(receiver.value_sum, 45);
+
+		emitter.disconnect("value_signal", Callable(&receiver, "receive_value"));
+		emitter.emit_signal("value_signal", 100);
+		CHECK_EQ(receiver.received, 10);
+
+		emitter.connect("value_signal", Callable(&receiver, "receive_value"));
+		emitter.connect("value_signal", callable_mp(&receiver, &_TestSignalReceiver::receive_value));
+		emitter.emit_signal("value_signal", 1);
+		CHECK_EQ(receiver.received, 12);
+		CHECK_EQ(receiver.value_sum, 47);
+	}
+
+	SUBCASE("Bound arguments are passed to native targets") {
+		_TestSignalReceiver receiver;
+		emitter.connect("my_signal", Callable(&receiver, "receive_value").bind(7));
+		emitter.emit_signal("my_signal");
+		emitter.emit_signal("my_signal");
+		CHECK_EQ(receiver.received, 2);
+		CHECK_EQ(receiver.value_sum, 14);
+	}
+
+	SUBCASE("One-shot connections are only called once") {
+		_TestSignalReceiver receiver;
+		emitter.connect("my_signal", Callable(&receiver, "receive"), Object::CONNECT_ONE_SHOT);
+		emitter.emit_signal("my_signal");
+		emitter.emit_signal("my_signal");
+		CHECK_EQ(receiver.received, 1);
+		CHECK_FALSE(emitter.is_connected("my_signal", Callable(&receiver, "receive")));
+	}
+
+	SUBCASE("Targets freed during emission are skipped") {
+		_TestSignalReceiver first;
+		_TestSignalReceiver *second = memnew(_TestSignalReceiver);
+		first.to_free = second;
+		emitter.connect("my_signal", Callable(&first, "receive_and_free"));
+		emitter.connect("my_signal", Callable(second, "receive"));
+
+		CHECK_EQ(emitter.emit_signal("my_signal"), OK);
+		CHECK_EQ(first.received, 1);
+
+		List<Object::Connection> signal_connections;
+		emitter.get_all_signal_connections(&signal_connections);
+		CHECK_EQ(signal_connections.size(), 1);
+
+		emitter.emit_signal("my_signal");
+		CHECK_EQ(first.received, 2);
+	}
+
+	SUBCASE("Targets with a script instance are called through the script") {
+		_TestSignalReceiver receiver;
+		_MockScriptInstance *script_instance = memnew(_MockScriptInstance);
+		receiver.set_script_instance(script_instance);
+		emitter.connect("my_signal", Callable(&receiver, "receive"));
+
+		// The mock script accepts every call, so the native method must not be reached.
+		emitter.emit_signal("my_signal");
+		CHECK_EQ(receiver.received, 0);
+
+		receiver.set_script_instance(nullptr);
+		emitter.emit_signal("my_signal");
+		CHECK_EQ(receiver.received, 1);
+	}
+}
+
+struct _SignalEmissionThreadData {
+	Object *emitter = nullptr;
+	SafeFlag start;
+	int emissions = 0;
+};
+
+static void _emit_signal_repeatedly(void *p_data) {
+	_SignalEmissionThreadData *data = (_SignalEmissionThreadData *)p_data;
+	while (!data->start.is_set()) {
+		// Start all threads together, so they race to build the connection snapshot.
+	}
+	for (int i = 0; i < data->emissions; i++) {
+		data->emitter->emit_signal("my_signal");
+	}
+}
+
+TEST_CASE("[Object] Signal emission from multiple threads") {
+	GDREGISTER_CLASS(_TestSignalReceiver);
+
+	const int thread_count = 4;
+	const int emissions = 1000;
+
+	Object emitter;
+	emitter.add_user_signal(MethodInfo("my_signal"));
+	_TestSignalReceiver receivers[3];
+	uint32_t expected = 0;
+
+	for (int round = 0; round < 20; round++) {
+		// Changing the connections drops the snapshot, so every round builds it concurrently again.
+		const int connection_count = round % 3 + 1;
+		for (int i = 0; i < 3; i++) {
+			const Callable callable = Callable(&receivers[i], "receive_concurrently");
+			if (emitter.is_connected("my_signal", callable)) {
+				emitter.disconnect("my_signal", callable);
+			}
+			if (i < connection_count) {
+				emitter.connect("my_signal", callable);
+			}
+		}
+
+		_SignalEmissionThreadData data;
+		data.emitter = &emitter;
+		data.emissions = emissions;
+		Thread threads[thread_count];
+		for (Thread &thread : threads) {
+			thread.start(_emit_signal_repeatedly, &data);
+		}
+		data.start.set();
+		for (Thread &thread : threads) {
+			thread.wait_to_finish();
+		}
+
+		expected += connection_count * thread_count * emissions;
+		const uint32_t received = receivers[0].received_concurrently.get() + receivers[1].received_concurrently.get() + receivers[2].received_concurrently.get();
+		CHECK_EQ(received, expected);
+	}
+}
+
+TEST_CASE("[Stress][Object] Signal emission") {
+	GDREGISTER_CLASS(_TestSignalReceiver);
+
+	const int emissions = 100000;
+	const int connection_counts[] = { 0, 1, 10 };
+	for (const int connection_count : connection_counts) {
+		Object emitter;
+		emitter.add_user_signal(MethodInfo("my_signal"));
+		_TestSignalReceiver receivers[10];
+		for (int i = 0; i < connection_count; i++) {
+			emitter.connect("my_signal", Callable(&receivers[i], "receive"));
+		}
+
+		const StringName signal_name = "my_signal";
+		const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < emissions; i++) {
+			emitter.emit_signal(signal_name);
+		}
+		const uint64_t elapsed_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin_usec, (uint64_t)1);
+
+		for (int i = 0; i < connection_count; i++) {
+			CHECK_EQ(receivers[i].received, emissions);
+		}
+		print_verbose(vformat("Signal with %d connections: %d emissions in %d usec (%d emissions per second).", connection_count, emissions, elapsed_usec, emissions * (uint64_t)1000000 / elapsed_usec));
+	}
+}
+
 class NotificationObject1 : public Object {
 	GDCLASS(NotificationObject1, Object);
 
@@ -0,0 +1,269 @@
+/**************************************************************************/
+/*  test_size_class_allocator.h                                           */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_SIZE_CLASS_ALLOCATOR_H
+#define TEST_SIZE_CLASS_ALLOCATOR_H
+
+#include "core/os/memory.h"
+#include "core/os/size_class_allocator.h"
+#include "core/os/thread.h"
+#include "core/templates/local_vector.h"
+
+#include "tests/test_macros.h"
+
+namespace TestSizeClassAllocator {
+
+// The allocator is always built, so it is tested directly. Memory only routes to it with `size_class_allocator=yes`.
+
+static uint32_t find_size_class(size_t p_bytes) {
+	for (uint32_t i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		if (SizeClassAllocator::get_size_class_size(i) >= p_bytes) {
+			return i;
+		}
+	}
+	return SizeClassAllocator::SIZE_CLASS_COUNT;
+}
+
+TEST_CASE("[SizeClassAllocator] Size classes") {
+	size_t previous_size = 0;
+	for (uint32_t i = 0; i < SizeClassAllocator::SIZE_CLASS_COUNT; i++) {
+		const size_t size = SizeClassAllocator::get_size_class_size(i);
+		CHECK(size > previous_size);
+		CHECK(size % 16 == 0);
+		previous_size = size;
+	}
+	CHECK(previous_size == SizeClassAllocator::MAX_SIZE);
+}
+
+TEST_CASE("[SizeClassAllocator] Allocation and free") {
+	for (size_t bytes = 1; bytes <= SizeClassAllocator::MAX_SIZE; bytes += 7) {
+		const uint32_t size_class = find_size_class(bytes);
+		const uint64_t usage = SizeClassAllocator::get_size_class_usage(size_class);
+
+		uint8_t *block = (uint8_t *)SizeClassAllocator::alloc(bytes);
+		REQUIRE(block != nullptr);
+		CHECK(SizeClassAllocator::owns(block));
+		CHECK(SizeClassAllocator::owns(block + bytes - 1));
+		CHECK(SizeClassAllocator::get_block_size(block) == SizeClassAllocator::get_size_class_size(size_class));
+		CHECK_MESSAGE(((uintptr_t)block % 16) == 0, vformat("Blocks of %d bytes should be 16-byte aligned.", (int64_t)bytes));
+		CHECK(SizeClassAllocator::get_size_class_usage(size_class) == usage + SizeClassAllocator::get_block_size(block));
+
+		// The whole block is usable.
+		memset(block, 0xAB, SizeClassAllocator::get_block_size(block));
+
+		SizeClassAllocator::free(block);
+		CHECK(SizeClassAllocator::get_size_class_usage(size_class) == usage);
+
+		// The block that was just freed is the first one handed out again.
+		void *again = SizeClassAllocator::alloc(bytes);
+		CHECK(again == block);
+		SizeClassAllocator::free(again);
+	}
+}
+
+TEST_CASE("[SizeClassAllocator] Many blocks of the same size class") {
+	// More blocks than a thread keeps, and more than a span holds, so blocks go through the shared lists.
+	const int count = 5000;
+	LocalVector<uint8_t *> blocks;
+	blocks.resize(count);
+	for (int i = 0; i < count; i++) {
+		blocks[i] = (uint8_t *)SizeClassAllocator::alloc(48);
+		REQUIRE(blocks[i] != nullptr);
+		CHECK(((uintptr_t)blocks[i] % 16) == 0);
+		memset(blocks[i], i & 0xFF, 48);
+	}
+	CHECK(SizeClassAllocator::get_size_class_reserved(find_size_class(48)) >= count * 48);
+
+	bool intact = true;
+	for (int i = 0; i < count; i++) {
+		for (int j = 0; j < 48; j++) {
+			intact = intact && blocks[i][j] == (i & 0xFF);
+		}
+	}
+	CHECK_MESSAGE(intact, "Blocks should not overlap.");
+
+	for (int i = 0; i < count; i++) {
+		SizeClassAllocator::free(blocks[i]);
+	}
+}
+
+TEST_CASE("[SizeClassAllocator] Memory outside of the allocator") {
+	int on_stack = 0;
+	CHECK_FALSE(SizeClassAllocator::owns(&on_stack));
+
+	// Large allocations never reach the allocator.
+	void *large = Memory::alloc_static(SizeClassAllocator::MAX_SIZE + 1);
+	REQUIRE(large != nullptr);
+	CHECK_FALSE(SizeClassAllocator::owns(large));
+	CHECK(((uintptr_t)large % alignof(max_align_t)) == 0);
+	Memory::free_static(large);
+}
+
+TEST_CASE("[Memory] Reallocation within and across size classes") {
+	const size_t sizes[] = { 20, 30, 40, 200, SizeClassAllocator::MAX_SIZE, 2000, 100, 8 };
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+#ifdef DEBUG_ENABLED
+	// Debug builds pad every allocation, so blocks of the last size class go to the system allocator too.
+	const size_t padding = Memory::DATA_OFFSET;
+#else
+	const size_t padding = 0;
+#endif
+	bool in_size_classes = true;
+#endif
+
+	uint8_t *mem = (uint8_t *)Memory::alloc_static(10);
+	REQUIRE(mem != nullptr);
+	for (int i = 0; i < 10; i++) {
+		mem[i] = i;
+	}
+	size_t filled = 10;
+
+	for (const size_t size : sizes) {
+		mem = (uint8_t *)Memory::realloc_static(mem, size);
+		REQUIRE(mem != nullptr);
+		CHECK(((uintptr_t)mem % alignof(max_align_t)) == 0);
+
+		// What was written before is kept, up to the new size.
+		const size_t kept = MIN(filled, size);
+		bool intact = true;
+		for (size_t i = 0; i < kept; i++) {
+			intact = intact && mem[i] == uint8_t(i);
+		}
+		CHECK_MESSAGE(intact, vformat("Reallocating to %d bytes should keep the data.", (int64_t)size));
+
+		for (size_t i = 0; i < size; i++) {
+			mem[i] = uint8_t(i);
+		}
+		filled = size;
+
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+		// Once an allocation grew out of the size classes, the system allocator keeps it even when it shrinks.
+		in_size_classes = in_size_classes && size + padding <= SizeClassAllocator::MAX_SIZE;
+		CHECK(SizeClassAllocator::owns(mem) == in_size_classes);
+#endif
+	}
+
+#ifdef SIZE_CLASS_ALLOCATOR_ENABLED
+	// Growing within the block size doesn't move the allocation.
+	void *small = Memory::alloc_static(17);
+	void *grown = Memory::realloc_static(small, 20);
+	CHECK(grown == small);
+	Memory::free_static(grown);
+#endif
+
+	Memory::free_static(mem);
+}
+
+struct ThreadBlocks {
+	size_t bytes = 0;
+	int count = 0;
+	LocalVector<void *> blocks;
+	bool free_blocks = false;
+};
+
+static void alloc_blocks_thread(void *p_userdata) {
+	ThreadBlocks *data = static_cast<ThreadBlocks *>(p_userdata);
+	for (int i = 0; i < data->count; i++) {
+		data->blocks.push_back(SizeClassAllocator::alloc(data->bytes));
+	}
+	if (data->free_blocks) {
+		for (void *block : data->blocks) {
+			SizeClassAllocator::free(block);
+		}
+	}
+}
+
+TEST_CASE("[SizeClassAllocator] Blocks freed on another thread") {
+	ThreadBlocks data;
+	data.bytes = 100;
+	data.count = 1;
+	data.blocks.reserve(data.count);
+
+	Thread thread;
+	thread.start(alloc_blocks_thread, &data);
+	thread.wait_to_finish();
+
+	REQUIRE(data.blocks.size() == 1);
+	void *block = data.blocks[0];
+	REQUIRE(block != nullptr);
+	CHECK(SizeClassAllocator::owns(block));
+
+	const uint32_t size_class = find_size_class(data.bytes);
+	const uint64_t usage = SizeClassAllocator::get_size_class_usage(size_class);
+	SizeClassAllocator::free(block);
+	CHECK(SizeClassAllocator::get_size_class_usage(size_class) == usage - SizeClassAllocator::get_size_class_size(size_class));
+
+	// The block now belongs to this thread, which hands it out again.
+	LocalVector<void *> blocks;
+	for (int i = 0; i < 100; i++) {
+		blocks.push_back(SizeClassAllocator::alloc(data.bytes));
+	}
+	CHECK(blocks.find(block) != -1);
+	for (void *again : blocks) {
+		SizeClassAllocator::free(again);
+	}
+}
+
+TEST_CASE("[SizeClassAllocator] Thread caches are released when threads exit") {
+	// The first thread frees its blocks but keeps them cached until it exits.
+	ThreadBlocks first;
+	first.bytes = SizeClassAllocator::MAX_SIZE;
+	first.count = 32;
+	first.free_blocks = true;
+	first.blocks.reserve(first.count);
+
+	Thread first_thread;
+	first_thread.start(alloc_blocks_thread, &first);
+	first_thread.wait_to_finish();
+
+	// Another thread then gets the blocks the first one left behind.
+	ThreadBlocks second;
+	second.bytes = SizeClassAllocator::MAX_SIZE;
+	second.count = 32;
+	second.blocks.reserve(second.count);
+
+	Thread second_thread;
+	second_thread.start(alloc_blocks_thread, &second);
+	second_thread.wait_to_finish();
+
+	int reused = 0;
+	for (void *block : second.blocks) {
+		reused += first.blocks.find(block) != -1 ? 1 : 0;
+	}
+	CHECK_MESSAGE(reused > 0, "Blocks cached by a thread should be reused after it exits.");
+
+	for (void *block : second.blocks) {
+		SizeClassAllocator::free(block);
+	}
+}
+
+} // namespace TestSizeClassAllocator
+
+#endif // TEST_SIZE_CLASS_ALLOCATOR_H
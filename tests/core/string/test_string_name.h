@@ -0,0 +1,105 @@
+/**************************************************************************/
+/*  test_string_name.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_STRING_NAME_H
+#define TEST_STRING_NAME_H
+
+#include "core/object/worker_thread_pool.h"
+#include "core/os/os.h"
+#include "core/string/print_string.h"
+#include "core/string/string_name.h"
+
+#include "tests/test_macros.h"
+
+namespace TestStringName {
+
+TEST_CASE("[StringName] Interning") {
+	const StringName a = String("interned_name");
+	const StringName b = "interned_name";
+	const StringName c = StringName("other_interned_name");
+
+	CHECK_EQ(a, b);
+	CHECK_EQ(a.data_unique_pointer(), b.data_unique_pointer());
+	CHECK_NE(a, c);
+	CHECK_EQ(StringName::search(String("interned_name")), a);
+	CHECK_EQ(StringName::search("interned_name"), a);
+	CHECK_EQ(StringName::search(U"interned_name"), a);
+	CHECK_EQ(StringName::search("never_interned_name"), StringName());
+}
+
+struct ConcurrentInterning {
+	static const uint32_t NAME_COUNT = 256;
+
+	Vector<String> names;
+	LocalVector<StringName> reference_names;
+	SafeNumeric<uint32_t> mismatches;
+
+	void intern(uint32_t p_index, void *p_userdata) {
+		// Threads create, copy, look up and drop names that other threads are using at the same time.
+		const uint32_t name_index = p_index % NAME_COUNT;
+		const StringName name = names[name_index];
+		const StringName found = StringName::search(names[name_index]);
+		const StringName temporary = names[name_index] + "_" + itos(p_index % 7);
+		if (name != reference_names[name_index] || found != name || temporary == name) {
+			mismatches.increment();
+		}
+	}
+
+	ConcurrentInterning() {
+		for (uint32_t i = 0; i < NAME_COUNT; i++) {
+			names.push_back(vformat("concurrent_name_%d", i));
+			reference_names.push_back(names[i]);
+		}
+	}
+};
+
+TEST_CASE("[StringName] Concurrent interning") {
+	ConcurrentInterning interning;
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&interning, &ConcurrentInterning::intern, nullptr, 4096, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	CHECK_EQ(interning.mismatches.get(), 0u);
+}
+
+TEST_CASE("[Stress][StringName] Concurrent interning and lookup") {
+	ConcurrentInterning interning;
+	const uint32_t element_count = 1 << 20;
+
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	WorkerThreadPool::GroupID group = WorkerThreadPool::get_singleton()->add_template_group_task(&interning, &ConcurrentInterning::intern, nullptr, element_count, -1, true);
+	WorkerThreadPool::get_singleton()->wait_for_group_task_completion(group);
+	const uint64_t elapsed_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	CHECK_EQ(interning.mismatches.get(), 0u);
+	print_verbose(vformat("%d interning rounds on %d threads took %d usec.", element_count, WorkerThreadPool::get_singleton()->get_thread_count(), elapsed_usec));
+}
+
+} // namespace TestStringName
+
+#endif // TEST_STRING_NAME_H
@@ -0,0 +1,241 @@
+/**************************************************************************/
+/*  test_flat_hash_map.h                                                  */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/os/os.h"
+#include "core/string/print_string.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/oa_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Insert element") {
+	FlatHashMap<int, int> map;
+	FlatHashMap<int, int>::Iterator e = map.insert(42, 84);
+
+	CHECK(e);
+	CHECK(e->key == 42);
+	CHECK(e->value == 84);
+	CHECK(map[42] == 84);
+	CHECK(map.has(42));
+	CHECK(map.find(42));
+	CHECK(map.size() == 1);
+
+	map.insert(42, 21);
+	CHECK(map[42] == 21);
+	CHECK(map.size() == 1);
+}
+
+TEST_CASE("[FlatHashMap] Erase and reinsert") {
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.insert(i, i * 2);
+	}
+	CHECK(map.size() == 1000);
+
+	for (int i = 0; i < 1000; i += 2) {
+		CHECK(map.erase(i));
+	}
+	CHECK_FALSE(map.erase(0));
+	CHECK(map.size() == 500);
+
+	for (int i = 0; i < 1000; i++) {
+		CHECK(map.has(i) == (i % 2 == 1));
+	}
+
+	// Churn through deleted slots, the capacity shouldn't keep growing.
+	const uint32_t capacity = map.get_capacity();
+	for (int round = 0; round < 20; round++) {
+		for (int i = 0; i < 200; i++) {
+			map.insert(10000 + i, i);
+		}
+		for (int i = 0; i < 200; i++) {
+			map.erase(10000 + i);
+		}
+	}
+	CHECK(map.get_capacity() == capacity);
+	CHECK(map.size() == 500);
+	CHECK(map[999] == 1998);
+}
+
+TEST_CASE("[FlatHashMap] Iteration") {
+	FlatHashMap<int, int> map;
+	CHECK(map.begin() == map.end());
+
+	int expected_sum = 0;
+	for (int i = 0; i < 100; i++) {
+		map.insert(i, i);
+		expected_sum += i;
+	}
+
+	int sum = 0;
+	uint32_t count = 0;
+	for (const KeyValue<int, int> &E : map) {
+		CHECK(E.key == E.value);
+		sum += E.value;
+		count++;
+	}
+	CHECK(sum == expected_sum);
+	CHECK(count == map.size());
+
+	// Removing while iterating.
+	for (FlatHashMap<int, int>::Iterator E = map.begin(); E; ++E) {
+		if (E->key % 3 == 0) {
+			map.remove(E);
+		}
+	}
+	CHECK(map.size() == 66);
+	CHECK_FALSE(map.has(3));
+	CHECK(map.has(4));
+}
+
+TEST_CASE("[FlatHashMap] Non-trivial types, copying and clearing") {
+	FlatHashMap<String, String> map;
+	for (int i = 0; i < 100; i++) {
+		map[itos(i)] = "value" + itos(i);
+	}
+
+	FlatHashMap<String, String> copy = map;
+	map.clear();
+	CHECK(map.is_empty());
+	CHECK_FALSE(map.has("1"));
+
+	CHECK(copy.size() == 100);
+	CHECK(copy["42"] == "value42");
+	const String *value = copy.getptr("99");
+	REQUIRE(value != nullptr);
+	CHECK(*value == "value99");
+	CHECK(copy.getptr("100") == nullptr);
+
+	copy.reset();
+	CHECK(copy.get_capacity() == 0);
+	copy.insert("a", "b");
+	CHECK(copy.get("a") == "b");
+}
+
+TEST_CASE("[FlatHashMap] Matches HashMap") {
+	HashMap<uint32_t, uint32_t> reference;
+	FlatHashMap<uint32_t, uint32_t> map;
+
+	uint32_t state = 12345;
+	for (int i = 0; i < 20000; i++) {
+		state = state * 1664525u + 1013904223u;
+		const uint32_t key = (state >> 8) % 4096;
+		if (state & 1) {
+			reference.insert(key, i);
+			map.insert(key, i);
+		} else {
+			CHECK(reference.erase(key) == map.erase(key));
+		}
+	}
+
+	CHECK(map.size() == reference.size());
+	for (const KeyValue<uint32_t, uint32_t> &E : reference) {
+		const uint32_t *value = map.getptr(E.key);
+		REQUIRE(value != nullptr);
+		CHECK(*value == E.value);
+	}
+}
+
+static _FORCE_INLINE_ const uint32_t *_lookup(const HashMap<uint32_t, uint32_t> &p_map, uint32_t p_key) {
+	return p_map.getptr(p_key);
+}
+
+static _FORCE_INLINE_ const uint32_t *_lookup(const OAHashMap<uint32_t, uint32_t> &p_map, uint32_t p_key) {
+	return p_map.lookup_ptr(p_key);
+}
+
+static _FORCE_INLINE_ const uint32_t *_lookup(const FlatHashMap<uint32_t, uint32_t> &p_map, uint32_t p_key) {
+	return p_map.getptr(p_key);
+}
+
+template <class TMap>
+static uint64_t _benchmark_lookups(const TMap &p_map, uint32_t p_count, uint32_t p_rounds, uint64_t &r_checksum) {
+	const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t round = 0; round < p_rounds; round++) {
+		for (uint32_t i = 0; i < p_count * 2; i++) {
+			const uint32_t *value = _lookup(p_map, i * 2654435761u);
+			if (value) {
+				r_checksum += *value;
+			}
+		}
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin_usec;
+}
+
+TEST_CASE("[Stress][FlatHashMap] Compared to HashMap and OAHashMap") {
+	const uint32_t element_count = 1 << 18;
+	const uint32_t rounds = 8;
+
+	HashMap<uint32_t, uint32_t> hash_map;
+	OAHashMap<uint32_t, uint32_t> oa_hash_map;
+	FlatHashMap<uint32_t, uint32_t> flat_hash_map;
+
+	uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < element_count; i++) {
+		hash_map.insert(i * 2 * 2654435761u, i);
+	}
+	const uint64_t hash_map_insert_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < element_count; i++) {
+		oa_hash_map.insert(i * 2 * 2654435761u, i);
+	}
+	const uint64_t oa_hash_map_insert_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	begin_usec = OS::get_singleton()->get_ticks_usec();
+	for (uint32_t i = 0; i < element_count; i++) {
+		flat_hash_map.insert(i * 2 * 2654435761u, i);
+	}
+	const uint64_t flat_hash_map_insert_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+	// Half of the lookups hit, half of them miss.
+	uint64_t hash_map_checksum = 0;
+	uint64_t oa_hash_map_checksum = 0;
+	uint64_t flat_hash_map_checksum = 0;
+	const uint64_t hash_map_lookup_usec = _benchmark_lookups(hash_map, element_count, rounds, hash_map_checksum);
+	const uint64_t oa_hash_map_lookup_usec = _benchmark_lookups(oa_hash_map, element_count, rounds, oa_hash_map_checksum);
+	const uint64_t flat_hash_map_lookup_usec = _benchmark_lookups(flat_hash_map, element_count, rounds, flat_hash_map_checksum);
+
+	CHECK(flat_hash_map_checksum == hash_map_checksum);
+	CHECK(oa_hash_map_checksum == hash_map_checksum);
+
+	print_verbose(vformat("%d inserts: HashMap %d usec, OAHashMap %d usec, FlatHashMap %d usec.", element_count, hash_map_insert_usec, oa_hash_map_insert_usec, flat_hash_map_insert_usec));
+	print_verbose(vformat("%d lookups: HashMap %d usec, OAHashMap %d usec, FlatHashMap %d usec.", element_count * 2 * rounds, hash_map_lookup_usec, oa_hash_map_lookup_usec, flat_hash_map_lookup_usec));
+}
+
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
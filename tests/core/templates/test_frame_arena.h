@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*  test_frame_arena.h                                                    */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_FRAME_ARENA_H
+#define TEST_FRAME_ARENA_H
+
+#include "core/templates/frame_arena.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFrameArena {
+
+TEST_CASE("[FrameArena] Allocation, alignment and rewinding") {
+	uint8_t *a = (uint8_t *)FrameArena::alloc(3);
+	uint8_t *b = (uint8_t *)FrameArena::alloc(8, 64);
+	REQUIRE(a != nullptr);
+	REQUIRE(b != nullptr);
+	CHECK(((uintptr_t)a & (FrameArena::DEFAULT_ALIGN - 1)) == 0);
+	CHECK(((uintptr_t)b & 63) == 0);
+	CHECK(b >= a + 3);
+	CHECK(FrameArena::get_thread_used() > 0);
+
+	// The most recent block is reused once freed.
+	FrameArena::free(b);
+	uint8_t *c = (uint8_t *)FrameArena::alloc(8, 64);
+	CHECK(c == b);
+
+	FrameArena::free(a);
+	FrameArena::free(c);
+	CHECK(FrameArena::get_thread_used() == 0);
+
+	// Once everything was freed, the arena starts over.
+	uint8_t *d = (uint8_t *)FrameArena::alloc(3);
+	CHECK(d == a);
+	FrameArena::free(d);
+}
+
+TEST_CASE("[FrameArena] Reallocation") {
+	uint8_t *a = (uint8_t *)FrameArena::alloc(16);
+	for (int i = 0; i < 16; i++) {
+		a[i] = i;
+	}
+
+	// The most recent block grows in place.
+	uint8_t *b = (uint8_t *)FrameArena::realloc(a, 16, 64);
+	CHECK(b == a);
+
+	// Other blocks are moved.
+	uint8_t *other = (uint8_t *)FrameArena::alloc(4);
+	uint8_t *c = (uint8_t *)FrameArena::realloc(b, 64, 128);
+	CHECK(c != b);
+	for (int i = 0; i < 16; i++) {
+		CHECK(c[i] == i);
+	}
+
+	// Blocks larger than a chunk are supported as well.
+	uint8_t *d = (uint8_t *)FrameArena::realloc(c, 128, FrameArena::CHUNK_SIZE * 2);
+	for (int i = 0; i < 16; i++) {
+		CHECK(d[i] == i);
+	}
+
+	FrameArena::free(d);
+	FrameArena::free(other);
+	CHECK(FrameArena::get_thread_used() == 0);
+}
+
+TEST_CASE("[FrameArena] Unused chunks are released at frame boundaries") {
+	// Let go of whatever previous tests left reserved.
+	uint8_t *a = nullptr;
+	for (int i = 0; i < 2; i++) {
+		FrameArena::begin_frame();
+		a = (uint8_t *)FrameArena::alloc(16);
+		FrameArena::free(a);
+	}
+	const size_t reserved = FrameArena::get_thread_reserved();
+
+	uint8_t *big = (uint8_t *)FrameArena::alloc(FrameArena::CHUNK_SIZE * 4);
+	CHECK(FrameArena::get_thread_reserved() > reserved);
+	FrameArena::free(big);
+
+	// Still kept around for the next frame, as it was needed in the current one.
+	FrameArena::begin_frame();
+	a = (uint8_t *)FrameArena::alloc(16);
+	FrameArena::free(a);
+	CHECK(FrameArena::get_thread_reserved() > reserved);
+
+	// Not needed for a whole frame, so it's released.
+	FrameArena::begin_frame();
+	a = (uint8_t *)FrameArena::alloc(16);
+	FrameArena::free(a);
+	CHECK(FrameArena::get_thread_reserved() == reserved);
+}
+
+TEST_CASE("[FrameArena] Containers") {
+	{
+		FrameLocalVector<int> vector;
+		for (int i = 0; i < 1000; i++) {
+			vector.push_back(i);
+		}
+		CHECK(vector.size() == 1000);
+		for (int i = 0; i < 1000; i++) {
+			CHECK(vector[i] == i);
+		}
+
+		FrameHashMap<int, String> map;
+		for (int i = 0; i < 100; i++) {
+			map.insert(i, itos(i));
+		}
+		for (int i = 0; i < 100; i += 2) {
+			map.erase(i);
+		}
+		CHECK(map.size() == 50);
+		CHECK(map[51] == "51");
+		CHECK_FALSE(map.has(50));
+
+		CHECK(FrameArena::get_thread_used() > 0);
+	}
+	CHECK(FrameArena::get_thread_used() == 0);
+}
+
+} // namespace TestFrameArena
+
+#endif // TEST_FRAME_ARENA_H
@@ -0,0 +1,81 @@
+/**************************************************************************/
+/*  test_work_stealing_deque.h                                            */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_WORK_STEALING_DEQUE_H
+#define TEST_WORK_STEALING_DEQUE_H
+
+#include "core/templates/work_stealing_deque.h"
+
+#include "tests/test_macros.h"
+
+namespace TestWorkStealingDeque {
+
+TEST_CASE("[WorkStealingDeque] Owner pops LIFO, thieves steal FIFO") {
+	int values[4] = { 0, 1, 2, 3 };
+	WorkStealingDeque<int> deque;
+	deque.setup(4);
+	CHECK(deque.get_capacity() == 4);
+	CHECK(deque.is_empty());
+	CHECK(deque.pop() == nullptr);
+	CHECK(deque.steal() == nullptr);
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(deque.push(&values[i]));
+	}
+	CHECK_MESSAGE(!deque.push(&values[0]), "Pushing to a full deque should fail.");
+
+	CHECK(deque.steal() == &values[0]);
+	CHECK(deque.pop() == &values[3]);
+	CHECK(deque.steal() == &values[1]);
+	CHECK(deque.pop() == &values[2]);
+	CHECK(deque.is_empty());
+	CHECK(deque.pop() == nullptr);
+
+	// Indices keep growing past the capacity.
+	for (int round = 0; round < 3; round++) {
+		CHECK(deque.push(&values[round]));
+		CHECK(deque.push(&values[round + 1]));
+		CHECK(deque.steal() == &values[round]);
+		CHECK(deque.pop() == &values[round + 1]);
+	}
+	CHECK(deque.is_empty());
+}
+
+TEST_CASE("[WorkStealingDeque] Capacity is rounded to a power of two") {
+	WorkStealingDeque<int> deque;
+	deque.setup(5);
+	CHECK(deque.get_capacity() == 8);
+	deque.clear();
+	CHECK(!deque.is_setup());
+}
+
+} // namespace TestWorkStealingDeque
+
+#endif // TEST_WORK_STEALING_DEQUE_H
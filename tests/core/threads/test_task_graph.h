@@ -0,0 +1,261 @@
+/**************************************************************************/
+/*  test_task_graph.h                                                     */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_TASK_GRAPH_H
+#define TEST_TASK_GRAPH_H
+
+#include "core/object/task_graph.h"
+
+#include "tests/test_macros.h"
+
+namespace TestTaskGraph {
+
+static const int GROUP_ELEMENTS = 256;
+
+struct GraphTestData {
+	LocalVector<SafeNumeric<uint32_t>> values;
+	SafeNumeric<uint32_t> sum;
+	SafeNumeric<uint32_t> final_value;
+	SafeFlag order_ok;
+};
+
+static void fill_values(void *p_data, uint32_t p_index) {
+	GraphTestData *data = (GraphTestData *)p_data;
+	data->values[p_index].set(p_index + 1);
+}
+
+static void sum_values(void *p_data, uint32_t p_index) {
+	GraphTestData *data = (GraphTestData *)p_data;
+	if (data->values[p_index].get() != p_index + 1) {
+		data->order_ok.clear();
+	}
+	data->sum.add(data->values[p_index].get());
+}
+
+static void publish_sum(void *p_data) {
+	GraphTestData *data = (GraphTestData *)p_data;
+	data->final_value.set(data->sum.get());
+}
+
+TEST_CASE("[TaskGraph] Dependent phases run in order") {
+	GraphTestData data;
+	data.values.resize(GROUP_ELEMENTS);
+
+	TaskGraph graph;
+	TaskGraph::NodeID fill = graph.add_native_group_task(fill_values, &data, GROUP_ELEMENTS);
+	TaskGraph::NodeID sum = graph.add_native_group_task(sum_values, &data, GROUP_ELEMENTS);
+	TaskGraph::NodeID publish = graph.add_native_task(publish_sum, &data);
+	graph.depends_on(sum, fill);
+	graph.depends_on(publish, sum);
+	CHECK(graph.get_node_count() == 3);
+
+	const uint32_t expected = GROUP_ELEMENTS * (GROUP_ELEMENTS + 1) / 2;
+
+	// The same graph is reused, like it would be every frame.
+	for (int run = 0; run < 50; run++) {
+		for (uint32_t i = 0; i < data.values.size(); i++) {
+			data.values[i].set(0);
+		}
+		data.sum.set(0);
+		data.final_value.set(0);
+		data.order_ok.set();
+
+		CHECK(graph.submit() == OK);
+		CHECK(graph.is_submitted());
+		graph.wait();
+		CHECK(!graph.is_submitted());
+		CHECK(graph.is_completed());
+
+		CHECK(data.order_ok.is_set());
+		CHECK(data.final_value.get() == expected);
+	}
+}
+
+static void diamond_root(void *p_data) {
+	((SafeNumeric<uint32_t> *)p_data)[0].set(1);
+}
+static void diamond_left(void *p_data) {
+	SafeNumeric<uint32_t> *values = (SafeNumeric<uint32_t> *)p_data;
+	values[1].set(values[0].get() + 1);
+}
+static void diamond_right(void *p_data) {
+	SafeNumeric<uint32_t> *values = (SafeNumeric<uint32_t> *)p_data;
+	values[2].set(values[0].get() + 2);
+}
+static void diamond_join(void *p_data) {
+	SafeNumeric<uint32_t> *values = (SafeNumeric<uint32_t> *)p_data;
+	values[3].set(values[1].get() + values[2].get());
+}
+
+TEST_CASE("[TaskGraph] Continuation waits for all dependencies") {
+	SafeNumeric<uint32_t> values[4];
+
+	TaskGraph graph;
+	TaskGraph::NodeID root = graph.add_native_task(diamond_root, values);
+	TaskGraph::NodeID left = graph.add_native_task(diamond_left, values);
+	TaskGraph::NodeID right = graph.add_native_task(diamond_right, values);
+	TaskGraph::NodeID join = graph.add_native_task(diamond_join, values);
+	graph.depends_on(left, root);
+	graph.depends_on(right, root);
+	graph.depends_on(join, left);
+	graph.depends_on(join, right);
+	graph.depends_on(join, right); // Duplicates are ignored.
+
+	for (int run = 0; run < 100; run++) {
+		for (int i = 0; i < 4; i++) {
+			values[i].set(0);
+		}
+		graph.submit();
+		graph.wait();
+		CHECK(values[3].get() == 5);
+	}
+}
+
+TEST_CASE("[TaskGraph] Group element count can change between runs") {
+	GraphTestData data;
+	data.values.resize(GROUP_ELEMENTS);
+
+	TaskGraph graph;
+	TaskGraph::NodeID sum = graph.add_native_group_task(sum_values, &data, 0);
+	TaskGraph::NodeID publish = graph.add_native_task(publish_sum, &data);
+	graph.depends_on(publish, sum);
+
+	for (uint32_t i = 0; i < data.values.size(); i++) {
+		data.values[i].set(i + 1);
+	}
+
+	graph.submit();
+	graph.wait();
+	CHECK(data.final_value.get() == 0);
+
+	graph.set_group_elements(sum, 4);
+	graph.submit();
+	graph.wait();
+	CHECK(data.final_value.get() == 10);
+}
+
+static void count_element(void *p_data, uint32_t p_index) {
+	((SafeNumeric<uint32_t> *)p_data)[p_index].increment();
+}
+
+TEST_CASE("[TaskGraph] Group elements run once per submission") {
+	// More tasks than elements, so most tasks find no work and exit
+	// while others may still be running their element.
+	static const uint32_t ELEMENTS = 10;
+	SafeNumeric<uint32_t> counts[ELEMENTS];
+
+	TaskGraph graph;
+	TaskGraph::NodeID first = graph.add_native_group_task(count_element, counts, ELEMENTS, 64);
+	TaskGraph::NodeID second = graph.add_native_group_task(count_element, counts, ELEMENTS, 64);
+	graph.depends_on(second, first);
+
+	for (uint32_t run = 1; run <= 200; run++) {
+		graph.submit();
+		graph.wait();
+		bool counts_ok = true;
+		for (uint32_t i = 0; i < ELEMENTS; i++) {
+			counts_ok = counts_ok && counts[i].get() == run * 2;
+		}
+		CHECK(counts_ok);
+	}
+
+	// Graphs freed right after waiting must not be touched by tasks still on their way out.
+	for (int i = 0; i < 100; i++) {
+		SafeNumeric<uint32_t> local_counts[ELEMENTS];
+		TaskGraph local_graph;
+		local_graph.add_native_group_task(count_element, local_counts, ELEMENTS, 64);
+		local_graph.submit();
+	}
+}
+
+struct NestedGraphData {
+	GraphTestData graph_data;
+	SafeFlag waited;
+};
+
+static void run_graph_from_pool_thread(void *p_data) {
+	NestedGraphData *data = (NestedGraphData *)p_data;
+
+	TaskGraph graph;
+	TaskGraph::NodeID fill = graph.add_native_group_task(fill_values, &data->graph_data, GROUP_ELEMENTS);
+	TaskGraph::NodeID sum = graph.add_native_group_task(sum_values, &data->graph_data, GROUP_ELEMENTS);
+	TaskGraph::NodeID publish = graph.add_native_task(publish_sum, &data->graph_data);
+	graph.depends_on(sum, fill);
+	graph.depends_on(publish, sum);
+	graph.submit();
+	graph.wait();
+	data->waited.set();
+}
+
+TEST_CASE("[TaskGraph] Waiting from a pool thread") {
+	// Every pool thread waits on its own graph, so the graphs can only make
+	// progress if waiting pool threads run tasks meanwhile.
+	const int waiter_count = MAX(1, WorkerThreadPool::get_singleton()->get_thread_count());
+	LocalVector<NestedGraphData> datas;
+	datas.resize(waiter_count);
+	LocalVector<WorkerThreadPool::TaskID> task_ids;
+	for (NestedGraphData &data : datas) {
+		data.graph_data.values.resize(GROUP_ELEMENTS);
+		data.graph_data.order_ok.set();
+		task_ids.push_back(WorkerThreadPool::get_singleton()->add_native_task(run_graph_from_pool_thread, &data, true));
+	}
+	for (WorkerThreadPool::TaskID task_id : task_ids) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(task_id);
+	}
+
+	const uint32_t expected = GROUP_ELEMENTS * (GROUP_ELEMENTS + 1) / 2;
+	for (NestedGraphData &data : datas) {
+		CHECK(data.waited.is_set());
+		CHECK(data.graph_data.order_ok.is_set());
+		CHECK(data.graph_data.final_value.get() == expected);
+	}
+}
+
+TEST_CASE("[TaskGraph] Invalid use") {
+	TaskGraph graph;
+	TaskGraph::NodeID first = graph.add_native_task(publish_sum, nullptr);
+	TaskGraph::NodeID second = graph.add_native_task(publish_sum, nullptr);
+
+	ERR_PRINT_OFF;
+	graph.depends_on(first, second); // Would allow cycles.
+	graph.depends_on(first, 10);
+	CHECK(graph.add_native_group_task(fill_values, nullptr, -1) == TaskGraph::INVALID_NODE_ID);
+	ERR_PRINT_ON;
+
+	// Empty graphs complete right away.
+	TaskGraph empty;
+	CHECK(empty.submit() == OK);
+	empty.wait();
+	CHECK(empty.is_completed());
+}
+
+} // namespace TestTaskGraph
+
+#endif // TEST_TASK_GRAPH_H
@@ -106,6 +106,116 @@ TEST_CASE("[WorkerThreadPool] Process elements using group tasks") {
 	}
 }
 
+static const int NESTED_TASK_COUNT = 64;
+
+static void static_nested_leaf_test(void *p_arg) {
+	counter[(uint64_t)p_arg].increment();
+}
+static void static_nested_root_test(void *p_arg) {
+	// Tasks posted from a pool thread go to its own deque in work-stealing mode.
+	// Half of them are low priority, so the throttling is exercised too.
+	WorkerThreadPool::TaskID tasks[NESTED_TASK_COUNT];
+	for (int i = 0; i < NESTED_TASK_COUNT; i++) {
+		tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_leaf_test, p_arg, i % 2);
+	}
+	for (int i = 0; i < NESTED_TASK_COUNT; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+	}
+}
+
+static uint64_t run_nested_tasks(int p_root_count) {
+	counter.clear();
+	counter.resize(p_root_count);
+
+	LocalVector<WorkerThreadPool::TaskID> tasks;
+	tasks.resize(p_root_count);
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < p_root_count; i++) {
+		tasks[i] = WorkerThreadPool::get_singleton()->add_native_task(static_nested_root_test, (void *)(uintptr_t)i, true);
+	}
+	for (int i = 0; i < p_root_count; i++) {
+		WorkerThreadPool::get_singleton()->wait_for_task_completion(tasks[i]);
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+// Re-initializes the global pool and brings back the configuration it had
+// (as set up by the test runner) when going out of scope.
+struct PoolReinitializer {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	int thread_count = pool->get_thread_count();
+	float low_priority_task_ratio = pool->get_low_priority_task_ratio();
+	bool work_stealing = pool->is_work_stealing();
+
+	void reinit(bool p_work_stealing) {
+		pool->finish();
+		// Work stealing needs at least two threads.
+		pool->init(p_work_stealing ? MAX(thread_count, 2) : thread_count, low_priority_task_ratio, p_work_stealing);
+	}
+
+	~PoolReinitializer() {
+		pool->finish();
+		pool->init(thread_count, low_priority_task_ratio, work_stealing);
+	}
+};
+
+TEST_CASE("[WorkerThreadPool] Work-stealing mode") {
+	PoolReinitializer reinitializer;
+	reinitializer.reinit(true);
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	CHECK(pool->is_work_stealing());
+
+	const int root_count = 32;
+	run_nested_tasks(root_count);
+
+	bool all_run = true;
+	for (int i = 0; i < root_count; i++) {
+		all_run &= counter[i].get() == NESTED_TASK_COUNT;
+	}
+	CHECK(all_run);
+
+	counter.clear();
+	counter.resize(64);
+	WorkerThreadPool::GroupID group = pool->add_native_group_task(static_group_test, (void *)2, 64, -1, true);
+	pool->wait_for_group_task_completion(group);
+	bool all_run_once = true;
+	for (int i = 1; i < 64; i++) {
+		all_run_once &= counter[i].get() == 1;
+	}
+	CHECK(all_run_once);
+}
+
+TEST_CASE("[WorkerThreadPool] Settings are restored after re-initializing") {
+	WorkerThreadPool *pool = WorkerThreadPool::get_singleton();
+	const int thread_count = pool->get_thread_count();
+	const float low_priority_task_ratio = pool->get_low_priority_task_ratio();
+	const bool work_stealing = pool->is_work_stealing();
+
+	{
+		PoolReinitializer reinitializer;
+		reinitializer.reinit(!work_stealing);
+	}
+
+	CHECK_EQ(pool->get_thread_count(), thread_count);
+	CHECK_EQ(pool->get_low_priority_task_ratio(), low_priority_task_ratio);
+	CHECK_EQ(pool->is_work_stealing(), work_stealing);
+}
+
+TEST_CASE("[Stress][WorkerThreadPool] Nested task throughput") {
+	PoolReinitializer reinitializer;
+	const int root_count = 256;
+	const double task_count = root_count * (NESTED_TASK_COUNT + 1);
+
+	reinitializer.reinit(false);
+	const uint64_t shared_usec = MAX(run_nested_tasks(root_count), (uint64_t)1);
+
+	reinitializer.reinit(true);
+	const uint64_t stealing_usec = MAX(run_nested_tasks(root_count), (uint64_t)1);
+
+	print_verbose(vformat("WorkerThreadPool with %d threads: %d tasks/sec with shared queue, %d tasks/sec with work stealing.", reinitializer.pool->get_thread_count(), uint64_t(task_count * 1000000.0 / shared_usec), uint64_t(task_count * 1000000.0 / stealing_usec)));
+}
+
 } // namespace TestWorkerThreadPool
 
 #endif // TEST_WORKER_THREAD_POOL_H
@@ -31,6 +31,8 @@
 #ifndef TEST_DICTIONARY_H
 #define TEST_DICTIONARY_H
 
+#include "core/os/os.h"
+#include "core/string/print_string.h"
 #include "core/variant/dictionary.h"
 #include "tests/test_macros.h"
 
@@ -537,6 +539,142 @@ TEST_CASE("[Dictionary] Order and find") {
 	CHECK_EQ(d.find_key("does not exist"), Variant());
 }
 
+TEST_CASE("[Dictionary] Order is kept when erasing") {
+	Dictionary d;
+	for (int i = 0; i < 100; i++) {
+		d[i] = i * 10;
+	}
+	for (int i = 0; i < 100; i += 2) {
+		CHECK(d.erase(i));
+	}
+	CHECK_FALSE(d.erase(0));
+	d[0] = "zero";
+
+	CHECK_EQ(d.size(), 51);
+	CHECK_EQ(d.get_key_at_index(0), Variant(1));
+	CHECK_EQ(d.get_value_at_index(0), Variant(10));
+	CHECK_EQ(d.get_key_at_index(49), Variant(99));
+	CHECK_EQ(d.get_key_at_index(50), Variant(0));
+	CHECK_EQ(d.get_value_at_index(50), Variant("zero"));
+	CHECK_EQ(d.get_key_at_index(51), Variant());
+
+	int expected = 1;
+	for (const Variant *key = d.next(); key; key = d.next(key)) {
+		if (expected < 100) {
+			CHECK_EQ(*key, Variant(expected));
+			expected += 2;
+		} else {
+			CHECK_EQ(*key, Variant(0));
+		}
+	}
+
+	// Erasing everything and starting over.
+	Array keys = d.keys();
+	for (int i = 0; i < keys.size(); i++) {
+		d.erase(keys[i]);
+	}
+	CHECK(d.is_empty());
+	CHECK_EQ(d.next(), nullptr);
+	d["a"] = 1;
+	CHECK_EQ(d.keys(), build_array("a"));
+}
+
+TEST_CASE("[Dictionary] Large dictionaries") {
+	Dictionary d;
+	for (int i = 0; i < 10000; i++) {
+		d[itos(i)] = i;
+	}
+	CHECK_EQ(d.size(), 10000);
+
+	for (int i = 0; i < 10000; i += 3) {
+		d.erase(StringName(itos(i)));
+	}
+	for (int i = 0; i < 10000; i++) {
+		CHECK_EQ(d.has(StringName(itos(i))), i % 3 != 0);
+	}
+	CHECK_EQ(d[StringName("9998")], Variant(9998));
+	CHECK_EQ(d.get_key_at_index(0), Variant("1"));
+	CHECK_EQ(d.get_key_at_index(1), Variant("2"));
+	CHECK_EQ(d.get_key_at_index(2), Variant("4"));
+
+	Dictionary copy = d.duplicate();
+	CHECK_EQ(copy, d);
+	CHECK_EQ(copy.hash(), d.hash());
+}
+
+TEST_CASE("[Dictionary] References stay valid while inserting") {
+	Dictionary d;
+	Variant &first = d["first"];
+	first = 1;
+	for (int i = 0; i < 1000; i++) {
+		d[i] = i;
+	}
+	first = 2;
+	CHECK_EQ(d["first"], Variant(2));
+}
+
+TEST_CASE("[Dictionary] References stay valid while erasing other keys") {
+	Dictionary d;
+	for (int i = 0; i < 100; i++) {
+		d[i] = i;
+	}
+	Variant &last = d[99];
+	const Variant *middle = d.getptr(50);
+	// Enough erasures for the holes to outnumber the remaining entries.
+	for (int i = 0; i < 90; i++) {
+		if (i != 50) {
+			d.erase(i);
+		}
+	}
+	// Inserting reuses the freed entries.
+	for (int i = 100; i < 150; i++) {
+		d[i] = i;
+	}
+	CHECK_EQ(*middle, Variant(50));
+	last = "last";
+	CHECK_EQ(d[99], Variant("last"));
+	CHECK_EQ(d.get_key_at_index(0), Variant(50));
+	CHECK_EQ(d.get_key_at_index(1), Variant(90));
+	CHECK_EQ(d.get_key_at_index(11), Variant(100));
+}
+
+TEST_CASE("[Stress][Dictionary] Get, set and iteration") {
+	const int sizes[] = { 1, 10, 100, 1000, 10000 };
+	for (const int size : sizes) {
+		const int rounds = 100000 / size;
+
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		Dictionary d;
+		for (int round = 0; round < rounds; round++) {
+			d = Dictionary();
+			for (int i = 0; i < size; i++) {
+				d[i] = i;
+			}
+		}
+		const uint64_t set_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		int64_t sum = 0;
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < rounds; round++) {
+			for (int i = 0; i < size; i++) {
+				sum += int64_t(d[i]);
+			}
+		}
+		const uint64_t get_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int round = 0; round < rounds; round++) {
+			for (const Variant *key = d.next(); key; key = d.next(key)) {
+				sum -= int64_t(*key);
+			}
+		}
+		const uint64_t iteration_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		CHECK_EQ(sum, 0);
+		print_verbose(vformat("Dictionary of %d int keys, %d rounds: set %d usec, get %d usec, iteration %d usec.", size, rounds, set_usec, get_usec, iteration_usec));
+	}
+}
+
 } // namespace TestDictionary
 
 #endif // TEST_DICTIONARY_H
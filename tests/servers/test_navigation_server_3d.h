@@ -31,6 +31,8 @@
 #ifndef TEST_NAVIGATION_SERVER_3D_H
 #define TEST_NAVIGATION_SERVER_3D_H
 
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
 #include "scene/3d/mesh_instance_3d.h"
 #include "scene/resources/3d/primitive_meshes.h"
 #include "servers/navigation_server_3d.h"
@@ -61,6 +63,51 @@ static inline Array build_array(Variant item, Targs... Fargs) {
 	return a;
 }
 
+// A grid of quads with uneven heights, so closest polygon queries rarely tie.
+static Ref<NavigationMesh> create_grid_navigation_mesh(int p_cells) {
+	Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+	Vector<Vector3> vertices;
+	for (int z = 0; z <= p_cells; z++) {
+		for (int x = 0; x <= p_cells; x++) {
+			vertices.push_back(Vector3(x, ((x * 7 + z * 3) % 5) * 0.1, z));
+		}
+	}
+	navigation_mesh->set_vertices(vertices);
+	for (int z = 0; z < p_cells; z++) {
+		for (int x = 0; x < p_cells; x++) {
+			const int corner = z * (p_cells + 1) + x;
+			Vector<int> polygon;
+			polygon.push_back(corner);
+			polygon.push_back(corner + 1);
+			polygon.push_back(corner + p_cells + 2);
+			polygon.push_back(corner + p_cells + 1);
+			navigation_mesh->add_polygon(polygon);
+		}
+	}
+	return navigation_mesh;
+}
+
+// Reference for closest point queries: every face of every polygon, first polygon wins ties.
+static Vector3 get_closest_point_by_linear_scan(const Ref<NavigationMesh> &p_navigation_mesh, const Vector3 &p_point, Vector3 &r_normal) {
+	const Vector<Vector3> vertices = p_navigation_mesh->get_vertices();
+	real_t closest_ds = FLT_MAX;
+	Vector3 closest_point;
+	for (int i = 0; i < p_navigation_mesh->get_polygon_count(); i++) {
+		const Vector<int> polygon = p_navigation_mesh->get_polygon(i);
+		for (int j = 2; j < polygon.size(); j++) {
+			const Face3 face(vertices[polygon[0]], vertices[polygon[j - 1]], vertices[polygon[j]]);
+			const Vector3 point = face.get_closest_point_to(p_point);
+			const real_t ds = point.distance_squared_to(p_point);
+			if (ds < closest_ds) {
+				closest_ds = ds;
+				closest_point = point;
+				r_normal = face.get_plane().normal;
+			}
+		}
+	}
+	return closest_point;
+}
+
 TEST_SUITE("[Navigation]") {
 	TEST_CASE("[NavigationServer3D] Server should be empty when initialized") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
@@ -76,6 +123,9 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 0);
 			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), 0);
 			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT), 0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ABSTRACT_NODE_COUNT), 0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ABSTRACT_EDGE_COUNT), 0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_AVOIDANCE_TIME), 0);
 		}
 	}
 
@@ -158,6 +208,9 @@ TEST_SUITE("[Navigation]") {
 			navigation_server->map_set_up(map, Vector3(1, 0, 0));
 			bool initial_use_edge_connections = navigation_server->map_get_use_edge_connections(map);
 			navigation_server->map_set_use_edge_connections(map, !initial_use_edge_connections);
+			bool initial_use_hierarchical_pathfinding = navigation_server->map_get_use_hierarchical_pathfinding(map);
+			navigation_server->map_set_use_hierarchical_pathfinding(map, !initial_use_hierarchical_pathfinding);
+			navigation_server->map_set_path_cache_size(map, 32);
 			navigation_server->process(0.0); // Give server some cycles to commit.
 
 			CHECK_EQ(navigation_server->map_get_cell_size(map), doctest::Approx(0.55));
@@ -165,6 +218,8 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(navigation_server->map_get_link_connection_radius(map), doctest::Approx(0.77));
 			CHECK_EQ(navigation_server->map_get_up(map), Vector3(1, 0, 0));
 			CHECK_EQ(navigation_server->map_get_use_edge_connections(map), !initial_use_edge_connections);
+			CHECK_EQ(navigation_server->map_get_use_hierarchical_pathfinding(map), !initial_use_hierarchical_pathfinding);
+			CHECK_EQ(navigation_server->map_get_path_cache_size(map), 32);
 		}
 
 		SUBCASE("'ProcessInfo' should report map iff active") {
@@ -759,11 +814,300 @@ TEST_SUITE("[Navigation]") {
 			CHECK_EQ(query_result->get_path_owner_ids().size(), 0);
 		}
 
+		SUBCASE("Hierarchical pathfinding should route through the abstract graph") {
+			RID other_region = navigation_server->region_create();
+			navigation_server->region_set_map(other_region, map);
+			navigation_server->region_set_transform(other_region, Transform3D(Basis(), Vector3(20, 0, 0)));
+			navigation_server->region_set_navigation_mesh(other_region, navigation_mesh);
+			RID link = navigation_server->link_create();
+			navigation_server->link_set_map(link, map);
+			navigation_server->link_set_start_position(link, Vector3(4, 0, 0));
+			navigation_server->link_set_end_position(link, Vector3(16, 0, 0));
+			navigation_server->map_set_use_hierarchical_pathfinding(map, true);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			// Both regions and the link are clusters, the bidirectional link crossings make four portals.
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ABSTRACT_NODE_COUNT), 4);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ABSTRACT_EDGE_COUNT), 2);
+
+			Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(0, 0, 0), Vector3(20, 0, 0), true);
+			CHECK_GE(path.size(), 2);
+			CHECK_EQ(path[path.size() - 1].x, doctest::Approx(20.0).epsilon(0.01));
+
+			navigation_server->map_set_use_hierarchical_pathfinding(map, false);
+			navigation_server->free(link);
+			navigation_server->free(other_region);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_ABSTRACT_NODE_COUNT), 0);
+		}
+
+		SUBCASE("Cached path queries should yield the same result") {
+			navigation_server->map_set_path_cache_size(map, 8);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			Vector<Vector3> uncached_path = navigation_server->map_get_path(map, Vector3(0, 0, 0), Vector3(10, 0, 10), true);
+			CHECK_NE(uncached_path.size(), 0);
+			CHECK_EQ(navigation_server->map_get_path(map, Vector3(0, 0, 0), Vector3(10, 0, 10), true), uncached_path);
+			CHECK_NE(navigation_server->map_get_path(map, Vector3(0, 0, 0), Vector3(10, 0, 10), false).size(), 0);
+
+			navigation_server->map_set_path_cache_size(map, 0);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+
+		SUBCASE("Flow field queries should point towards the shared target") {
+			const Vector3 target_position(4, 0, 4);
+			const Vector3 direction = navigation_server->map_get_flow_field_direction(map, target_position, Vector3(-4, 0, -4));
+			CHECK(direction.is_normalized());
+			CHECK_GT(direction.dot(Vector3(1, 0, 1).normalized()), 0.0);
+			CHECK_EQ(navigation_server->map_get_flow_field_direction(map, target_position, Vector3(-4, 0, -4)), direction);
+			CHECK_EQ(navigation_server->map_get_flow_field_direction(map, target_position, Vector3(-4, 0, -4), 2), Vector3());
+		}
+
+		SUBCASE("Async query should deliver its result on the next process step") {
+			Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+			query_parameters->set_map(map);
+			query_parameters->set_start_position(Vector3(0, 0, 0));
+			query_parameters->set_target_position(Vector3(10, 0, 10));
+			Ref<NavigationPathQueryResult3D> query_result = memnew(NavigationPathQueryResult3D);
+			CallableMock query_callback_mock;
+			navigation_server->query_path_async(query_parameters, query_result, callable_mp(&query_callback_mock, &CallableMock::function1).bind(7));
+			CHECK_EQ(query_result->get_path().size(), 0);
+
+			navigation_server->process(0.0); // Queries start once the maps are synchronized.
+			CHECK_EQ(query_callback_mock.function1_calls, 0);
+			CHECK_EQ(query_result->get_path().size(), 0);
+
+			navigation_server->process(0.0); // Results are delivered on the following step.
+			CHECK_EQ(query_callback_mock.function1_calls, 1);
+			CHECK_EQ(query_callback_mock.function1_latest_arg0, Variant(7));
+			CHECK_NE(query_result->get_path().size(), 0);
+			CHECK_NE(query_result->get_path_rids().size(), 0);
+		}
+
+		SUBCASE("Async query should still complete while the server is inactive") {
+			Ref<NavigationPathQueryParameters3D> query_parameters = memnew(NavigationPathQueryParameters3D);
+			query_parameters->set_map(map);
+			query_parameters->set_start_position(Vector3(0, 0, 0));
+			query_parameters->set_target_position(Vector3(10, 0, 10));
+			Ref<NavigationPathQueryResult3D> query_result = memnew(NavigationPathQueryResult3D);
+			CallableMock query_callback_mock;
+
+			navigation_server->set_active(false);
+			navigation_server->query_path_async(query_parameters, query_result, callable_mp(&query_callback_mock, &CallableMock::function1).bind(7));
+			navigation_server->process(0.0);
+			navigation_server->process(0.0);
+			navigation_server->set_active(true);
+
+			CHECK_EQ(query_callback_mock.function1_calls, 1);
+			CHECK_EQ(query_callback_mock.function1_latest_arg0, Variant(7));
+			CHECK_EQ(query_result->get_path(), navigation_server->map_get_path(map, Vector3(0, 0, 0), Vector3(10, 0, 10), true));
+			CHECK_NE(query_result->get_path().size(), 0);
+		}
+
 		navigation_server->free(region);
 		navigation_server->free(map);
 		navigation_server->process(0.0); // Give server some cycles to commit.
 	}
 
+	TEST_CASE("[NavigationServer3D] Server should only reconnect changed regions") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_agent_radius(0.0); // Reach the borders, so adjacent regions touch.
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(10.0, 0.001, 10.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		CHECK_NE(navigation_mesh->get_polygon_count(), 0);
+
+		// Three regions in a row along X: the middle one is the only link between the outer ones.
+		RID map = navigation_server->map_create();
+		navigation_server->map_set_active(map, true);
+		RID regions[3];
+		for (int i = 0; i < 3; i++) {
+			regions[i] = navigation_server->region_create();
+			navigation_server->region_set_transform(regions[i], Transform3D(Basis(), Vector3(10.0 * i, 0, 0)));
+			navigation_server->region_set_navigation_mesh(regions[i], navigation_mesh);
+			navigation_server->region_set_map(regions[i], map);
+		}
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		const Vector3 start = Vector3(-4, 0, 0);
+		const Vector3 end = Vector3(24, 0, 0);
+		Vector<Vector3> path = navigation_server->map_get_path(map, start, end, true);
+		REQUIRE_GE(path.size(), 2);
+		CHECK_EQ(path[path.size() - 1].x, doctest::Approx(end.x).epsilon(0.01));
+
+		const int connected_merge_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT);
+		const int connected_connection_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
+		const int connected_free_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+		CHECK_GT(connected_merge_count + connected_connection_count, 0);
+
+		SUBCASE("Changing a region should keep its neighbors connected") {
+			navigation_server->region_set_navigation_mesh(regions[1], navigation_mesh); // Force update.
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			path = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GE(path.size(), 2);
+			CHECK_EQ(path[path.size() - 1].x, doctest::Approx(end.x).epsilon(0.01));
+
+			// Changing an outer region should leave the connections between the other two alone.
+			navigation_server->region_set_navigation_mesh(regions[2], navigation_mesh); // Force update.
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), connected_merge_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), connected_connection_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT), connected_free_count);
+			path = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GE(path.size(), 2);
+			CHECK_EQ(path[path.size() - 1].x, doctest::Approx(end.x).epsilon(0.01));
+		}
+
+		SUBCASE("Removing a region should leave no connections to it") {
+			const RID removed_region = regions[1];
+			navigation_server->free(regions[1]);
+			regions[1] = RID();
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			// The outer regions are apart now, so paths stop at the border of the first one.
+			path = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GE(path.size(), 1);
+			CHECK_LE(path[path.size() - 1].x, 5.01);
+			CHECK_NE(navigation_server->map_get_closest_point_owner(map, Vector3(10, 0, 0)), removed_region);
+			// Edges once connected to the removed region are free again, and both outer regions share nothing.
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), 0);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), 0);
+			CHECK_GT(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT), connected_free_count);
+
+			// Adding it back should bring back the same connections.
+			regions[1] = navigation_server->region_create();
+			navigation_server->region_set_transform(regions[1], Transform3D(Basis(), Vector3(10, 0, 0)));
+			navigation_server->region_set_navigation_mesh(regions[1], navigation_mesh);
+			navigation_server->region_set_map(regions[1], map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), connected_merge_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), connected_connection_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT), connected_free_count);
+			path = navigation_server->map_get_path(map, start, end, true);
+			REQUIRE_GE(path.size(), 2);
+			CHECK_EQ(path[path.size() - 1].x, doctest::Approx(end.x).epsilon(0.01));
+		}
+
+		SUBCASE("Incremental updates should match a full rebuild") {
+			// Several updates in a row: move, disable, enable and move back regions.
+			navigation_server->region_set_transform(regions[2], Transform3D(Basis(), Vector3(20, 0, 5)));
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			navigation_server->region_set_enabled(regions[0], false);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			navigation_server->region_set_enabled(regions[0], true);
+			navigation_server->region_set_transform(regions[1], Transform3D(Basis(), Vector3(10, 0, -2)));
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			const Vector3 query_points[] = { start, Vector3(9, 0, -6), Vector3(12, 0, 2), Vector3(24, 0, 9) };
+			LocalVector<Vector<Vector3>> incremental_paths;
+			for (const Vector3 &from : query_points) {
+				for (const Vector3 &to : query_points) {
+					incremental_paths.push_back(navigation_server->map_get_path(map, from, to, true));
+				}
+			}
+			const int incremental_merge_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT);
+			const int incremental_connection_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT);
+			const int incremental_free_count = navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT);
+
+			// Map settings that affect every connection make the map reconnect all regions from scratch.
+			const real_t edge_connection_margin = navigation_server->map_get_edge_connection_margin(map);
+			navigation_server->map_set_edge_connection_margin(map, edge_connection_margin * 2.0);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			navigation_server->map_set_edge_connection_margin(map, edge_connection_margin);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_MERGE_COUNT), incremental_merge_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_CONNECTION_COUNT), incremental_connection_count);
+			CHECK_EQ(navigation_server->get_process_info(NavigationServer3D::INFO_EDGE_FREE_COUNT), incremental_free_count);
+			uint32_t path_index = 0;
+			for (const Vector3 &from : query_points) {
+				for (const Vector3 &to : query_points) {
+					CHECK_EQ(navigation_server->map_get_path(map, from, to, true), incremental_paths[path_index++]);
+				}
+			}
+		}
+
+		for (RID &region : regions) {
+			if (region.is_valid()) {
+				navigation_server->free(region);
+			}
+		}
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[NavigationServer3D] Closest point queries should match a linear scan") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = create_grid_navigation_mesh(32);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		RandomNumberGenerator rng;
+		rng.set_seed(42);
+		bool points_match = true;
+		bool normals_match = true;
+		for (int i = 0; i < 1000; i++) {
+			// Points on, above, below and around the grid.
+			const Vector3 point = Vector3(rng.randf_range(-8.0, 40.0), rng.randf_range(-4.0, 4.0), rng.randf_range(-8.0, 40.0));
+			Vector3 expected_normal;
+			const Vector3 expected_point = get_closest_point_by_linear_scan(navigation_mesh, point, expected_normal);
+			points_match = points_match && navigation_server->map_get_closest_point(map, point) == expected_point;
+			normals_match = normals_match && navigation_server->map_get_closest_point_normal(map, point) == expected_normal;
+		}
+		CHECK(points_match);
+		CHECK(normals_match);
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
+
+	TEST_CASE("[Stress][NavigationServer3D] Closest point query latency") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		const int grid_sizes[] = { 8, 32, 128, 256 };
+		const int queries = 10000;
+
+		for (const int grid_size : grid_sizes) {
+			Ref<NavigationMesh> navigation_mesh = create_grid_navigation_mesh(grid_size);
+
+			RID map = navigation_server->map_create();
+			RID region = navigation_server->region_create();
+			navigation_server->map_set_active(map, true);
+			navigation_server->region_set_map(region, map);
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+
+			RandomNumberGenerator rng;
+			rng.set_seed(42);
+			Vector<Vector3> points;
+			for (int i = 0; i < queries; i++) {
+				points.push_back(Vector3(rng.randf_range(0.0, grid_size), rng.randf_range(-1.0, 1.0), rng.randf_range(0.0, grid_size)));
+			}
+
+			const uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+			for (const Vector3 &point : points) {
+				navigation_server->map_get_closest_point(map, point);
+			}
+			const uint64_t elapsed_usec = MAX(OS::get_singleton()->get_ticks_usec() - begin_usec, (uint64_t)1);
+
+			print_verbose(vformat("Closest point with %d polygons: %d queries in %d usec (%.3f usec per query).", navigation_mesh->get_polygon_count(), queries, elapsed_usec, (double)elapsed_usec / queries));
+
+			navigation_server->free(region);
+			navigation_server->free(map);
+			navigation_server->process(0.0); // Give server some cycles to commit.
+		}
+	}
+
 	TEST_CASE("[NavigationServer3D] Server should be able to bake asynchronously") {
 		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
 		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
@@ -781,6 +1125,51 @@ TEST_SUITE("[Navigation]") {
 		CHECK_EQ(navigation_mesh->get_polygon_count(), 0);
 		CHECK_EQ(navigation_mesh->get_vertices().size(), 0);
 	}
+
+	TEST_CASE("[NavigationServer3D] Server should bake tiled navigation meshes") {
+		NavigationServer3D *navigation_server = NavigationServer3D::get_singleton();
+		Ref<NavigationMesh> navigation_mesh = memnew(NavigationMesh);
+		navigation_mesh->set_tile_size(5.0);
+		Ref<NavigationMeshSourceGeometryData3D> source_geometry = memnew(NavigationMeshSourceGeometryData3D);
+
+		Array arr;
+		arr.resize(RS::ARRAY_MAX);
+		BoxMesh::create_mesh_array(arr, Vector3(10.0, 0.001, 10.0));
+		source_geometry->add_mesh_array(arr, Transform3D());
+		navigation_server->bake_from_source_geometry_data(navigation_mesh, source_geometry, Callable());
+		CHECK_NE(navigation_mesh->get_polygon_count(), 0);
+		CHECK_NE(navigation_mesh->get_vertices().size(), 0);
+
+		RID map = navigation_server->map_create();
+		RID region = navigation_server->region_create();
+		navigation_server->map_set_active(map, true);
+		navigation_server->region_set_map(region, map);
+		navigation_server->region_set_navigation_mesh(region, navigation_mesh);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+
+		SUBCASE("Paths should cross tile seams") {
+			Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-4, 0, -4), Vector3(4, 0, 4), true);
+			CHECK_GE(path.size(), 2);
+			CHECK_EQ(path[path.size() - 1].x, doctest::Approx(4.0).epsilon(0.01));
+			CHECK_EQ(path[path.size() - 1].z, doctest::Approx(4.0).epsilon(0.01));
+		}
+
+		SUBCASE("Rebaking a single tile should keep the rest of the navigation mesh") {
+			const int polygon_count = navigation_mesh->get_polygon_count();
+			navigation_server->bake_tile_from_source_geometry_data(navigation_mesh, source_geometry, Vector2i(0, 0), Callable());
+			CHECK_EQ(navigation_mesh->get_polygon_count(), polygon_count);
+
+			navigation_server->region_set_navigation_mesh(region, navigation_mesh); // Force update.
+			navigation_server->process(0.0); // Give server some cycles to commit.
+			Vector<Vector3> path = navigation_server->map_get_path(map, Vector3(-4, 0, -4), Vector3(4, 0, 4), true);
+			CHECK_GE(path.size(), 2);
+			CHECK_EQ(path[path.size() - 1].x, doctest::Approx(4.0).epsilon(0.01));
+		}
+
+		navigation_server->free(region);
+		navigation_server->free(map);
+		navigation_server->process(0.0); // Give server some cycles to commit.
+	}
 }
 } //namespace TestNavigationServer3D
 
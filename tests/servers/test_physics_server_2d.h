@@ -0,0 +1,181 @@
+/**************************************************************************/
+/*  test_physics_server_2d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+
+#ifndef TEST_PHYSICS_SERVER_2D_H
+#define TEST_PHYSICS_SERVER_2D_H
+
+#include "core/config/project_settings.h"
+#include "servers/physics_server_2d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer2D {
+
+static const real_t STEP = 1.0 / 60.0;
+static const real_t GRAVITY = 980.0;
+static const real_t BOX_HALF_SIZE = 16.0;
+
+// A box dropped right above a static floor, whose top is at y = 0.
+struct RestingBoxScene {
+	RID space;
+	RID box_shape;
+	RID floor_shape;
+	RID floor;
+	RID box;
+
+	void create() {
+		PhysicsServer2D *physics_server = PhysicsServer2D::get_singleton();
+
+		space = physics_server->space_create();
+		physics_server->space_set_active(space, true);
+		physics_server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY, GRAVITY);
+		physics_server->area_set_param(space, PhysicsServer2D::AREA_PARAM_GRAVITY_VECTOR, Vector2(0, 1));
+
+		floor_shape = physics_server->rectangle_shape_create();
+		physics_server->shape_set_data(floor_shape, Vector2(200, 16));
+
+		floor = physics_server->body_create();
+		physics_server->body_set_mode(floor, PhysicsServer2D::BODY_MODE_STATIC);
+		physics_server->body_add_shape(floor, floor_shape);
+		physics_server->body_set_space(floor, space);
+		physics_server->body_set_state(floor, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, 16)));
+
+		box_shape = physics_server->rectangle_shape_create();
+		physics_server->shape_set_data(box_shape, Vector2(BOX_HALF_SIZE, BOX_HALF_SIZE));
+
+		box = physics_server->body_create();
+		physics_server->body_set_mode(box, PhysicsServer2D::BODY_MODE_RIGID);
+		physics_server->body_add_shape(box, box_shape);
+		physics_server->body_set_space(box, space);
+		physics_server->body_set_max_contacts_reported(box, 4);
+		// Sleeping bodies aren't solved, so they wouldn't report their contacts anymore.
+		physics_server->body_set_state(box, PhysicsServer2D::BODY_STATE_CAN_SLEEP, false);
+		physics_server->body_set_state(box, PhysicsServer2D::BODY_STATE_TRANSFORM, Transform2D(0, Vector2(0, -BOX_HALF_SIZE - 1)));
+	}
+
+	void step(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			PhysicsServer2D::get_singleton()->step(STEP);
+		}
+	}
+
+	void free() {
+		PhysicsServer2D *physics_server = PhysicsServer2D::get_singleton();
+		physics_server->free(box);
+		physics_server->free(floor);
+		physics_server->free(box_shape);
+		physics_server->free(floor_shape);
+		physics_server->free(space);
+	}
+};
+
+// The impulse reported for a contact is the one it was warm started with in the last step.
+static real_t get_total_normal_impulse(const PhysicsDirectBodyState2D *p_state) {
+	real_t total = 0.0;
+	for (int i = 0; i < p_state->get_contact_count(); i++) {
+		total += Math::abs(p_state->get_contact_impulse(i).dot(p_state->get_contact_local_normal(i)));
+	}
+	return total;
+}
+
+static int find_contact(const PhysicsDirectBodyState2D *p_state, const Vector2 &p_position, real_t p_tolerance) {
+	for (int i = 0; i < p_state->get_contact_count(); i++) {
+		if (p_state->get_contact_local_position(i).distance_to(p_position) < p_tolerance) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+TEST_SUITE("[Physics]") {
+	TEST_CASE("[PhysicsServer2D] Contact cache") {
+		PhysicsServer2D *physics_server = PhysicsServer2D::get_singleton();
+		RestingBoxScene scene;
+		scene.create();
+
+		PhysicsDirectBodyState2D *state = physics_server->body_get_direct_state(scene.box);
+		REQUIRE(state != nullptr);
+
+		int steps = 0;
+		while (state->get_contact_count() == 0 && steps < 60) {
+			scene.step(1);
+			steps++;
+		}
+		REQUIRE(state->get_contact_count() > 0);
+		CHECK_MESSAGE(get_total_normal_impulse(state) == 0.0, "New contacts have no impulse to warm start from.");
+
+		scene.step(60);
+		REQUIRE(state->get_contact_count() == 2);
+
+		SUBCASE("Resting contacts are kept and warm started") {
+			// Resting contacts push back by the weight of the box every step.
+			const real_t weight_impulse = GRAVITY * STEP;
+			const real_t recycle_radius = GLOBAL_GET("physics/2d/solver/contact_recycle_radius");
+
+			Vector2 positions[2] = { state->get_contact_local_position(0), state->get_contact_local_position(1) };
+			bool kept = true;
+			bool warm_started = true;
+			for (int i = 0; i < 30; i++) {
+				scene.step(1);
+				kept = kept && state->get_contact_count() == 2;
+				for (Vector2 &position : positions) {
+					const int index = find_contact(state, position, recycle_radius);
+					kept = kept && index != -1;
+					if (index != -1) {
+						position = state->get_contact_local_position(index);
+					}
+				}
+				warm_started = warm_started && Math::abs(get_total_normal_impulse(state) - weight_impulse) < weight_impulse * 0.1;
+			}
+			CHECK_MESSAGE(kept, "The box corners should stay in contact with the floor at the same points.");
+			CHECK_MESSAGE(warm_started, "Contacts reused from the previous step should carry its impulse over.");
+
+			const Vector2 origin = Transform2D(physics_server->body_get_state(scene.box, PhysicsServer2D::BODY_STATE_TRANSFORM)).get_origin();
+			CHECK_MESSAGE(Math::abs(origin.y + BOX_HALF_SIZE) < 1.0, "The box should rest on the floor without sinking into it.");
+		}
+
+		SUBCASE("Contacts that moved away start over") {
+			// Move the box along the floor, so it touches it at points the contacts of the last step don't match.
+			Transform2D transform = physics_server->body_get_state(scene.box, PhysicsServer2D::BODY_STATE_TRANSFORM);
+			transform.columns[2].x += 50;
+			physics_server->body_set_state(scene.box, PhysicsServer2D::BODY_STATE_TRANSFORM, transform);
+			scene.step(1);
+			REQUIRE(state->get_contact_count() > 0);
+			CHECK_MESSAGE(get_total_normal_impulse(state) == 0.0, "Contacts that aren't recycled shouldn't be warm started.");
+		}
+
+		scene.free();
+	}
+}
+
+} // namespace TestPhysicsServer2D
+
+#endif // TEST_PHYSICS_SERVER_2D_H
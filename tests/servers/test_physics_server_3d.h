@@ -0,0 +1,455 @@
+/**************************************************************************/
+/*  test_physics_server_3d.h                                              */
+/**************************************************************************/
+/*                         This file is part of:                          */
+/*                             GODOT ENGINE                               */
+/*                        https://godotengine.org                         */
+/**************************************************************************/
+/* Copyright (c) 2014-present Godot Engine contributors (see AUTHORS.md). */
+/* Copyright (c) 2007-2014 Juan Linietsky, Ariel Manzur.                  */
+/*                                                                        */
+/* Permission is hereby granted, free of charge, to any person obtaining  */
+/* a copy of this software and associated documentation files (the        */
+/* "Software"), to deal in the Software without restriction, including    */
+/* without limitation the rights to use, copy, modify, merge, publish,    */
+/* distribute, sublicense, and/or sell copies of the Software, and to     */
+/* permit persons to whom the Software is furnished to do so, subject to  */
+/* the following conditions:                                              */
+/*                                                                        */
+/* The above copyright notice and this permission notice shall be         */
+/* included in all copies or substantial portions of the Software.        */
+/*                                                                        */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,        */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF     */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. */
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY   */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,   */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE      */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                 */
+/**************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "core/os/os.h"
+#include "servers/physics_server_3d.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+static const real_t STEP = 1.0 / 60.0;
+
+// Boxes in a grid, stacked two high, falling on a static floor so they collide with it and each other.
+struct BoxStackScene {
+	RID space;
+	RID shape;
+	RID floor_shape;
+	RID floor;
+	LocalVector<RID> bodies;
+
+	void create(int p_columns) {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+
+		space = physics_server->space_create();
+		physics_server->space_set_active(space, true);
+
+		shape = physics_server->box_shape_create();
+		physics_server->shape_set_data(shape, Vector3(0.5, 0.5, 0.5));
+
+		floor_shape = physics_server->box_shape_create();
+		physics_server->shape_set_data(floor_shape, Vector3(p_columns * 2, 0.5, p_columns * 2));
+
+		floor = physics_server->body_create();
+		physics_server->body_set_mode(floor, PhysicsServer3D::BODY_MODE_STATIC);
+		physics_server->body_add_shape(floor, floor_shape);
+		physics_server->body_set_space(floor, space);
+		physics_server->body_set_state(floor, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), Vector3(0, -0.5, 0)));
+
+		for (int x = 0; x < p_columns; x++) {
+			for (int z = 0; z < p_columns; z++) {
+				for (int y = 0; y < 2; y++) {
+					RID body = physics_server->body_create();
+					physics_server->body_set_mode(body, PhysicsServer3D::BODY_MODE_RIGID);
+					physics_server->body_add_shape(body, shape);
+					physics_server->body_set_space(body, space);
+					// Slightly rotated and offset, so the boxes tumble instead of settling right away.
+					const Basis basis = Basis::from_euler(Vector3(0.05 * x, 0.1 * z, 0.02 * y));
+					physics_server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(basis, Vector3(x * 1.5 + 0.1 * y, 0.6 + y * 1.1, z * 1.5)));
+					bodies.push_back(body);
+				}
+			}
+		}
+	}
+
+	void step(int p_steps) {
+		for (int i = 0; i < p_steps; i++) {
+			PhysicsServer3D::get_singleton()->step(STEP);
+		}
+	}
+
+	// Transforms and velocities of every body, as raw bytes.
+	Vector<uint8_t> get_body_data() const {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		const int body_size = sizeof(Transform3D) + sizeof(Vector3) * 2;
+		Vector<uint8_t> data;
+		data.resize(bodies.size() * body_size);
+		uint8_t *ptr = data.ptrw();
+		for (const RID &body : bodies) {
+			const Transform3D transform = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+			const Vector3 linear_velocity = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_LINEAR_VELOCITY);
+			const Vector3 angular_velocity = physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_ANGULAR_VELOCITY);
+			memcpy(ptr, &transform, sizeof(Transform3D));
+			ptr += sizeof(Transform3D);
+			memcpy(ptr, &linear_velocity, sizeof(Vector3));
+			ptr += sizeof(Vector3);
+			memcpy(ptr, &angular_velocity, sizeof(Vector3));
+			ptr += sizeof(Vector3);
+		}
+		return data;
+	}
+
+	int get_sleeping_count() const {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		int count = 0;
+		for (const RID &body : bodies) {
+			if (physics_server->body_get_space(body).is_valid() && bool(physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING))) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	RID get_sleeping_body() const {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		for (const RID &body : bodies) {
+			if (bool(physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING))) {
+				return body;
+			}
+		}
+		return RID();
+	}
+
+	// Drops a box right above p_target and returns whether the target was woken up by it,
+	// and whether the box came to rest on top of the target instead of falling through.
+	void drop_box_on(RID p_target, bool &r_woke_target, bool &r_landed) {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		const Transform3D target_transform = physics_server->body_get_state(p_target, PhysicsServer3D::BODY_STATE_TRANSFORM);
+
+		RID box = physics_server->body_create();
+		physics_server->body_set_mode(box, PhysicsServer3D::BODY_MODE_RIGID);
+		physics_server->body_add_shape(box, shape);
+		physics_server->body_set_space(box, space);
+		physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis(), target_transform.origin + Vector3(0, 3, 0)));
+
+		r_woke_target = false;
+		for (int i = 0; i < 120; i++) {
+			step(1);
+			r_woke_target = r_woke_target || !bool(physics_server->body_get_state(p_target, PhysicsServer3D::BODY_STATE_SLEEPING));
+		}
+
+		const Vector3 box_origin = Transform3D(physics_server->body_get_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin;
+		const Vector3 target_origin = Transform3D(physics_server->body_get_state(p_target, PhysicsServer3D::BODY_STATE_TRANSFORM)).origin;
+		r_landed = box_origin.y > target_origin.y + 0.5;
+
+		physics_server->free(box);
+	}
+
+	void free() {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		for (const RID &body : bodies) {
+			physics_server->free(body);
+		}
+		bodies.clear();
+		physics_server->free(floor);
+		physics_server->free(floor_shape);
+		physics_server->free(shape);
+		physics_server->free(space);
+	}
+};
+
+TEST_SUITE("[Physics]") {
+	TEST_CASE("[PhysicsServer3D] Space state round trip") {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		BoxStackScene scene;
+		scene.create(4);
+
+		// Let the boxes land, so the saved state has contacts to warm-start from.
+		scene.step(20);
+		const PackedByteArray state = physics_server->space_save_state(scene.space);
+		CHECK_FALSE(state.is_empty());
+		const Vector<uint8_t> saved_data = scene.get_body_data();
+
+		scene.step(20);
+		const Vector<uint8_t> expected_data = scene.get_body_data();
+		CHECK(saved_data != expected_data);
+
+		SUBCASE("Restoring should bring back transforms and velocities exactly") {
+			CHECK(physics_server->space_restore_state(scene.space, state));
+			CHECK(scene.get_body_data() == saved_data);
+		}
+
+		SUBCASE("Stepping after restoring should repeat the same simulation exactly") {
+			for (int run = 0; run < 3; run++) {
+				CHECK(physics_server->space_restore_state(scene.space, state));
+				scene.step(20);
+				CHECK(scene.get_body_data() == expected_data);
+			}
+		}
+
+		SUBCASE("Truncated states should be rejected without changing anything") {
+			// The last sizes cut into the pair and contact sections, after the bodies.
+			const int sizes[] = { 0, 4, 19, state.size() / 2, state.size() - 1 };
+			ERR_PRINT_OFF;
+			for (const int size : sizes) {
+				CHECK_FALSE(physics_server->space_restore_state(scene.space, state.slice(0, size)));
+				CHECK(scene.get_body_data() == expected_data);
+			}
+			PackedByteArray padded = state;
+			padded.push_back(0);
+			CHECK_FALSE(physics_server->space_restore_state(scene.space, padded));
+			CHECK(scene.get_body_data() == expected_data);
+			ERR_PRINT_ON;
+		}
+
+		SUBCASE("States with a wrong magic should be rejected") {
+			PackedByteArray corrupted = state;
+			corrupted.write[0] ^= 0xFF;
+			ERR_PRINT_OFF;
+			CHECK_FALSE(physics_server->space_restore_state(scene.space, corrupted));
+			ERR_PRINT_ON;
+			// Nothing is applied when the header is rejected.
+			CHECK(scene.get_body_data() == expected_data);
+		}
+
+		scene.free();
+	}
+
+	TEST_CASE("[PhysicsServer3D] Space state with sleeping bodies") {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		BoxStackScene scene;
+		scene.create(3);
+
+		scene.step(20);
+		const PackedByteArray state = physics_server->space_save_state(scene.space);
+
+		// Long enough for the boxes to settle and fall asleep, which reorders the active list.
+		scene.step(150);
+		const Vector<uint8_t> expected_data = scene.get_body_data();
+		int sleeping_count = 0;
+		for (const RID &body : scene.bodies) {
+			sleeping_count += bool(physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING)) ? 1 : 0;
+		}
+		CHECK(sleeping_count > 0);
+
+		for (int run = 0; run < 2; run++) {
+			CHECK(physics_server->space_restore_state(scene.space, state));
+			for (const RID &body : scene.bodies) {
+				CHECK_FALSE(bool(physics_server->body_get_state(body, PhysicsServer3D::BODY_STATE_SLEEPING)));
+			}
+			scene.step(150);
+			CHECK(scene.get_body_data() == expected_data);
+		}
+
+		scene.free();
+	}
+
+	TEST_CASE("[PhysicsServer3D] Sleeping bodies") {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		BoxStackScene scene;
+		scene.create(2);
+
+		// Long enough for the boxes to settle and fall asleep.
+		scene.step(150);
+		const int sleeping_count = scene.get_sleeping_count();
+		REQUIRE(sleeping_count > 0);
+		CHECK(physics_server->get_process_info(PhysicsServer3D::INFO_SLEEPING_OBJECTS) == sleeping_count);
+
+		SUBCASE("The sleeping objects monitor should follow bodies waking up and leaving the space") {
+			RID woken = scene.get_sleeping_body();
+			physics_server->body_set_state(woken, PhysicsServer3D::BODY_STATE_SLEEPING, false);
+			scene.step(1);
+			CHECK_FALSE(bool(physics_server->body_get_state(woken, PhysicsServer3D::BODY_STATE_SLEEPING)));
+			CHECK(scene.get_sleeping_count() < sleeping_count);
+			CHECK(physics_server->get_process_info(PhysicsServer3D::INFO_SLEEPING_OBJECTS) == scene.get_sleeping_count());
+
+			RID removed = scene.get_sleeping_body();
+			if (removed.is_valid()) {
+				const int count_before = scene.get_sleeping_count();
+				physics_server->body_set_space(removed, RID());
+				scene.step(1);
+				CHECK(physics_server->get_process_info(PhysicsServer3D::INFO_SLEEPING_OBJECTS) == scene.get_sleeping_count());
+				CHECK(scene.get_sleeping_count() < count_before);
+				physics_server->body_set_space(removed, scene.space);
+			}
+		}
+
+		SUBCASE("Moving bodies should pair with sleeping ones, wake them up and rest on them") {
+			RID target = scene.get_sleeping_body();
+			bool woke_target = false;
+			bool landed = false;
+			scene.drop_box_on(target, woke_target, landed);
+			CHECK(woke_target);
+			CHECK(landed);
+		}
+
+		SUBCASE("Sleeping bodies made static and then rigid again should still pair with moving ones") {
+			RID target = scene.get_sleeping_body();
+			physics_server->body_set_mode(target, PhysicsServer3D::BODY_MODE_STATIC);
+			scene.step(1);
+			// Static bodies report themselves as sleeping, but the monitor doesn't count them.
+			CHECK(physics_server->get_process_info(PhysicsServer3D::INFO_SLEEPING_OBJECTS) == scene.get_sleeping_count() - 1);
+
+			// Back to rigid, then straight to sleep again.
+			physics_server->body_set_mode(target, PhysicsServer3D::BODY_MODE_RIGID);
+			CHECK_FALSE(bool(physics_server->body_get_state(target, PhysicsServer3D::BODY_STATE_SLEEPING)));
+			physics_server->body_set_state(target, PhysicsServer3D::BODY_STATE_SLEEPING, true);
+			scene.step(1);
+			CHECK(bool(physics_server->body_get_state(target, PhysicsServer3D::BODY_STATE_SLEEPING)));
+			CHECK(physics_server->get_process_info(PhysicsServer3D::INFO_SLEEPING_OBJECTS) == scene.get_sleeping_count());
+
+			bool woke_target = false;
+			bool landed = false;
+			scene.drop_box_on(target, woke_target, landed);
+			CHECK(woke_target);
+			CHECK(landed);
+		}
+
+		scene.free();
+	}
+
+	TEST_CASE("[PhysicsServer3D] Batched rays match single rays") {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+
+		RID space = physics_server->space_create();
+		physics_server->space_set_active(space, true);
+
+		RID shape = physics_server->box_shape_create();
+		physics_server->shape_set_data(shape, Vector3(0.5, 0.5, 0.5));
+
+		// A row of static boxes with gaps between them, alternating between two layers, and an area over the middle.
+		LocalVector<RID> boxes;
+		for (int i = 0; i < 10; i++) {
+			RID box = physics_server->body_create();
+			physics_server->body_set_mode(box, PhysicsServer3D::BODY_MODE_STATIC);
+			physics_server->body_add_shape(box, shape);
+			physics_server->body_set_collision_layer(box, (i % 2) ? 2 : 1);
+			physics_server->body_set_space(box, space);
+			physics_server->body_set_state(box, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform3D(Basis::from_euler(Vector3(0, 0.1 * i, 0)), Vector3(i * 2, 0.25 * i, 0)));
+			boxes.push_back(box);
+		}
+
+		RID area_shape = physics_server->box_shape_create();
+		physics_server->shape_set_data(area_shape, Vector3(2, 0.5, 2));
+
+		RID area = physics_server->area_create();
+		physics_server->area_add_shape(area, area_shape);
+		physics_server->area_set_collision_layer(area, 1);
+		physics_server->area_set_space(area, space);
+		physics_server->area_set_transform(area, Transform3D(Basis(), Vector3(9, 3, 0)));
+
+		physics_server->step(STEP);
+
+		// Enough rays for several batches: vertical ones along the row, which hit the boxes or fall through
+		// the gaps, and horizontal ones along it, which only hit the first box in their way.
+		LocalVector<Vector3> from;
+		LocalVector<Vector3> to;
+		for (int i = 0; i < 100; i++) {
+			const real_t x = -2.0 + i * 0.23;
+			from.push_back(Vector3(x, 10, 0.1));
+			to.push_back(Vector3(x, -10, 0.1));
+		}
+		for (int i = 0; i < 20; i++) {
+			const real_t y = -1.0 + i * 0.2;
+			from.push_back(Vector3(-5, y, 0.05 * i - 0.5));
+			to.push_back(Vector3(30, y, 0.05 * i - 0.5));
+		}
+
+		PhysicsDirectSpaceState3D::RayParameters parameter_sets[4];
+		parameter_sets[1].collision_mask = 2;
+		parameter_sets[2].exclude.insert(boxes[4]);
+		parameter_sets[2].exclude.insert(boxes[5]);
+		parameter_sets[3].collide_with_areas = true;
+
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(from.size());
+		LocalVector<bool> hits;
+		hits.resize(from.size());
+
+		PhysicsDirectSpaceState3D *space_state = physics_server->space_get_direct_state(space);
+		REQUIRE(space_state != nullptr);
+
+		for (PhysicsDirectSpaceState3D::RayParameters &parameters : parameter_sets) {
+			const int hit_count = space_state->intersect_rays(parameters, from.ptr(), to.ptr(), from.size(), results.ptr(), hits.ptr());
+			CHECK(hit_count > 0);
+			CHECK(hit_count < int(from.size()));
+
+			int expected_hit_count = 0;
+			for (uint32_t i = 0; i < from.size(); i++) {
+				PhysicsDirectSpaceState3D::RayParameters ray_parameters = parameters;
+				ray_parameters.from = from[i];
+				ray_parameters.to = to[i];
+				PhysicsDirectSpaceState3D::RayResult expected;
+				const bool expected_hit = space_state->intersect_ray(ray_parameters, expected);
+
+				CHECK_MESSAGE(hits[i] == expected_hit, vformat("Ray %d should report the same hit as a single ray.", i));
+				if (!expected_hit || !hits[i]) {
+					continue;
+				}
+				expected_hit_count++;
+				CHECK(results[i].rid == expected.rid);
+				CHECK(results[i].shape == expected.shape);
+				CHECK(results[i].position == expected.position);
+				CHECK(results[i].normal == expected.normal);
+				CHECK(results[i].face_index == expected.face_index);
+				CHECK(!parameters.exclude.has(results[i].rid));
+			}
+			CHECK(hit_count == expected_hit_count);
+		}
+
+		// The area hangs over the middle boxes, so rays coming down there hit it first.
+		space_state->intersect_rays(parameter_sets[3], from.ptr(), to.ptr(), from.size(), results.ptr(), hits.ptr());
+		CHECK(hits[48]);
+		CHECK(results[48].rid == area);
+
+		physics_server->free(area);
+		for (const RID &box : boxes) {
+			physics_server->free(box);
+		}
+		physics_server->free(area_shape);
+		physics_server->free(shape);
+		physics_server->free(space);
+	}
+
+	TEST_CASE("[Stress][PhysicsServer3D] Space state with 5000 bodies") {
+		PhysicsServer3D *physics_server = PhysicsServer3D::get_singleton();
+		BoxStackScene scene;
+		scene.create(50); // 50 x 50 columns of two boxes.
+		scene.step(10);
+
+		const int iterations = 100;
+		PackedByteArray state;
+		uint64_t begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			state = physics_server->space_save_state(scene.space);
+		}
+		const uint64_t save_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+
+		scene.step(10);
+		bool restored = true;
+		begin_usec = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < iterations; i++) {
+			restored = physics_server->space_restore_state(scene.space, state) && restored;
+		}
+		const uint64_t restore_usec = OS::get_singleton()->get_ticks_usec() - begin_usec;
+		CHECK(restored);
+
+		print_verbose(vformat("Space state with %d bodies: %d bytes, %d usec per save, %d usec per restore.", scene.bodies.size(), state.size(), save_usec / iterations, restore_usec / iterations));
+
+		scene.free();
+	}
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H